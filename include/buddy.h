@@ -0,0 +1,102 @@
+/*******************************************************************************
+*
+* FILENAME : buddy.h
+*
+* DESCRIPTION : Buddy allocator hands out blocks whose sizes are powers of two,
+* from the smallest block of two words up to the largest power of two that fits
+* in the pool. A block of size S always starts at an address that is a multiple
+* of S, so blocks of a cache line or a page are aligned to a cache line or a
+* page. A free block is split in halves, its buddies, until it fits a request,
+* and a freed block is merged back with its buddy for as long as the buddy is
+* free too. The state of the blocks is kept in bitmaps at the beginning of the
+* pool, the blocks themselves carry no headers.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_BUDDY_H__
+#define __NSRD_BUDDY_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct buddy buddy_t;
+
+
+/*
+DESCRIPTION
+    Initializes a buddy allocator. User must provide pointer to the pool of
+    the memory aligned to the word size and specify its size. The bitmaps of
+    the allocator take at most a sixteenth of the pool, the rest is split into
+    the largest naturally aligned blocks it holds. The pool must be larger
+    than the bookkeeping of the allocator, which is about a kilobyte.
+RETURN
+    Returns pointer to the initialized buddy allocator.
+INPUT
+    pool_size: size of the provided pool.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY
+    O(n)
+*/
+buddy_t *BuddyInit(size_t pool_size, void *memory_pool);
+
+/*
+DESCRIPTION
+    Allocates a block of the smallest power of two that holds the specified
+    amount of bytes. The block is aligned to its size.
+RETURN
+    Returns the pointer to the beggining of the allocated block of memory.
+    NULL pointer in case of failure.
+INPUT
+    buddy: pointer to the buddy allocator.
+    bytes: size of the block to be allocated.
+TIME COMPLEXITY
+    O(log n)
+*/
+void *BuddyAlloc(buddy_t *buddy, size_t bytes);
+
+/*
+DESCRIPTION:
+    Deallocates the block of memory block_to_free and merges it with its free
+    buddies. Provided block of memory should previously be allocated by the
+    buddy allocator otherwise, the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    buddy: pointer to the buddy allocator.
+    block_to_free: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(log n)
+*/
+void BuddyFree(buddy_t *buddy, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Finds the size of an allocated block, that is the power of two its
+    request was rounded up to.
+RETURN:
+    Returns the size of the block.
+INPUT:
+    buddy: pointer to the buddy allocator.
+    block: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(log n)
+*/
+size_t BuddyBlockSize(const buddy_t *buddy, const void *block);
+
+/*
+DESCRIPTION:
+    Determines the maximum size of a block that can be allocated taking into
+    account the current state of the buddy allocator.
+RETURN:
+    Returns the computed number.
+INPUT:
+    buddy: pointer to the buddy allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t BuddyLargestChunkAvailable(const buddy_t *buddy);
+
+#endif /* __NSRD_BUDDY_H__ */
@@ -0,0 +1,161 @@
+/*******************************************************************************
+*
+* FILENAME : cache.h
+*
+* DESCRIPTION : Bounded cache on top of the hash table. The cache holds at most
+* a fixed amount of elements and, optionally, a fixed amount of bytes reported
+* by the user for every element. Once a new element does not fit, the least
+* recently used elements (or, with the CLOCK policy, elements that were not
+* used since the clock hand last passed them) are evicted and handed to an
+* eviction callback. Every entry of the cache is allocated at creation time
+* and kept in a flat hash table, so putting an element never allocates.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_CACHE_H__
+#define __NSRD_CACHE_H__
+
+#include <stddef.h> /* size_t */
+
+#include "hash_table.h" /* h_table_hash_t, h_table_is_match_t */
+
+typedef struct cache cache_t;
+
+typedef enum cache_policy
+{
+    CACHE_LRU,
+    CACHE_CLOCK
+} cache_policy_t;
+
+
+/*
+DESCRIPTION:
+    Pointer to the function that receives every element the cache lets go of
+    on its own, so the user can release it.
+RETURN:
+    There is no return for this function.
+INPUT:
+    data: pointer to the evicted element.
+    param: pointer to the parameter given at creation.
+*/
+typedef void (*cache_evict_t)(void *data, void *param);
+
+
+/*
+DESCRIPTION:
+    Creates a cache. With the LRU policy every hit relinks the element in a
+    recency list, with the CLOCK policy a hit only sets a reference bit, which
+    makes hits cheaper at the price of a coarser choice of victims.
+    Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created cache on success.
+    Returns NULL on failure.
+INPUT:
+    max_entries: the maximum amount of elements in the cache.
+    max_bytes: the maximum sum of the sizes of the elements in the cache,
+    0 to bound only the amount of elements.
+    policy: CACHE_LRU or CACHE_CLOCK.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+    on_evict: function that receives the evicted elements, may be NULL.
+    param: parameter for on_evict.
+TIME COMPLEXITY:
+    O(max_entries)
+*/
+cache_t *CacheCreate(size_t max_entries, size_t max_bytes,
+                    cache_policy_t policy, h_table_hash_t hash_func,
+                    h_table_is_match_t is_match, cache_evict_t on_evict,
+                                                                void *param);
+
+/*
+DESCRIPTION:
+    Destroys the cache, passing every element still in it to on_evict.
+RETURN:
+    There is no return for this function.
+INPUT:
+    cache: pointer to the cache to be destroyed.
+TIME COMPLEXITY:
+    O(max_entries)
+*/
+void CacheDestroy(cache_t *cache);
+
+/*
+DESCRIPTION:
+    Finds the element with the specified key and marks it as used.
+RETURN:
+    Pointer to the found data element if success.
+    Returns NULL if the key is not cached.
+INPUT:
+    cache: pointer to the cache.
+    key: pointer to the key of the element to find.
+TIME COMPLEXITY:
+    O(1) - average
+*/
+void *CacheGet(cache_t *cache, const void *key);
+
+/*
+DESCRIPTION:
+    Puts an element into the cache as the most recently used one, evicting
+    other elements until it fits. If the key is already cached, its element
+    is replaced, and the old element is passed to on_evict unless it is the
+    same pointer.
+RETURN:
+    Returns 0 on success.
+    Returns a non-zero value if the element is larger than max_bytes, in that
+    case the cache is left unchanged.
+INPUT:
+    cache: pointer to the cache.
+    data: pointer to the data element to put.
+    bytes: the size accounted for the element against max_bytes.
+TIME COMPLEXITY:
+    O(1) - average
+*/
+int CachePut(cache_t *cache, void *data, size_t bytes);
+
+/*
+DESCRIPTION:
+    Removes the element with the specified key from the cache without
+    passing it to on_evict.
+RETURN:
+    Pointer to the removed data element.
+    Returns NULL if the key is not cached.
+INPUT:
+    cache: pointer to the cache.
+    key: pointer to the key of the element to remove.
+TIME COMPLEXITY:
+    O(1) - average
+*/
+void *CacheRemove(cache_t *cache, const void *key);
+
+/*
+DESCRIPTION
+    Returns the number of elements in the cache.
+RETURN
+    The number of elements in the cache.
+INPUT
+    cache: pointer to the cache.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t CacheSize(const cache_t *cache);
+
+/*
+DESCRIPTION
+    Returns the sum of the sizes of the elements in the cache.
+RETURN
+    The amount of bytes accounted for the cached elements.
+INPUT
+    cache: pointer to the cache.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t CacheBytes(const cache_t *cache);
+
+#endif /* __NSRD_CACHE_H__ */
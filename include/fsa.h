@@ -19,6 +19,16 @@
 
 typedef struct fsa fsa_t;
 
+typedef struct fsa_stats
+{
+    size_t live_blocks;
+    size_t free_blocks;
+    size_t bytes_in_use;
+    size_t high_water_mark;
+    size_t num_allocs;
+    size_t num_frees;
+} fsa_stats_t;
+
 /*
 DESCRIPTION:
     Initializes a fixed-size allocator.
@@ -30,6 +40,8 @@ DESCRIPTION:
 	going to be aligned during initialization if is not.
 	It is advised to use FSASuggestSize function to compute needed
 	amount of bytes to allocate for a memory pool.
+	Only the header of the pool is written, the blocks are touched for the
+	first time when they are allocated.
 RETURN:
     Returns pointer to the initialized fixed-size allocator.
 INPUT:
@@ -37,7 +49,7 @@ INPUT:
     number_of_blocks: number of blocks to be initialized.
     memory_pool: pointer to a memory pool.
 TIME COMPLEXITY:
-    O(n)
+    O(1)
 */
 fsa_t *FSAInit(size_t size_of_block, size_t number_of_blocks, void *memory_pool);
 
@@ -100,8 +112,28 @@ RETURN:
 INPUT:
 	fsa: pointer to the fixed-size allocator.
 TIME COMPLEXITY:
-    O(n)
+    O(1)
 */
 size_t FSACountFree(const fsa_t *fsa);
 
+
+/*
+DESCRIPTION:
+    Fills stats with the state of the fixed-size allocator. The counters are
+	kept up to date by the allocations and frees, so nothing is walked:
+	live_blocks and bytes_in_use are the allocated blocks and their bytes,
+	free_blocks are the free ones, high_water_mark is the largest
+	bytes_in_use has ever been, num_allocs and num_frees count the calls that
+	succeeded. All the blocks are of the same size, so the pool is never
+	fragmented.
+RETURN:
+    There is no return for this function.
+INPUT:
+	fsa: pointer to the fixed-size allocator.
+	stats: pointer to the structure to fill.
+TIME COMPLEXITY:
+    O(1)
+*/
+void FSAGetStats(const fsa_t *fsa, fsa_stats_t *stats);
+
 #endif /* __NSRD_FSA_H__ */
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_magazine.h
+*
+* DESCRIPTION : Thread-safe fixed-size allocator with per-thread magazines. A
+* magazine is a small stack of free blocks; every thread holds two of them and
+* allocates from and frees to those without locking or touching memory shared
+* with other threads. When both of its magazines are empty, a thread trades an
+* empty one for a full one at the shared depot, and when both are full, a full
+* one for an empty one, so the depot lock is taken once per a magazine worth
+* of blocks. When the depot has no full magazine, one is filled from the FSA
+* that holds the blocks. Blocks held in the magazines of other threads are
+* not available to a thread until their owner frees past its magazines,
+* flushes them or exits, so up to two magazines per thread may sit idle.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_FSA_MAGAZINE_H__
+#define __NSRD_FSA_MAGAZINE_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct fsa_magazine fsa_magazine_t;
+
+
+/*
+DESCRIPTION:
+    Creates a thread-safe fixed-size allocator on top of the provided pool of
+    memory, that is initialized as an FSA, see FSAInit and FSASuggestSize.
+    Creation may fail if memory allocation or mutex initialization fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created allocator on success.
+    Returns NULL on failure.
+INPUT:
+    size_of_block: size of the blocks.
+    number_of_blocks: amount of the blocks.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY:
+    O(1)
+*/
+fsa_magazine_t *FSAMagazineCreate(size_t size_of_block,
+                                size_t number_of_blocks, void *memory_pool);
+
+/*
+DESCRIPTION:
+    Destroys the specified allocator together with the magazines of all the
+    threads and of the depot. No other thread may use the allocator during
+    or after the call. The pool itself is not freed.
+RETURN:
+    There is no return for this function.
+INPUT:
+    fsa_magazine: pointer to the allocator to be destroyed.
+TIME COMPLEXITY:
+    O(n) where n is the amount of magazines
+*/
+void FSAMagazineDestroy(fsa_magazine_t *fsa_magazine);
+
+/*
+DESCRIPTION:
+    Allocates one block. May be called concurrently with any other function
+    except FSAMagazineDestroy.
+    The magazines of the calling thread are tried first, then the full
+    magazines of the depot, then the FSA. The magazines of other threads are
+    never taken from, since their owners use them without the lock.
+RETURN:
+    Returns the pointer to the allocated block of memory.
+    NULL pointer if there is no free block in the magazines of the calling
+    thread, in the depot nor in the FSA, even if other threads still hold
+    free blocks in their magazines.
+INPUT:
+    fsa_magazine: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1) - amortized
+*/
+void *FSAMagazineAlloc(fsa_magazine_t *fsa_magazine);
+
+/*
+DESCRIPTION:
+    Frees a block into the magazines of the calling thread. The block may
+    have been allocated by any thread. Provided block of memory should
+    previously be allocated by the same allocator otherwise, the behavior is
+    undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    fsa_magazine: pointer to the allocator.
+    block_to_free: pointer to the block of memory.
+TIME COMPLEXITY:
+    O(1) - amortized
+*/
+void FSAMagazineFree(fsa_magazine_t *fsa_magazine, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Returns the blocks held by the magazines of the calling thread to the
+    FSA. The magazines of a thread are flushed by themselves when the thread
+    exits.
+RETURN:
+    There is no return for this function.
+INPUT:
+    fsa_magazine: pointer to the allocator.
+TIME COMPLEXITY:
+    O(k) where k is the size of a magazine
+*/
+void FSAMagazineFlushCache(fsa_magazine_t *fsa_magazine);
+
+/*
+DESCRIPTION:
+    Counts the free blocks of the FSA and of the full magazines of the depot.
+    Blocks held by the magazines of the threads are not taken into account.
+RETURN:
+    Returns the computed number.
+INPUT:
+    fsa_magazine: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t FSAMagazineCountFree(fsa_magazine_t *fsa_magazine);
+
+#endif /* __NSRD_FSA_MAGAZINE_H__ */
@@ -0,0 +1,127 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_slab.h
+*
+* DESCRIPTION : Growable fixed-size allocator. Blocks are allocated from a
+* chain of slabs, every slab being an FSA in memory mapped from the system.
+* The slabs are kept on three lists: full, partial and empty. A block is taken
+* from a partial slab first, so the blocks in use stay packed in few slabs,
+* then from an empty one, and only then a new slab is mapped. A slab whose
+* last block is freed is kept empty with its pages given back to the system,
+* until more slabs than the given threshold are empty, then it is unmapped.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_FSA_SLAB_H__
+#define __NSRD_FSA_SLAB_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct fsa_slab fsa_slab_t;
+
+
+/*
+DESCRIPTION:
+    Creates a growable fixed-size allocator. No memory is mapped until the
+    first allocation.
+    Creation fails if memory allocation fails or a slab has no room for a
+    single block.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created allocator on success.
+    Returns NULL on failure.
+INPUT:
+    size_of_block: size of the blocks.
+    slab_size: size of a slab, it is rounded up to a power of two and to at
+    least a page.
+    max_empty_slabs: amount of empty slabs kept mapped.
+TIME COMPLEXITY:
+    O(1)
+*/
+fsa_slab_t *FSASlabCreate(size_t size_of_block, size_t slab_size,
+                                                    size_t max_empty_slabs);
+
+/*
+DESCRIPTION:
+    Destroys the specified allocator and unmaps all of its slabs, the
+    blocks that were not freed included.
+RETURN:
+    There is no return for this function.
+INPUT:
+    fsa_slab: pointer to the allocator to be destroyed.
+TIME COMPLEXITY:
+    O(n) where n is the amount of slabs
+*/
+void FSASlabDestroy(fsa_slab_t *fsa_slab);
+
+/*
+DESCRIPTION:
+    Allocates one block from a partial slab, or from an empty one, mapping
+    a new slab if there is neither.
+RETURN:
+    Returns the pointer to the allocated block of memory.
+    NULL pointer if a new slab is needed and mapping it fails.
+INPUT:
+    fsa_slab: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+void *FSASlabAlloc(fsa_slab_t *fsa_slab);
+
+/*
+DESCRIPTION:
+    Frees a block. If it was the last block of its slab, the slab becomes
+    empty and is unmapped when more than max_empty_slabs slabs are empty.
+    Provided block of memory should previously be allocated by the same
+    allocator otherwise, the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    fsa_slab: pointer to the allocator.
+    block_to_free: pointer to the block of memory.
+TIME COMPLEXITY:
+    O(1)
+*/
+void FSASlabFree(fsa_slab_t *fsa_slab, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Computes the amount of blocks a single slab holds.
+RETURN:
+    Returns the computed number.
+INPUT:
+    fsa_slab: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t FSASlabBlocksPerSlab(const fsa_slab_t *fsa_slab);
+
+/*
+DESCRIPTION:
+    Counts the slabs that are currently mapped, the empty ones included.
+RETURN:
+    Returns the amount of slabs.
+INPUT:
+    fsa_slab: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t FSASlabCount(const fsa_slab_t *fsa_slab);
+
+/*
+DESCRIPTION:
+    Counts the empty slabs that are kept mapped.
+RETURN:
+    Returns the amount of empty slabs.
+INPUT:
+    fsa_slab: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t FSASlabCountEmpty(const fsa_slab_t *fsa_slab);
+
+#endif /* __NSRD_FSA_SLAB_H__ */
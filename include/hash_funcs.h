@@ -0,0 +1,106 @@
+/*******************************************************************************
+*
+* FILENAME : hash_funcs.h
+*
+* DESCRIPTION : Fast general purpose hash functions for the users of the hash
+* tables. Integers are hashed with a multiply-xorshift mixer in which every
+* input bit affects every output bit, bytes and strings are consumed a whole
+* machine word at a time and finished with the same mixer. Every function
+* has a seeded variant, so a table can pick a secret seed to defend against
+* keys crafted to collide. The hashes are not cryptographic, and their values
+* depend on the word size and the byte order of the platform.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_HASH_FUNCS_H__
+#define __NSRD_HASH_FUNCS_H__
+
+#include <stddef.h> /* size_t */
+
+
+/*
+DESCRIPTION:
+    Mixes the bits of a machine word. The mixing is a bijection, so distinct
+    words never collide, and its low bits are fit to be masked into a power
+    of two amount of buckets.
+RETURN:
+    The hash of the word.
+INPUT:
+    word: the value to hash.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t HashWord(size_t word);
+
+/*
+DESCRIPTION:
+    Mixes the bits of a machine word, the result depends on the seed as well.
+RETURN:
+    The hash of the word.
+INPUT:
+    word: the value to hash.
+    seed: any value, equal seeds give equal hashes.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t HashWordSeeded(size_t word, size_t seed);
+
+/*
+DESCRIPTION:
+    Hashes a buffer of bytes, reading it a word at a time. The buffer does not
+    need to be aligned.
+RETURN:
+    The hash of the bytes.
+INPUT:
+    data: pointer to the bytes to hash, may be NULL if len is 0.
+    len: the amount of bytes.
+TIME COMPLEXITY:
+    O(len)
+*/
+size_t HashBytes(const void *data, size_t len);
+
+/*
+DESCRIPTION:
+    Hashes a buffer of bytes, the result depends on the seed as well.
+RETURN:
+    The hash of the bytes.
+INPUT:
+    data: pointer to the bytes to hash, may be NULL if len is 0.
+    len: the amount of bytes.
+    seed: any value, equal seeds give equal hashes.
+TIME COMPLEXITY:
+    O(len)
+*/
+size_t HashBytesSeeded(const void *data, size_t len, size_t seed);
+
+/*
+DESCRIPTION:
+    Hashes a null terminated string. Matches h_table_hash_t, so it can be
+    passed as is to a hash table whose elements are strings.
+RETURN:
+    The hash of the string, equal to HashBytes over its characters.
+INPUT:
+    str: pointer to the string.
+TIME COMPLEXITY:
+    O(length of the string)
+*/
+size_t HashString(const void *str);
+
+/*
+DESCRIPTION:
+    Hashes a null terminated string, the result depends on the seed as well.
+RETURN:
+    The hash of the string, equal to HashBytesSeeded over its characters.
+INPUT:
+    str: pointer to the string.
+    seed: any value, equal seeds give equal hashes.
+TIME COMPLEXITY:
+    O(length of the string)
+*/
+size_t HashStringSeeded(const void *str, size_t seed);
+
+#endif /* __NSRD_HASH_FUNCS_H__ */
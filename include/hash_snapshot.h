@@ -0,0 +1,137 @@
+/*******************************************************************************
+*
+* FILENAME : hash_snapshot.h
+*
+* DESCRIPTION : Hash snapshot is a read-only copy of a hash table saved to a
+* file in a layout that is queried in place. Every element is stored as the
+* bytes of its key and of its value, produced by user callbacks, next to an
+* open-addressing index of the keys. All the references inside the file are
+* offsets, so the file is mapped into memory as is and lookups start right
+* away, with no pass to rebuild the table. The pages of the file are read by
+* the system only once they are touched, and are shared between processes
+* that map the same file.
+* Keys are hashed with HashBytes of hash_funcs.h, so the hash function of the
+* table does not matter, and two keys are equal when their bytes are equal.
+* A file can only be opened on a machine with the same word size and byte
+* order as the one it was saved on.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_HASH_SNAPSHOT_H__
+#define __NSRD_HASH_SNAPSHOT_H__
+
+#include <stddef.h> /* size_t */
+
+#include "hash_table.h" /* h_table_t */
+
+typedef struct hash_snapshot hash_snapshot_t;
+
+
+/*
+DESCRIPTION:
+    Pointer to the function that encodes the key or the value of a data
+    element of the table into bytes. The encoding is defined by the user, it
+    must not depend on addresses, and equal keys must encode to equal bytes.
+RETURN:
+    The amount of bytes of the encoding. If it is larger than size, the
+    function is called again with a large enough buffer.
+INPUT:
+    data: pointer to the data element.
+    buffer: pointer to the buffer to write the encoding into.
+    size: the size of the buffer.
+    param: pointer to the parameter given to HashSnapshotSave.
+*/
+typedef size_t (*hash_snapshot_encode_t)(const void *data, void *buffer,
+                                                    size_t size, void *param);
+
+
+/*
+DESCRIPTION:
+    Saves every element of the hash table to a snapshot file. The file is
+    written next to path first, synced to the disk and renamed over it once
+    complete, then the directory is synced, so neither other processes nor a
+    crash ever see a snapshot half written.
+RETURN:
+    Returns 0 on success.
+    Returns a non-zero value if memory allocation or writing the file fails,
+    in that case a previous file at path is left as it was. If only syncing
+    the directory fails, path already holds the new snapshot, but it may
+    not survive a crash.
+INPUT:
+    table: pointer to the hash table.
+    path: the path of the file.
+    encode_key: function that encodes the key of an element.
+    encode_value: function that encodes the value of an element.
+    param: parameter for the encoding functions.
+TIME COMPLEXITY:
+    O(n)
+*/
+int HashSnapshotSave(h_table_t *table, const char *path,
+                                        hash_snapshot_encode_t encode_key,
+                            hash_snapshot_encode_t encode_value, void *param);
+
+/*
+DESCRIPTION:
+    Opens a snapshot file by mapping it into memory read-only. The file is
+    checked to be a snapshot that fits the machine, but is not read as a
+    whole.
+    User is responsible for closing the snapshot.
+RETURN:
+    Returns pointer to the opened snapshot on success.
+    Returns NULL if the file can not be mapped or is not a valid snapshot.
+INPUT:
+    path: the path of the file.
+TIME COMPLEXITY:
+    O(1)
+*/
+hash_snapshot_t *HashSnapshotOpen(const char *path);
+
+/*
+DESCRIPTION:
+    Closes the snapshot, unmapping the file. Values returned by
+    HashSnapshotFind can not be used anymore.
+RETURN:
+    There is no return for this function.
+INPUT:
+    snapshot: pointer to the snapshot to be closed.
+TIME COMPLEXITY:
+    O(1)
+*/
+void HashSnapshotClose(hash_snapshot_t *snapshot);
+
+/*
+DESCRIPTION:
+    Finds the value of the element with the specified key. The value is
+    aligned to the word size inside the mapped file.
+RETURN:
+    Pointer to the bytes of the value if the key is found.
+    Returns NULL if the key is not found.
+INPUT:
+    snapshot: pointer to the snapshot.
+    key: pointer to the bytes of the key, as encoded by encode_key.
+    key_size: the amount of bytes of the key.
+    value_size: pointer to receive the amount of bytes of the value, may be
+    NULL.
+TIME COMPLEXITY:
+    O(1) - average
+*/
+const void *HashSnapshotFind(const hash_snapshot_t *snapshot, const void *key,
+                                        size_t key_size, size_t *value_size);
+
+/*
+DESCRIPTION
+    Returns the number of elements in the snapshot.
+RETURN
+    The number of elements in the snapshot.
+INPUT
+    snapshot: pointer to the snapshot.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t HashSnapshotSize(const hash_snapshot_t *snapshot);
+
+#endif /* __NSRD_HASH_SNAPSHOT_H__ */
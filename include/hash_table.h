@@ -21,8 +21,22 @@
 
 #include <stddef.h> /* size_t */
 
+#include "bloom_filter.h" /* bloom_filter_t */
+#include "hash_funcs.h" /* HashWord, HashString */
+
 typedef struct h_table h_table_t;
 
+/* flags of HashTableCreateFrom, one table kind optionally or-ed with UNIQUE */
+enum h_table_from_flags
+{
+    HT_FROM_CHAINED = 0,
+    HT_FROM_FLAT = 1,
+    HT_FROM_SWISS = 2,
+    HT_FROM_CUCKOO = 3,
+    HT_FROM_KIND_MASK = 3,
+    HT_FROM_UNIQUE = 4
+};
+
 
 /*
 DESCRIPTION
@@ -67,13 +81,24 @@ typedef size_t (*h_table_hash_t)(const void *data);
 DESCRIPTION:
     Creates a hash table with the specified table size, 
     hash function, and key matching function.
+    The table grows once the amount of elements reaches the maximum load
+    factor (1.0 by default, see HashTableSetLoadFactor). Elements are moved
+    to the new buckets a few buckets at a time by the subsequent find, insert
+    and remove calls, so no single call pays for the whole migration.
+    Every element keeps its hash next to it, so is_match is only called for
+    elements with an equal hash and hash_func is never called while resizing.
+    The hash returned by hash_func is mixed once more with HashWord of
+    hash_funcs.h, so a weak hash function still spreads the elements evenly,
+    and the buckets are picked by masking instead of a division. The same
+    applies to every other kind of table below.
     Creation may fail if memory allocation fails. 
     User is responsible for memory deallocation.
 RETURN:
     Returns pointer to the created hash table on success.
     Returns NULL on failure.
 INPUT:
-    table_size: the size of the hash table.`
+    table_size: the initial size of the hash table, it is rounded up to a
+    power of two and the table never shrinks below it.
     hash_func: function that calculates the hash value for a given data
     element.
     is_match: function that checks if two data elements are considered a match 
@@ -83,6 +108,148 @@ TIME COMPLEXITY:
 */
 h_table_t *HashTableCreate(size_t table_size, h_table_hash_t hash_func, h_table_is_match_t is_match);
 
+/*
+DESCRIPTION:
+    Creates an open-addressing hash table that keeps its elements in one
+    contiguous array of slots instead of chained buckets. Collisions are
+    resolved with Robin Hood linear probing and removal uses backward-shift
+    deletion, so no tombstones are left behind and no memory is allocated per
+    element. The table is used through the same HashTable* functions as the
+    chained one.
+    The slot array is sized so that capacity elements fit below the maximum
+    load factor, which is 7/8 by default and can not be set higher. Like the
+    chained table, it grows incrementally once that load is reached.
+    Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created hash table on success.
+    Returns NULL on failure.
+INPUT:
+    capacity: expected amount of elements in the hash table.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+TIME COMPLEXITY:
+    O(n)
+*/
+h_table_t *HashTableCreateFlat(size_t capacity, h_table_hash_t hash_func, h_table_is_match_t is_match);
+
+/*
+DESCRIPTION:
+    Creates an open-addressing hash table in the layout of a Swiss table. Next
+    to the slot array it keeps one control byte per slot holding 7 bits of
+    the element's hash, and probes the control bytes 16 slots at a time with
+    SSE2 compare and movemask instructions (or a scalar loop when SSE2 is not
+    available). A lookup compares the full hash and calls is_match only for
+    the slots whose control byte matched, and a miss is usually rejected after
+    reading a single 16 byte group of control bytes.
+    Removal leaves a tombstone unless the group still has an empty slot, the
+    table is rebuilt once elements and tombstones reach the maximum load
+    factor of 7/8, which can not be set higher.
+    The table is used through the same HashTable* functions as the chained
+    one. Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created hash table on success.
+    Returns NULL on failure.
+INPUT:
+    capacity: expected amount of elements in the hash table.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+TIME COMPLEXITY:
+    O(n)
+*/
+h_table_t *HashTableCreateSwiss(size_t capacity, h_table_hash_t hash_func, h_table_is_match_t is_match);
+
+/*
+DESCRIPTION:
+    Creates a cuckoo hash table. Slots are grouped into buckets of four, and
+    every element may live in only one of two buckets, both derived from its
+    hash by two different mixing functions, or in a small stash of 8 slots.
+    A lookup therefore reads at most the two buckets and the stash, whatever
+    the keys and the load are (twice that while a resize is in progress).
+    An insertion that finds both buckets full evicts an element to its other
+    bucket, repeating for a bounded amount of evictions before it falls back
+    to the stash, and grows the table if the stash is full as well. So inserts
+    may be noticeably slower than with the other modes while lookups stay
+    bounded. More than 16 elements with an equal hash can not be stored.
+    The maximum load factor is 7/8 by default and can be set up to 0.95.
+    The table is used through the same HashTable* functions as the chained
+    one. Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created hash table on success.
+    Returns NULL on failure.
+INPUT:
+    capacity: expected amount of elements in the hash table.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+TIME COMPLEXITY:
+    O(n)
+*/
+h_table_t *HashTableCreateCuckoo(size_t capacity, h_table_hash_t hash_func, h_table_is_match_t is_match);
+
+/*
+DESCRIPTION:
+    Creates a hash table of the kind selected by flags and fills it with n
+    elements at once. The table is sized for all of them up front, so it never
+    resizes while it is filled. The elements are hashed by several threads
+    when there are many of them, then sorted by their home bucket, so the
+    table is filled one run of neighbouring buckets after another instead of
+    at random.
+    With HT_FROM_UNIQUE the caller guarantees that no two elements have equal
+    keys, and the elements are placed without looking for a match first.
+    Otherwise the result is the same as inserting the elements in order, a
+    later element replaces an earlier one with an equal key.
+    hash_func may be called from several threads at the same time.
+    Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created hash table on success.
+    Returns NULL on failure.
+INPUT:
+    items: array of n pointers to the data elements.
+    n: the amount of elements, may be 0.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+    flags: HT_FROM_CHAINED, HT_FROM_FLAT, HT_FROM_SWISS or HT_FROM_CUCKOO for
+    the kind of the table, as created by the functions above, or-ed with
+    HT_FROM_UNIQUE if the keys are known to be distinct.
+TIME COMPLEXITY:
+    O(n)
+*/
+h_table_t *HashTableCreateFrom(void **items, size_t n, h_table_hash_t hash_func, h_table_is_match_t is_match, int flags);
+
+/*
+DESCRIPTION:
+    Sets the load factors that drive the resizing of the hash table. The table
+    doubles its amount of buckets when the amount of elements reaches
+    max_load * buckets and halves it when the amount drops below
+    min_load * buckets, never going below the size it was created with.
+    min_load of 0 disables shrinking, which is the default.
+    max_load should be at least twice min_load to avoid resizing back and
+    forth, and can not exceed 7/8 for the flat and Swiss tables nor 0.95 for
+    the cuckoo table.
+RETURN:
+    Returns 0 on success.
+    Returns a non-zero value if the load factors are invalid, in that case
+    the table is left unchanged.
+INPUT:
+    table: pointer to the hash table.
+    max_load: the load factor to grow at.
+    min_load: the load factor to shrink at.
+TIME COMPLEXITY:
+    O(1)
+*/
+int HashTableSetLoadFactor(h_table_t *table, double max_load, double min_load);
+
 /*
 DESCRIPTION:
     Destroys the specified hash table, freeing the memory allocated for it and
@@ -110,6 +277,25 @@ TIME COMPLEXITY:
 */
 void *HashTableFind(h_table_t *table, void *key);
 
+/*
+DESCRIPTION:
+    Finds n elements in the hash table at once, as if HashTableFind was called
+    for every key in order. All the keys of a batch are hashed first and
+    their buckets are prefetched before any of them is resolved, so the memory
+    latency of independent lookups overlaps.
+RETURN:
+    The amount of keys that were found.
+    out[i] holds the element found for keys[i], or NULL if it is not found.
+INPUT:
+    table: pointer to the hash table.
+    keys: array of n pointers to the keys of the elements to find.
+    n: the amount of keys.
+    out: array of n pointers to receive the found elements.
+TIME COMPLEXITY:
+    O(n) - best, O(n * size) - worst
+*/
+size_t HashTableFindBatch(h_table_t *table, void **keys, size_t n, void **out);
+
 /*
 DESCRIPTION:
     Inserts a new data element into the hash table.
@@ -146,7 +332,7 @@ RETURN
 INPUT
     table: pointer to the hash table.
 TIME COMPLEXITY:
-    O(n)
+    O(1)
 */
 size_t HashTableSize(const h_table_t *table);
 
@@ -159,7 +345,7 @@ RETURN
 INPUT
     table: pointer to the hash table.
 TIME COMPLEXITY:
-    O(n)
+    O(1)
 */
 int HashTableIsEmpty(const h_table_t *table);
 
@@ -181,4 +367,87 @@ TIME COMPLEXITY:
 */
 int HashTableForEach(h_table_t *table, h_table_action_t action, void *param);
 
+/*
+DESCRIPTION
+	Traverses the hash table a few buckets at a time, performing the action
+	function on each element of the visited buckets. A scan starts with
+	cursor 0 and continues with the cursor returned by the previous call
+	until 0 is returned again.
+	The table may be changed freely between the calls, and may even grow or
+	shrink: every element that is in the table for the whole scan is still
+	visited at least once. Elements inserted or removed during the scan may
+	or may not be visited, and elements may be visited more than once while
+	the table is resizing. With a cuckoo table, elements relocated by
+	insertions made during the scan may be missed as well.
+	The action must not insert or remove elements of the table. If an action
+	fails, the call returns once the current bucket is done, and the returned
+	cursor still continues the scan from the next bucket.
+RETURN
+	The cursor to continue the scan with, or 0 if the scan is complete.
+INPUT
+	table: pointer to the hash table;
+	cursor: 0 to start a scan, or the cursor returned by the previous call;
+	batch: the amount of buckets to visit, at least 1 (twice as many are
+	visited while the table is resizing);
+	action: pointer to the action function;
+	param: generic pointer to the parameters for the action function.
+TIME COMPLEXITY:
+    O(batch) - best, O(n) - worst
+*/
+size_t HashTableScan(h_table_t *table, size_t cursor, size_t batch, h_table_action_t action, void *param);
+
+/*
+DESCRIPTION:
+    Attaches a blocked bloom filter (see bloom_filter.h) to the hash table and
+    fills it with the elements already in it, replacing a previously attached
+    filter. While a filter is attached, HashTableFind and HashTableFindBatch
+    consult it first and return NULL for most of the missing keys without
+    touching the buckets or calling is_match, and HashTableInsert adds every
+    inserted element to it.
+    Removed elements stay in the filter and keep costing a full lookup, so a
+    table with many removals should call HashTableRebuildFilter from time to
+    time. Filling the filter calls hash_func once for every element.
+RETURN:
+    Returns 0 on success.
+    Returns a non-zero value if memory allocation fails, in that case the
+    previous filter, if any, stays attached.
+INPUT:
+    table: pointer to the hash table.
+    capacity: expected amount of elements, never less than the current size.
+    bits_per_element: the amount of bits to spend on every element, 10 keeps
+    the false positive rate about 1%.
+TIME COMPLEXITY:
+    O(n + capacity)
+*/
+int HashTableAttachFilter(h_table_t *table, size_t capacity, size_t bits_per_element);
+
+/*
+DESCRIPTION:
+    Builds the attached filter again from the elements currently in the hash
+    table, forgetting the removed ones. If the table has grown beyond the
+    capacity of the filter, the new filter is sized for the current amount of
+    elements.
+RETURN:
+    Returns 0 on success.
+    Returns a non-zero value if memory allocation fails, in that case the
+    previous filter stays attached.
+INPUT:
+    table: pointer to the hash table with an attached filter.
+TIME COMPLEXITY:
+    O(n + capacity)
+*/
+int HashTableRebuildFilter(h_table_t *table);
+
+/*
+DESCRIPTION:
+    Detaches and destroys the filter of the hash table, if any.
+RETURN:
+    There is no return for this function.
+INPUT:
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(1)
+*/
+void HashTableDetachFilter(h_table_t *table);
+
 #endif /* __NSRD_HASH_TABLE_H__ */
\ No newline at end of file
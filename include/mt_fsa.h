@@ -0,0 +1,110 @@
+/*******************************************************************************
+*
+* FILENAME : mt_fsa.h
+*
+* DESCRIPTION : Lock-free fixed-size allocator. Like the FSA, free blocks make
+* a list inside the pool, and every allocation pops a block off its head and
+* every free pushes one back. The head is changed by a single compare and swap,
+* so threads never wait for each other, and a block may be freed by a thread
+* other than the one that allocated it. The head keeps a version tag next to
+* the index of the first block, bumped with every change, so a thread that
+* read the head before other threads popped and pushed the same block back
+* fails its swap instead of breaking the list. The tag takes the high half of
+* a word, so with a 32-bit size_t it wraps after 65536 changes of the head,
+* and a thread stalled in between for exactly a multiple of that may still
+* break the list; the amount of blocks is limited to the low half likewise.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_MT_FSA_H__
+#define __NSRD_MT_FSA_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct mt_fsa mt_fsa_t;
+
+
+/*
+DESCRIPTION:
+    Initializes a lock-free fixed-size allocator. User must provide pointer to
+    a pool of the memory aligned to the word size, that is large enough to
+    accommodate the requested amount of blocks, see MTFSASuggestSize. The
+    allocator starts at the first cache line of the pool, so its head never
+    shares a line with the blocks, the returned pointer may differ from
+    memory_pool.
+    size_of_block is aligned to the word size. The amount of blocks is limited
+    by the half of the bits of a word, that are left for the index.
+RETURN:
+    Returns pointer to the initialized allocator.
+INPUT:
+    size_of_block: size of the blocks.
+    number_of_blocks: amount of the blocks, at least one.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY:
+    O(n)
+*/
+mt_fsa_t *MTFSAInit(size_t size_of_block, size_t number_of_blocks,
+                                                            void *memory_pool);
+
+/*
+DESCRIPTION:
+    Allocates one block. May be called concurrently with MTFSAAlloc and
+    MTFSAFree from any thread.
+RETURN:
+    Returns the pointer to the allocated block of memory.
+    NULL pointer if there is no free block.
+INPUT:
+    mt_fsa: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1) - without contention, lock-free
+*/
+void *MTFSAAlloc(mt_fsa_t *mt_fsa);
+
+/*
+DESCRIPTION:
+    Frees a block. The block may have been allocated by any thread. May be
+    called concurrently with MTFSAAlloc and MTFSAFree from any thread.
+    Provided block of memory should previously be allocated by the same
+    allocator otherwise, the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    mt_fsa: pointer to the allocator.
+    block_to_free: pointer to the block of memory.
+TIME COMPLEXITY:
+    O(1) - without contention, lock-free
+*/
+void MTFSAFree(mt_fsa_t *mt_fsa, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Computes the amount of bytes of a memory pool for an allocator with the
+    specified blocks, including the room to align it to a cache line.
+RETURN:
+    Returns the computed number.
+INPUT:
+    number_of_blocks: needed amount of blocks.
+    size_of_block: size of each block.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t MTFSASuggestSize(size_t number_of_blocks, size_t size_of_block);
+
+/*
+DESCRIPTION:
+    Counts the free blocks by walking their list. No other thread may change
+    the allocator during the call.
+RETURN:
+    Returns the computed number.
+INPUT:
+    mt_fsa: pointer to the allocator.
+TIME COMPLEXITY:
+    O(n)
+*/
+size_t MTFSACountFree(const mt_fsa_t *mt_fsa);
+
+#endif /* __NSRD_MT_FSA_H__ */
@@ -0,0 +1,167 @@
+/*******************************************************************************
+*
+* FILENAME : mt_hash_table.h
+*
+* DESCRIPTION : Thread-safe hash table. Buckets are guarded by a fixed set of
+* striped read-write locks, so writers only contend when they hit the same
+* stripe. A lookup first scans the hashes of its chain without taking a lock:
+* every stripe carries a sequence counter that readers validate against,
+* retrying if a writer changed the stripe under them, so a missing key costs
+* no lock. Only when a hash matches is the stripe locked for reading and the
+* data compared, so user data is never touched by a reader after it could
+* have been removed, and readers of the same stripe do not wait for each
+* other. Chain nodes are recycled within their stripe instead of being freed,
+* so a reader never follows a pointer into freed memory.
+* The table uses the callback types of hash_table.h.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_MT_HASH_TABLE_H__
+#define __NSRD_MT_HASH_TABLE_H__
+
+#include <stddef.h> /* size_t */
+
+#include "hash_table.h"
+
+typedef struct mt_h_table mt_h_table_t;
+
+
+/*
+DESCRIPTION:
+    Creates a thread-safe hash table with the specified amount of buckets and
+    lock stripes. The amount of buckets is fixed for the lifetime of the table.
+    Like in HashTableCreate, the hash of hash_func is mixed once more and
+    masked into the buckets.
+    Creation may fail if memory allocation or lock initialization fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created hash table on success.
+    Returns NULL on failure.
+INPUT:
+    table_size: the amount of buckets in the hash table, it is rounded up to
+    a power of two.
+    num_stripes: the amount of locks the buckets are split between, it is
+    rounded up to a power of two and limited by table_size.
+    hash_func: function that calculates the hash value for a given data
+    element.
+    is_match: function that checks if two data elements are considered a match
+    based on their keys.
+TIME COMPLEXITY:
+    O(n)
+*/
+mt_h_table_t *MTHashTableCreate(size_t table_size, size_t num_stripes,
+                        h_table_hash_t hash_func, h_table_is_match_t is_match);
+
+/*
+DESCRIPTION:
+    Destroys the specified hash table. No other thread may use the table
+    during or after the call.
+RETURN:
+    There is no return for this function.
+INPUT:
+    table: pointer to the hash table to be destroyed.
+TIME COMPLEXITY:
+    O(n)
+*/
+void MTHashTableDestroy(mt_h_table_t *table);
+
+/*
+DESCRIPTION:
+    Finds the element in the hash table based on the specified key. The
+    stripe is locked for reading only if an element of the same hash is
+    found, so is_match is never called on removed data and removed data may
+    be freed right away. Such lookups run side by side with each other and
+    wait only for the writers of the stripe. May be called concurrently with
+    any other function except MTHashTableDestroy.
+RETURN:
+    Pointer to the found data element if success.
+    Returns NULL if the key is not found.
+INPUT:
+    table: pointer to the hash table.
+    key: pointer to the key of the element to find.
+TIME COMPLEXITY:
+    O(1) - best, O(n) - worst
+*/
+void *MTHashTableFind(const mt_h_table_t *table, const void *key);
+
+/*
+DESCRIPTION:
+    Inserts a new data element into the hash table.
+    If the key already exists in the hash table, overwrites old data.
+RETURN:
+    Returns 0 if the insertion is successful.
+    Returns a non-zero value if an error occurs.
+INPUT:
+    table: pointer to the hash table.
+    data: pointer to the data element to be inserted.
+TIME COMPLEXITY:
+    O(1) - best, O(n) - worst
+*/
+int MTHashTableInsert(mt_h_table_t *table, void *data);
+
+/*
+DESCRIPTION:
+    Removes the element with the specified key from the hash table.
+RETURN:
+    Pointer to the removed data element, so the caller that actually removed
+    it knows it is the one to release it.
+    Returns NULL if the key is not found.
+INPUT:
+    table: pointer to the hash table.
+    key: pointer to the key of the element to remove.
+TIME COMPLEXITY:
+    O(1) - best, O(n) - worst
+*/
+void *MTHashTableRemove(mt_h_table_t *table, const void *key);
+
+/*
+DESCRIPTION
+    Returns the number of elements in the hash table. With concurrent writers
+    the result is only a snapshot.
+RETURN
+    The number of elements in the hash table.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(number of stripes)
+*/
+size_t MTHashTableSize(const mt_h_table_t *table);
+
+/*
+DESCRIPTION
+    Checks whether the hash table is empty. With concurrent writers the
+    result is only a snapshot.
+RETURN
+    1: the hash table is empty.
+    0: the hash table is not empty.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(number of stripes)
+*/
+int MTHashTableIsEmpty(const mt_h_table_t *table);
+
+/*
+DESCRIPTION
+    Traverses the hash table and performs the action function on each element.
+    Each stripe is locked while its buckets are traversed, so the action must
+    not call the writing functions of the same table.
+    Actions may fail.
+RETURN
+    0: all actions are successful;
+    non-zero value: any action fails.
+INPUT
+    table: pointer to the hash table;
+    action: pointer to the action function;
+    param: generic pointer to the parameters for the action function.
+TIME COMPLEXITY:
+    O(n)
+*/
+int MTHashTableForEach(mt_h_table_t *table, h_table_action_t action,
+                                                                void *param);
+
+#endif /* __NSRD_MT_HASH_TABLE_H__ */
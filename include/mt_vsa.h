@@ -0,0 +1,121 @@
+/*******************************************************************************
+*
+* FILENAME : mt_vsa.h
+*
+* DESCRIPTION : Thread-safe variable-size allocator. The pool is managed by a
+* VSA guarded by a single lock, and every thread keeps a small cache of
+* free blocks per power-of-two size class in front of it. Allocations and
+* frees of small blocks are served from the cache of the calling thread
+* without locking; the shared VSA is only locked on a cache miss, to refill
+* a batch of blocks, or when a cache overflows, to return half of it at once.
+* Blocks larger than the largest size class always go to the shared VSA.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_MT_VSA_H__
+#define __NSRD_MT_VSA_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct mt_vsa mt_vsa_t;
+
+
+/*
+DESCRIPTION:
+    Creates a thread-safe variable-size allocator on top of the provided pool
+    of memory, that must be aligned to the word size. The pool is initialized
+    as a VSA, see VSAInit.
+    Creation may fail if the pool is smaller than VSASuggestSize(0), or if
+    memory allocation or mutex initialization fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created allocator on success.
+    Returns NULL on failure.
+INPUT:
+    pool_size: size of the provided pool.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY:
+    O(1)
+*/
+mt_vsa_t *MTVSACreate(size_t pool_size, void *memory_pool);
+
+/*
+DESCRIPTION:
+    Destroys the specified allocator together with the caches of all the
+    threads. No other thread may use the allocator during or after the call.
+    The pool itself is not freed.
+RETURN:
+    There is no return for this function.
+INPUT:
+    mt_vsa: pointer to the allocator to be destroyed.
+TIME COMPLEXITY:
+    O(n) where n is the amount of threads that used the allocator
+*/
+void MTVSADestroy(mt_vsa_t *mt_vsa);
+
+/*
+DESCRIPTION:
+    Allocates a block of memory of at least the specified amount of bytes.
+    Small requests are rounded up to a power of two and served from the cache
+    of the calling thread. A cache miss takes a batch of blocks of the class,
+    limited to a few KB, and if not even one block of the class fits, the
+    exact amount of bytes is allocated from the shared VSA. May be called
+    concurrently with any other function except MTVSADestroy.
+RETURN:
+    Returns the pointer to the beggining of the allocated block of memory.
+    NULL pointer in case of failure.
+INPUT:
+    mt_vsa: pointer to the allocator.
+    bytes: size of the block to be allocated.
+TIME COMPLEXITY:
+    O(1) on a cache hit, otherwise as VSAAlloc
+*/
+void *MTVSAAlloc(mt_vsa_t *mt_vsa, size_t bytes);
+
+/*
+DESCRIPTION:
+    Deallocates the block of memory block_to_free. The block may have been
+    allocated by any thread, it is kept in the cache of the calling thread.
+    Provided block of memory should previously be allocated by the same
+    allocator otherwise, the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    mt_vsa: pointer to the allocator.
+    block_to_free: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(1) on a cache hit, otherwise as VSAFree
+*/
+void MTVSAFree(mt_vsa_t *mt_vsa, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Returns all the blocks cached by the calling thread to the shared pool.
+    The cache of a thread is flushed by itself when the thread exits.
+RETURN:
+    There is no return for this function.
+INPUT:
+    mt_vsa: pointer to the allocator.
+TIME COMPLEXITY:
+    O(k) where k is the amount of cached blocks
+*/
+void MTVSAFlushCache(mt_vsa_t *mt_vsa);
+
+/*
+DESCRIPTION:
+    Determines the maximum size of a block that can be allocated from the
+    shared pool. Blocks cached by the threads are not taken into account.
+RETURN:
+    Returns the computed number.
+INPUT:
+    mt_vsa: pointer to the allocator.
+TIME COMPLEXITY:
+    As VSALargestChunkAvailable
+*/
+size_t MTVSALargestChunkAvailable(mt_vsa_t *mt_vsa);
+
+#endif /* __NSRD_MT_VSA_H__ */
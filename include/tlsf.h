@@ -0,0 +1,106 @@
+/*******************************************************************************
+*
+* FILENAME : tlsf.h
+*
+* DESCRIPTION : TLSF (Two-Level Segregated Fit) allocator is a variable-size
+* allocator with bounded response time. Free blocks are kept on lists indexed
+* by two levels: the power of two of the size, and a linear subdivision of
+* that power. A bitmap of each level tells which lists are not empty, so a
+* fitting list is found with a couple of bit scans, and both allocation and
+* deallocation take constant time whatever the state of the pool. Free
+* neighbours are merged at once with the help of boundary tags.
+* The contract is the one of vsa.h: the user provides the pool, and a block
+* is freed by its pointer alone.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_TLSF_H__
+#define __NSRD_TLSF_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct tlsf tlsf_t;
+
+
+/*
+DESCRIPTION
+    Initializes a TLSF allocator. User must provide pointer to the aligned
+    pool of the memory and specify its size. memory_pool must be aligned to
+    the word size, pool_size is aligned down to the word size.
+RETURN
+    Returns pointer to the initialized allocator.
+    Returns NULL if pool_size is less than TLSFSuggestSize(0), or if the
+    pool holds more than 2^40 bytes of blocks (2^30 on 32-bit systems).
+INPUT
+    pool_size: size of the provided pool.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY
+    O(1)
+*/
+tlsf_t *TLSFInit(size_t pool_size, void *memory_pool);
+
+/*
+DESCRIPTION
+    Allocates a block of at least the specified amount of bytes. The request
+    is rounded up to the lower bound of the next list, so that the head of any
+    non-empty list found by the bitmaps fits. The list of the request itself
+    is never looked through, so the allocation may fail while a free block
+    of that list would fit, by less than 1/16 of the request.
+RETURN
+    Returns the pointer to the beggining of the allocated block of memory,
+    aligned to the word size.
+    NULL pointer in case of failure.
+INPUT
+    tlsf: pointer to the allocator.
+    bytes: size of the block to be allocated.
+TIME COMPLEXITY
+    O(1)
+*/
+void *TLSFAlloc(tlsf_t *tlsf, size_t bytes);
+
+/*
+DESCRIPTION:
+    Deallocates the block of memory block_to_free and merges it with its free
+    neighbours. Provided block of memory should previously be allocated by a
+    TLSF allocator otherwise, the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    block_to_free: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(1)
+*/
+void TLSFFree(void *block_to_free);
+
+/*
+DESCRIPTION:
+    Determines the maximum size of a block that can be allocated taking into
+    account the current state of the allocator.
+RETURN:
+    Returns the computed number.
+INPUT:
+    tlsf: pointer to the allocator.
+TIME COMPLEXITY:
+    O(k) for k blocks on the highest non-empty list
+*/
+size_t TLSFLargestChunkAvailable(const tlsf_t *tlsf);
+
+/*
+DESCRIPTION:
+    Computes the size of a memory pool that accommodates a block of the
+    specified amount of bytes, taking into account the lists of the allocator
+    and the headers of the blocks.
+RETURN:
+    Returns the computed number.
+INPUT:
+    bytes: size of the block.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t TLSFSuggestSize(size_t bytes);
+
+#endif /* __NSRD_TLSF_H__ */
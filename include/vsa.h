@@ -5,6 +5,11 @@
 * DESCRIPTION : VSA (Variable-Size Allocator) is a memory management technique
 * that allows for the allocation and deallocation of blocks of varying sizes. It
 * is more flexible than FSA (Fixed-Size Allocator).
+* Free blocks are kept on segregated lists by the power of two of their size,
+* so most of the allocations take a block from a list without walking the
+* pool. The lists live at the beginning of the pool.
+* Every block carries a header of two words in all builds: its size and its
+* offset from the allocator, by which VSAFree finds the lists.
 * 
 * AUTHOR : Nick Shenderov
 *
@@ -15,19 +20,53 @@
 #ifndef __NSRD_VSA_H__
 #define __NSRD_VSA_H__
 
+#include <limits.h> /* CHAR_BIT */
 #include <stddef.h>
 
+/* a free block of size s is counted in class floor(log2(s)) */
+#define VSA_NUM_CLASSES (sizeof(size_t) * CHAR_BIT)
 
-typedef struct block_header vsa_t;
+
+typedef struct vsa vsa_t;
+
+typedef struct vsa_stats
+{
+    size_t live_blocks;
+    size_t free_blocks;
+    size_t bytes_in_use;
+    size_t free_bytes;
+    size_t high_water_mark;
+    size_t num_allocs;
+    size_t num_frees;
+    double fragmentation;
+} vsa_stats_t;
+
+
+/*
+DESCRIPTION
+    Pointer to the function that is called on every block of the pool by
+    VSAWalk.
+RETURN
+    0 to continue the walk, any other value stops it.
+INPUT
+    block: pointer to the beginning of the block, the content of a free block
+    is undefined.
+    size: the amount of bytes that may be used in the block.
+    is_free: 1 if the block is free, 0 if it is allocated.
+    param: pointer to the parameter given to VSAWalk.
+*/
+typedef int (*vsa_walk_action_t)(const void *block, size_t size, int is_free,
+                                                                void *param);
 
 
 /*
 DESCRIPTION
     Initializes a variable-size allocator. User must provide pointer to the
-    aligned pool of the memory and specify its size. memory_pool and pool_size
-    must be aligned to the word size.
+    aligned pool of the memory and specify its size. memory_pool must be
+    aligned to the word size, pool_size is aligned down to the word size.
 RETURN
     Returns pointer to the initialized variable-size allocator.
+    Returns NULL if pool_size is less than VSASuggestSize(0).
 INPUT
     pool_size: size of the provided pool.
     memory_pool: pointer to the memory pool.
@@ -36,6 +75,26 @@ TIME COMPLEXITY
 */
 vsa_t *VSAInit(size_t pool_size, void *memory_pool);
 
+/*
+DESCRIPTION
+    Initializes a variable-size allocator whose free blocks carry boundary
+    tags: the size of a free block is repeated in its last word, and the
+    block after it is marked. VSAFree then merges the freed block with both
+    of its neighbours right away, so no two free blocks are ever adjacent and
+    neither VSAAlloc nor VSALargestChunkAvailable has to walk the pool.
+    Blocks of a tagged allocator are at least three words long.
+    The requirements to the pool are the same as of VSAInit.
+RETURN
+    Returns pointer to the initialized variable-size allocator.
+    Returns NULL if pool_size is less than VSASuggestSize(0).
+INPUT
+    pool_size: size of the provided pool.
+    memory_pool: pointer to the memory pool.
+TIME COMPLEXITY
+    O(1)
+*/
+vsa_t *VSAInitTagged(size_t pool_size, void *memory_pool);
+
 /*
 DESCRIPTION
     Allocates a block of memory of the variable size allocator vsa at the first
@@ -44,8 +103,9 @@ DESCRIPTION
     It is recomended to use VSALargestChunkAvailable to determine the maximum
     size of a block that can be allocated taking into accound the current state
     of the vsa.
-    One of the features of the function is the usage of the defragmentation
-    mechanism.
+    The block is taken from the free list of the smallest size class that
+    fits. Only when no listed block fits, the pool is walked with the usage of
+    the defragmentation mechanism.
 RETURN
     Returns the pointer to the beggining of the allocated block of memory.
 	NULL pointer in case of failure.
@@ -53,15 +113,57 @@ INPUT
     vsa: pointer to the variable-size allocator.
     bytes: size of the block to be allocated.
 TIME COMPLEXITY
-    O(n)
+    O(1) - average, O(n) - when no listed free block fits and the vsa is not
+    tagged
 */
 void *VSAAlloc(vsa_t *vsa, size_t bytes);
 
+/*
+DESCRIPTION
+    Allocates a block of memory like VSAAlloc, whose beginning is aligned to
+    align bytes, e.g. to a cache line or a page. The free space skipped in
+    front of the block stays a free block of its own. A block is looked for
+    with room for the request at any alignment, so a request may fail while
+    VSALargestChunkAvailable reports enough bytes for it.
+RETURN
+    Returns the pointer to the beggining of the allocated block of memory.
+    NULL pointer in case of failure.
+INPUT
+    vsa: pointer to the variable-size allocator.
+    bytes: size of the block to be allocated.
+    align: alignment of the block, must be a power of two.
+TIME COMPLEXITY
+    As VSAAlloc
+*/
+void *VSAAllocAligned(vsa_t *vsa, size_t bytes, size_t align);
+
+/*
+DESCRIPTION
+    Changes the size of the allocated block to bytes. A block is shrunk in
+    place and the bytes past the new size are freed, if they hold a block.
+    A block is grown in place when the free blocks that follow it are large
+    enough, otherwise its content is copied to a newly allocated block and
+    the old one is freed. The alignment of a block given by VSAAllocAligned
+    is kept only when it is resized in place.
+    If block is NULL, it is the same as VSAAlloc.
+RETURN
+    Returns the pointer to the beggining of the resized block of memory.
+    NULL pointer in case of failure, then the block is left as it was.
+INPUT
+    vsa: pointer to the variable-size allocator the block belongs to.
+    block: pointer to the beginning of the block.
+    bytes: the new size of the block.
+TIME COMPLEXITY
+    O(1) in place, as VSAAlloc and O(bytes) otherwise
+*/
+void *VSARealloc(vsa_t *vsa, void *block, size_t bytes);
+
 /*
 DESCRIPTION:
     Deallocates the block of memory block_to_free. Provided block of memory
     should previously be allocated by a variable-size allocator otherwise, the
-	behavior is undefined.
+	behavior is undefined. The block is merged with the following block if
+	that one is free, and with the preceding one too if the vsa is tagged.
 RETURN:
     There is no return for this function.
 INPUT:
@@ -76,14 +178,99 @@ DESCRIPTION:
     Determines the maximum size of a block that can be allocated using the vsa
     taking into accound the current state of the vsa.
     One of the features of the function is the usage of the defragmentation
-    mechanism.
+    mechanism. A tagged vsa has no free neighbours to merge, so only the free
+    list of the highest size class is looked through.
 RETURN:
      Returns the computed number.
 INPUT:
     vsa: pointer to the variable-size allocator.
 TIME COMPLEXITY:
-    O(n)
+    O(n), O(k) for a tagged vsa with k free blocks in the highest class
 */
 size_t VSALargestChunkAvailable(vsa_t *vsa);
 
+/*
+DESCRIPTION:
+    Finds the size of an allocated block, which may be somewhat larger than
+    the amount of bytes it was requested with. Provided block of memory
+    should be allocated by a variable-size allocator otherwise, the behavior
+    is undefined.
+RETURN:
+    Returns the amount of bytes that may be used in the block.
+INPUT:
+    block: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t VSABlockSize(const void *block);
+
+/*
+DESCRIPTION:
+    Computes the size of a memory pool that accommodates a block of the
+    specified amount of bytes, taking into account the lists of the allocator
+    and the headers of the blocks.
+RETURN:
+    Returns the computed number.
+INPUT:
+    bytes: size of the block.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t VSASuggestSize(size_t bytes);
+
+/*
+DESCRIPTION:
+    Fills stats with the state of the vsa. The counters are kept up to date
+    by the allocations and frees, so nothing is changed:
+    live_blocks and bytes_in_use are the allocated blocks and their bytes,
+    free_blocks and free_bytes are the free ones, high_water_mark is the
+    largest bytes_in_use has ever been, num_allocs and num_frees count the
+    calls that succeeded. fragmentation is 1 - the largest free block /
+    free_bytes, 0 when all the free memory is in one block and close to 1
+    when it is scattered in many. The largest free block is estimated as
+    the average size of the free blocks of the highest size class, which
+    is at least half of it, so the ratio may read somewhat high when that
+    class holds blocks of different sizes. Free neighbours of a vsa that
+    is not tagged are counted as separate blocks until they are merged.
+RETURN:
+    There is no return for this function.
+INPUT:
+    vsa: pointer to the variable-size allocator.
+    stats: pointer to the structure to fill.
+TIME COMPLEXITY:
+    O(1)
+*/
+void VSAGetStats(const vsa_t *vsa, vsa_stats_t *stats);
+
+/*
+DESCRIPTION:
+    Calls action on every block of the pool in the order of their addresses,
+    without changing the vsa. The vsa must not be changed during the walk.
+RETURN:
+    Returns 0 if the whole pool is walked, otherwise the value returned by
+    the action that stopped the walk.
+INPUT:
+    vsa: pointer to the variable-size allocator.
+    action: the function to call on the blocks.
+    param: pointer to the parameter to pass to action.
+TIME COMPLEXITY:
+    O(n)
+*/
+int VSAWalk(const vsa_t *vsa, vsa_walk_action_t action, void *param);
+
+/*
+DESCRIPTION:
+    Fills histogram with the amount of free blocks of every size class, a
+    free block of size s being counted in class floor(log2(s)). The counts
+    are kept up to date by the allocations and frees and only copied.
+RETURN:
+    There is no return for this function.
+INPUT:
+    vsa: pointer to the variable-size allocator.
+    histogram: array of VSA_NUM_CLASSES counters to fill.
+TIME COMPLEXITY:
+    O(1)
+*/
+void VSAGetFreeHistogram(const vsa_t *vsa, size_t *histogram);
+
 #endif /* __NSRD_VSA_H__ */
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*******************************************************************************
+*
+* FILENAME : vsa_arena.h
+*
+* DESCRIPTION : Growable variable-size allocator. Blocks are allocated from a
+* chain of arenas, every arena being a tagged VSA in memory mapped from the
+* system. An arena left with no room for small requests is set aside as full
+* until one of its blocks is freed, so allocations look only through the
+* arenas that still have room. When none of them has room for a request, a
+* new one is mapped, and a request too large for an arena gets a mapping of
+* its own, that is never looked through by other requests. An arena whose
+* last block is freed is unmapped, except for one that is kept with its pages
+* given back to the system, so a workload that comes in bursts does not map
+* and unmap an arena on every burst.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_VSA_ARENA_H__
+#define __NSRD_VSA_ARENA_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct vsa_arena vsa_arena_t;
+
+
+/*
+DESCRIPTION:
+    Creates a growable variable-size allocator. No memory is mapped until
+    the first allocation.
+    Creation may fail if memory allocation fails.
+    User is responsible for memory deallocation.
+RETURN:
+    Returns pointer to the created allocator on success.
+    Returns NULL on failure.
+INPUT:
+    arena_size: size of an arena, it is rounded up to a power of two and to
+    at least a page.
+TIME COMPLEXITY:
+    O(1)
+*/
+vsa_arena_t *VSAArenaCreate(size_t arena_size);
+
+/*
+DESCRIPTION:
+    Destroys the specified allocator and unmaps all of its arenas, the
+    blocks that were not freed included.
+RETURN:
+    There is no return for this function.
+INPUT:
+    vsa_arena: pointer to the allocator to be destroyed.
+TIME COMPLEXITY:
+    O(n) where n is the amount of arenas
+*/
+void VSAArenaDestroy(vsa_arena_t *vsa_arena);
+
+/*
+DESCRIPTION:
+    Allocates a block of memory of the specified amount of bytes from the
+    first arena that has room for it, mapping a new arena if none has.
+    The arenas that turn out to have no room even for a small block are set
+    aside as full until one of their blocks is freed.
+RETURN:
+    Returns the pointer to the beggining of the allocated block of memory.
+    NULL pointer in case of failure.
+INPUT:
+    vsa_arena: pointer to the allocator.
+    bytes: size of the block to be allocated.
+TIME COMPLEXITY:
+    O(n) where n is the amount of arenas that are not full
+*/
+void *VSAArenaAlloc(vsa_arena_t *vsa_arena, size_t bytes);
+
+/*
+DESCRIPTION:
+    Deallocates the block of memory block_to_free. Its arena is looked
+    through first by the next allocation. If it was the last block of its
+    arena, the arena is given back to the system. Provided block of
+    memory should previously be allocated by the same allocator otherwise,
+    the behavior is undefined.
+RETURN:
+    There is no return for this function.
+INPUT:
+    vsa_arena: pointer to the allocator.
+    block_to_free: pointer to the beginning of the block.
+TIME COMPLEXITY:
+    O(1)
+*/
+void VSAArenaFree(vsa_arena_t *vsa_arena, void *block_to_free);
+
+/*
+DESCRIPTION:
+    Counts the arenas that are currently mapped, the kept empty one and the
+    ones of large blocks included.
+RETURN:
+    Returns the amount of arenas.
+INPUT:
+    vsa_arena: pointer to the allocator.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t VSAArenaCount(const vsa_arena_t *vsa_arena);
+
+#endif /* __NSRD_VSA_ARENA_H__ */
@@ -0,0 +1,163 @@
+/*******************************************************************************
+*
+* FILENAME : bloom_filter.c
+*
+* DESCRIPTION : Blocked bloom filter implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+#include <stdlib.h> /* malloc, free */
+#include <string.h> /* memset */
+
+#include "bloom_filter.h"
+
+#define CACHE_LINE_SIZE (64)
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+#define BLOCK_WORDS (CACHE_LINE_SIZE / sizeof(size_t))
+#define BLOCK_BITS (BLOCK_WORDS * WORD_BITS)
+#define NUM_PROBES (8)
+/* the top bits of a product pick one of the bits of a word */
+#define BIT_SHIFT (WORD_BITS - (sizeof(size_t) == 8 ? 6 : 5))
+#define BLOCK(FILTER, HASH) \
+((FILTER)->blocks + ((HASH) & ((FILTER)->num_blocks - 1)) * BLOCK_WORDS)
+#define PROBE_WORD(I) ((I) * BLOCK_WORDS / NUM_PROBES)
+#define PROBE_BIT(HASH, I) ((size_t) 1 << (((HASH) * g_salts[I]) >> BIT_SHIFT))
+/* the high half drops out where size_t has only 32 bits */
+#define WIDE_CONSTANT(HIGH, LOW) \
+(((size_t) (HIGH) << 16 << 16) | (size_t) (LOW))
+
+struct bloom_filter
+{
+    size_t *blocks;
+    size_t num_blocks;
+    size_t capacity;
+    void *memory;
+};
+
+/*
+* odd multipliers, the top bits of a product depend on every bit of the hash,
+* so each one scatters the hash to a different bit of its word
+*/
+static const size_t g_salts[NUM_PROBES] =
+{
+    WIDE_CONSTANT(0x47B6137BUL, 0x44974D91UL),
+    WIDE_CONSTANT(0x8824AD5BUL, 0xA2B7289DUL),
+    WIDE_CONSTANT(0x705495C7UL, 0x2DF1424BUL),
+    WIDE_CONSTANT(0x9EFC4947UL, 0x5C6BFB31UL),
+    WIDE_CONSTANT(0x9E3779B9UL, 0x7F4A7C15UL),
+    WIDE_CONSTANT(0xBF58476DUL, 0x1CE4E5B9UL),
+    WIDE_CONSTANT(0x94D049BBUL, 0x133111EBUL),
+    WIDE_CONSTANT(0xD6E8FEB8UL, 0x6659FD93UL)
+};
+
+static size_t RoundUpPowerOfTwo(size_t number);
+
+bloom_filter_t *BloomFilterCreate(size_t capacity, size_t bits_per_element)
+{
+    bloom_filter_t *new_filter = NULL;
+    size_t num_blocks = 0;
+
+    assert(0 < bits_per_element);
+
+    new_filter = (bloom_filter_t *) malloc(sizeof(bloom_filter_t));
+    if (NULL == new_filter)
+    {
+        return (NULL);
+    }
+
+    num_blocks = RoundUpPowerOfTwo((capacity * bits_per_element +
+                                                BLOCK_BITS - 1) / BLOCK_BITS);
+
+    /* one spare line to align the blocks to the cache lines */
+    new_filter->memory = malloc((num_blocks + 1) * CACHE_LINE_SIZE);
+    if (NULL == new_filter->memory)
+    {
+        free(new_filter);
+        return (NULL);
+    }
+
+    new_filter->blocks = (size_t *) ((char *) new_filter->memory +
+                    (CACHE_LINE_SIZE - (size_t) new_filter->memory %
+                                        CACHE_LINE_SIZE) % CACHE_LINE_SIZE);
+    new_filter->num_blocks = num_blocks;
+    new_filter->capacity = capacity;
+
+    BloomFilterClear(new_filter);
+
+    return (new_filter);
+}
+
+void BloomFilterDestroy(bloom_filter_t *filter)
+{
+    assert(NULL != filter);
+
+    free(filter->memory);
+    free(filter);
+    filter = NULL;
+}
+
+void BloomFilterAdd(bloom_filter_t *filter, size_t hash)
+{
+    size_t *block = NULL;
+    size_t i = 0;
+
+    assert(NULL != filter);
+
+    block = BLOCK(filter, hash);
+
+    for (; i < NUM_PROBES; ++i)
+    {
+        block[PROBE_WORD(i)] |= PROBE_BIT(hash, i);
+    }
+}
+
+int BloomFilterMayContain(const bloom_filter_t *filter, size_t hash)
+{
+    const size_t *block = NULL;
+    size_t missing = 0;
+    size_t i = 0;
+
+    assert(NULL != filter);
+
+    block = BLOCK(filter, hash);
+
+    /* no early exit, the whole block is in one line anyway */
+    for (; i < NUM_PROBES; ++i)
+    {
+        missing |= ~block[PROBE_WORD(i)] & PROBE_BIT(hash, i);
+    }
+
+    return (0 == missing);
+}
+
+void BloomFilterClear(bloom_filter_t *filter)
+{
+    assert(NULL != filter);
+
+    memset(filter->blocks, 0, filter->num_blocks * CACHE_LINE_SIZE);
+}
+
+size_t BloomFilterCapacity(const bloom_filter_t *filter)
+{
+    assert(NULL != filter);
+
+    return (filter->capacity);
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
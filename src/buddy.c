@@ -0,0 +1,336 @@
+/*******************************************************************************
+*
+* FILENAME : buddy.c
+*
+* DESCRIPTION : Buddy allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+#include <string.h> /* memset */
+
+#include "buddy.h"
+
+enum {FALSE, TRUE};
+
+#define WORD_SIZE (sizeof(size_t))
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+/* the smallest block holds the links of a free block */
+#define MIN_LOG (sizeof(void *) == 8 ? 4 : 3)
+#define MIN_BLOCK_SIZE ((size_t) 1 << MIN_LOG)
+#define BLOCK_SIZE(ORDER) (MIN_BLOCK_SIZE << (ORDER))
+#define ALIGN_UP(NUMBER, ALIGN) (((NUMBER) + (ALIGN) - 1) & ~((ALIGN) - 1))
+#define BUDDY_STRUCT_SIZE (sizeof(struct buddy))
+/* the index of a block among the blocks of its order */
+#define NODE(BUDDY, BLOCK, ORDER) \
+((size_t) ((char *) (BLOCK) - (BUDDY)->base) >> (MIN_LOG + (ORDER)))
+#define BIT(BITS, INDEX) \
+(((BITS)[(INDEX) / WORD_BITS] >> ((INDEX) % WORD_BITS)) & 1)
+
+typedef struct free_block free_block_t;
+
+/* kept in the first bytes of a free block */
+struct free_block
+{
+    free_block_t *next;
+    free_block_t *prev;
+};
+
+/*
+* base is the pool start aligned down to the largest block, so an address is
+* aligned to a block size exactly when its offset from base is. Bit i of the
+* bitmaps of an order belongs to the i-th block of that order from base: it
+* is set in free_bits while the block is on a free list, and in split_bits
+* while the block is split in halves. Blocks that are not in the pool are
+* never free and are always split.
+*/
+struct buddy
+{
+    char *base;
+    size_t max_order;
+    size_t free_orders;
+    size_t *free_bits;
+    size_t *split_bits;
+    size_t bit_offsets[sizeof(size_t) * CHAR_BIT];
+    free_block_t *free_lists[sizeof(size_t) * CHAR_BIT];
+};
+
+static void PushBlock(buddy_t *buddy, free_block_t *block, size_t order);
+static void RemoveBlock(buddy_t *buddy, free_block_t *block, size_t order);
+static size_t FindOrder(const buddy_t *buddy, const void *block);
+static int IsFree(const buddy_t *buddy, const void *block, size_t order);
+static int IsSplit(const buddy_t *buddy, const void *block, size_t order);
+static void SetSplit(buddy_t *buddy, void *block, size_t order, int is_split);
+static void SetBit(size_t *bits, size_t index, int value);
+static size_t FloorLog2(size_t number);
+
+buddy_t *BuddyInit(size_t pool_size, void *memory_pool)
+{
+    buddy_t *buddy = NULL;
+    char *runner = NULL;
+    char *end = NULL;
+    size_t num_bits = 0;
+    size_t span = 0;
+    size_t order = 0;
+
+    assert(NULL != memory_pool);
+    assert(0 == (size_t) memory_pool % WORD_SIZE);
+    assert(BUDDY_STRUCT_SIZE + BLOCK_SIZE(1) <= pool_size);
+
+    buddy = (buddy_t *) memory_pool;
+    buddy->max_order = FloorLog2(pool_size) - MIN_LOG;
+    buddy->base = (char *) ((size_t) memory_pool &
+                                    ~(BLOCK_SIZE(buddy->max_order) - 1));
+    buddy->free_orders = 0;
+
+    end = (char *) memory_pool + (pool_size & ~(MIN_BLOCK_SIZE - 1));
+    span = end - buddy->base;
+
+    for (; order <= buddy->max_order; ++order)
+    {
+        buddy->bit_offsets[order] = num_bits;
+        buddy->free_lists[order] = NULL;
+        /* one more bit for the buddy past the end of the last block */
+        num_bits += ALIGN_UP((span >> (MIN_LOG + order)) + 2, WORD_BITS);
+    }
+
+    buddy->free_bits = (size_t *) ((char *) buddy + BUDDY_STRUCT_SIZE);
+    buddy->split_bits = buddy->free_bits + num_bits / WORD_BITS;
+
+    memset(buddy->free_bits, 0, num_bits / CHAR_BIT);
+    memset(buddy->split_bits, 0xFF, num_bits / CHAR_BIT);
+
+    /* the rest of the pool is cut into the largest aligned blocks it holds */
+    runner = (char *) ALIGN_UP((size_t) (buddy->split_bits +
+                                num_bits / WORD_BITS), MIN_BLOCK_SIZE);
+
+    while (runner + MIN_BLOCK_SIZE <= end)
+    {
+        order = buddy->max_order;
+
+        while (0 != (size_t) (runner - buddy->base) % BLOCK_SIZE(order) ||
+                                (size_t) (end - runner) < BLOCK_SIZE(order))
+        {
+            --order;
+        }
+
+        PushBlock(buddy, (free_block_t *) runner, order);
+        runner += BLOCK_SIZE(order);
+    }
+
+    return (buddy);
+}
+
+void *BuddyAlloc(buddy_t *buddy, size_t bytes)
+{
+    free_block_t *block = NULL;
+    size_t fit_orders = 0;
+    size_t req_order = 0;
+    size_t order = 0;
+
+    assert(NULL != buddy);
+    assert(0 < bytes);
+
+    if (bytes > BLOCK_SIZE(buddy->max_order))
+    {
+        return (NULL);
+    }
+
+    if (MIN_BLOCK_SIZE < bytes)
+    {
+        req_order = FloorLog2(bytes - 1) + 1 - MIN_LOG;
+    }
+
+    fit_orders = buddy->free_orders & ~(((size_t) 1 << req_order) - 1);
+    if (0 == fit_orders)
+    {
+        return (NULL);
+    }
+
+    /* the smallest free block that fits is halved down to the request */
+    order = FloorLog2(fit_orders & (~fit_orders + 1));
+    block = buddy->free_lists[order];
+    RemoveBlock(buddy, block, order);
+
+    for (; order > req_order; --order)
+    {
+        SetSplit(buddy, block, order, TRUE);
+        PushBlock(buddy, (free_block_t *) ((char *) block +
+                                            BLOCK_SIZE(order - 1)), order - 1);
+    }
+
+    SetSplit(buddy, block, req_order, FALSE);
+
+    return (block);
+}
+
+void BuddyFree(buddy_t *buddy, void *block_to_free)
+{
+    char *block = block_to_free;
+    char *buddy_block = NULL;
+    size_t order = 0;
+
+    assert(NULL != buddy);
+    assert(NULL != block_to_free);
+
+    order = FindOrder(buddy, block);
+
+    assert(FALSE == IsFree(buddy, block, order));
+
+    /* a buddy outside the pool is never free, so it stops the merging */
+    for (; order < buddy->max_order; ++order)
+    {
+        buddy_block = buddy->base + ((size_t) (block - buddy->base) ^
+                                                        BLOCK_SIZE(order));
+
+        if (FALSE == IsFree(buddy, buddy_block, order))
+        {
+            break;
+        }
+
+        RemoveBlock(buddy, (free_block_t *) buddy_block, order);
+
+        if (buddy_block < block)
+        {
+            block = buddy_block;
+        }
+
+        SetSplit(buddy, block, order + 1, FALSE);
+    }
+
+    PushBlock(buddy, (free_block_t *) block, order);
+}
+
+size_t BuddyBlockSize(const buddy_t *buddy, const void *block)
+{
+    assert(NULL != buddy);
+    assert(NULL != block);
+
+    return (BLOCK_SIZE(FindOrder(buddy, block)));
+}
+
+size_t BuddyLargestChunkAvailable(const buddy_t *buddy)
+{
+    assert(NULL != buddy);
+
+    if (0 == buddy->free_orders)
+    {
+        return (0);
+    }
+
+    return (BLOCK_SIZE(FloorLog2(buddy->free_orders)));
+}
+
+static size_t FindOrder(const buddy_t *buddy, const void *block)
+{
+    size_t order = buddy->max_order;
+
+    /* from the largest block that holds it, down to the one not split */
+    while (0 < order && TRUE == IsSplit(buddy, block, order))
+    {
+        --order;
+    }
+
+    assert(0 == (size_t) ((char *) block - buddy->base) % BLOCK_SIZE(order));
+
+    return (order);
+}
+
+static void PushBlock(buddy_t *buddy, free_block_t *block, size_t order)
+{
+    block->prev = NULL;
+    block->next = buddy->free_lists[order];
+
+    if (NULL != block->next)
+    {
+        block->next->prev = block;
+    }
+
+    buddy->free_lists[order] = block;
+    buddy->free_orders |= (size_t) 1 << order;
+
+    SetBit(buddy->free_bits, buddy->bit_offsets[order] +
+                                        NODE(buddy, block, order), TRUE);
+    SetSplit(buddy, block, order, FALSE);
+}
+
+static void RemoveBlock(buddy_t *buddy, free_block_t *block, size_t order)
+{
+    if (NULL != block->next)
+    {
+        block->next->prev = block->prev;
+    }
+
+    if (NULL != block->prev)
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        buddy->free_lists[order] = block->next;
+
+        if (NULL == block->next)
+        {
+            buddy->free_orders &= ~((size_t) 1 << order);
+        }
+    }
+
+    SetBit(buddy->free_bits, buddy->bit_offsets[order] +
+                                        NODE(buddy, block, order), FALSE);
+}
+
+static int IsFree(const buddy_t *buddy, const void *block, size_t order)
+{
+    return ((int) BIT(buddy->free_bits, buddy->bit_offsets[order] +
+                                                NODE(buddy, block, order)));
+}
+
+static int IsSplit(const buddy_t *buddy, const void *block, size_t order)
+{
+    return ((int) BIT(buddy->split_bits, buddy->bit_offsets[order] +
+                                                NODE(buddy, block, order)));
+}
+
+static void SetSplit(buddy_t *buddy, void *block, size_t order, int is_split)
+{
+    SetBit(buddy->split_bits, buddy->bit_offsets[order] +
+                                        NODE(buddy, block, order), is_split);
+}
+
+static void SetBit(size_t *bits, size_t index, int value)
+{
+    size_t mask = (size_t) 1 << (index % WORD_BITS);
+
+    if (TRUE == value)
+    {
+        bits[index / WORD_BITS] |= mask;
+    }
+    else
+    {
+        bits[index / WORD_BITS] &= ~mask;
+    }
+}
+
+static size_t FloorLog2(size_t number)
+{
+    size_t log = 0;
+    size_t shift = WORD_BITS / 2;
+
+    assert(0 < number);
+
+    for (; 0 < shift; shift /= 2)
+    {
+        if (0 != (number >> shift))
+        {
+            number >>= shift;
+            log += shift;
+        }
+    }
+
+    return (log);
+}
@@ -0,0 +1,386 @@
+/*******************************************************************************
+*
+* FILENAME : cache.c
+*
+* DESCRIPTION : Bounded cache implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, free */
+
+#include "cache.h"
+
+#define IS_ENTRY_USED(ENTRY) (NULL != (ENTRY)->data)
+
+enum {SUCCESS, FAILURE};
+
+typedef struct cache_entry
+{
+    cache_t *cache;
+    void *data;
+    size_t bytes;
+    struct cache_entry *prev;
+    struct cache_entry *next;
+    int is_referenced;
+} cache_entry_t;
+
+struct cache
+{
+    h_table_t *table;
+    cache_entry_t *entries;
+    cache_entry_t *free_entries;
+    cache_entry_t recency;
+    size_t max_entries;
+    size_t max_bytes;
+    size_t size;
+    size_t bytes;
+    size_t hand;
+    cache_policy_t policy;
+    h_table_hash_t hash_func;
+    h_table_is_match_t is_match;
+    cache_evict_t on_evict;
+    void *param;
+};
+
+static cache_entry_t *Lookup(cache_t *cache, const void *key);
+static void Touch(cache_t *cache, cache_entry_t *entry);
+static void EvictOne(cache_t *cache, const cache_entry_t *keep);
+static cache_entry_t *PickVictim(cache_t *cache, const cache_entry_t *keep);
+static void Release(cache_t *cache, cache_entry_t *entry);
+static void Unlink(cache_entry_t *entry);
+static void LinkFirst(cache_t *cache, cache_entry_t *entry);
+static size_t HashEntry(const void *entry);
+static int IsMatchEntry(const void *entry1, const void *entry2);
+
+cache_t *CacheCreate(size_t max_entries, size_t max_bytes,
+                    cache_policy_t policy, h_table_hash_t hash_func,
+                    h_table_is_match_t is_match, cache_evict_t on_evict,
+                                                                void *param)
+{
+    cache_t *new_cache = NULL;
+    size_t i = 0;
+
+    assert(0 < max_entries);
+    assert(CACHE_LRU == policy || CACHE_CLOCK == policy);
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+
+    new_cache = (cache_t *) malloc(sizeof(cache_t));
+    if (NULL == new_cache)
+    {
+        return (NULL);
+    }
+
+    new_cache->entries =
+    (cache_entry_t *) malloc(max_entries * sizeof(cache_entry_t));
+    new_cache->table = HashTableCreateFlat(max_entries, HashEntry,
+                                                                IsMatchEntry);
+    if (NULL == new_cache->entries || NULL == new_cache->table)
+    {
+        if (NULL != new_cache->table)
+        {
+            HashTableDestroy(new_cache->table);
+        }
+
+        free(new_cache->entries);
+        free(new_cache);
+        return (NULL);
+    }
+
+    /* every entry starts on the free list, chained through next */
+    for (; i < max_entries; ++i)
+    {
+        new_cache->entries[i].cache = new_cache;
+        new_cache->entries[i].data = NULL;
+        new_cache->entries[i].next = new_cache->entries + i + 1;
+    }
+
+    new_cache->entries[max_entries - 1].next = NULL;
+    new_cache->free_entries = new_cache->entries;
+
+    new_cache->recency.prev = &new_cache->recency;
+    new_cache->recency.next = &new_cache->recency;
+
+    new_cache->max_entries = max_entries;
+    new_cache->max_bytes = max_bytes;
+    new_cache->size = 0;
+    new_cache->bytes = 0;
+    new_cache->hand = 0;
+    new_cache->policy = policy;
+    new_cache->hash_func = hash_func;
+    new_cache->is_match = is_match;
+    new_cache->on_evict = on_evict;
+    new_cache->param = param;
+
+    return (new_cache);
+}
+
+void CacheDestroy(cache_t *cache)
+{
+    size_t i = 0;
+
+    assert(NULL != cache);
+
+    for (; i < cache->max_entries && NULL != cache->on_evict; ++i)
+    {
+        if (IS_ENTRY_USED(&cache->entries[i]))
+        {
+            cache->on_evict(cache->entries[i].data, cache->param);
+        }
+    }
+
+    HashTableDestroy(cache->table);
+    free(cache->entries);
+    free(cache);
+    cache = NULL;
+}
+
+void *CacheGet(cache_t *cache, const void *key)
+{
+    cache_entry_t *entry = NULL;
+
+    assert(NULL != cache);
+    assert(NULL != key);
+
+    entry = Lookup(cache, key);
+    if (NULL == entry)
+    {
+        return (NULL);
+    }
+
+    Touch(cache, entry);
+
+    return (entry->data);
+}
+
+int CachePut(cache_t *cache, void *data, size_t bytes)
+{
+    cache_entry_t *entry = NULL;
+    void *replaced = NULL;
+
+    assert(NULL != cache);
+    assert(NULL != data);
+
+    if (0 != cache->max_bytes && cache->max_bytes < bytes)
+    {
+        return (FAILURE);
+    }
+
+    entry = Lookup(cache, data);
+    if (NULL != entry)
+    {
+        replaced = entry->data;
+        cache->bytes -= entry->bytes;
+
+        /* the table keeps the entry, only its contents change */
+        entry->data = data;
+        entry->bytes = bytes;
+        cache->bytes += bytes;
+        Touch(cache, entry);
+
+        while (0 != cache->max_bytes && cache->max_bytes < cache->bytes)
+        {
+            EvictOne(cache, entry);
+        }
+
+        if (replaced != data && NULL != cache->on_evict)
+        {
+            cache->on_evict(replaced, cache->param);
+        }
+
+        return (SUCCESS);
+    }
+
+    while (cache->max_entries == cache->size ||
+            (0 != cache->max_bytes && cache->max_bytes - bytes < cache->bytes))
+    {
+        EvictOne(cache, NULL);
+    }
+
+    entry = cache->free_entries;
+    cache->free_entries = entry->next;
+
+    entry->data = data;
+    entry->bytes = bytes;
+    entry->is_referenced = 1;
+    LinkFirst(cache, entry);
+
+    /* the table is sized for every entry, so it never has to grow */
+    HashTableInsert(cache->table, entry);
+
+    ++cache->size;
+    cache->bytes += bytes;
+
+    return (SUCCESS);
+}
+
+void *CacheRemove(cache_t *cache, const void *key)
+{
+    cache_entry_t *entry = NULL;
+    void *removed = NULL;
+
+    assert(NULL != cache);
+    assert(NULL != key);
+
+    entry = Lookup(cache, key);
+    if (NULL == entry)
+    {
+        return (NULL);
+    }
+
+    removed = entry->data;
+    Release(cache, entry);
+
+    return (removed);
+}
+
+size_t CacheSize(const cache_t *cache)
+{
+    assert(NULL != cache);
+
+    return (cache->size);
+}
+
+size_t CacheBytes(const cache_t *cache)
+{
+    assert(NULL != cache);
+
+    return (cache->bytes);
+}
+
+static cache_entry_t *Lookup(cache_t *cache, const void *key)
+{
+    cache_entry_t probe = {0};
+
+    assert(NULL != cache);
+
+    /* the table only holds entries, so the key travels in one as well */
+    probe.cache = cache;
+    probe.data = (void *) key;
+
+    return (HashTableFind(cache->table, &probe));
+}
+
+static void Touch(cache_t *cache, cache_entry_t *entry)
+{
+    assert(NULL != cache);
+    assert(NULL != entry);
+
+    if (CACHE_CLOCK == cache->policy)
+    {
+        entry->is_referenced = 1;
+    }
+    else if (cache->recency.next != entry)
+    {
+        Unlink(entry);
+        LinkFirst(cache, entry);
+    }
+}
+
+static void EvictOne(cache_t *cache, const cache_entry_t *keep)
+{
+    cache_entry_t *victim = NULL;
+    void *data = NULL;
+
+    assert(NULL != cache);
+
+    victim = PickVictim(cache, keep);
+    data = victim->data;
+
+    Release(cache, victim);
+
+    if (NULL != cache->on_evict)
+    {
+        cache->on_evict(data, cache->param);
+    }
+}
+
+static cache_entry_t *PickVictim(cache_t *cache, const cache_entry_t *keep)
+{
+    cache_entry_t *entry = NULL;
+
+    assert(NULL != cache);
+    assert(0 < cache->size);
+
+    if (CACHE_LRU == cache->policy)
+    {
+        entry = cache->recency.prev;
+
+        return ((entry != keep) ? entry : entry->prev);
+    }
+
+    /* the hand clears reference bits until it meets an unreferenced entry */
+    for (;;)
+    {
+        entry = &cache->entries[cache->hand];
+        cache->hand = (cache->hand + 1) % cache->max_entries;
+
+        if (!IS_ENTRY_USED(entry) || entry == keep)
+        {
+            continue;
+        }
+
+        if (!entry->is_referenced)
+        {
+            return (entry);
+        }
+
+        entry->is_referenced = 0;
+    }
+}
+
+static void Release(cache_t *cache, cache_entry_t *entry)
+{
+    assert(NULL != cache);
+    assert(NULL != entry);
+
+    HashTableRemove(cache->table, entry);
+    Unlink(entry);
+
+    --cache->size;
+    cache->bytes -= entry->bytes;
+
+    entry->data = NULL;
+    entry->next = cache->free_entries;
+    cache->free_entries = entry;
+}
+
+static void Unlink(cache_entry_t *entry)
+{
+    assert(NULL != entry);
+
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+}
+
+static void LinkFirst(cache_t *cache, cache_entry_t *entry)
+{
+    assert(NULL != cache);
+    assert(NULL != entry);
+
+    entry->prev = &cache->recency;
+    entry->next = cache->recency.next;
+    cache->recency.next->prev = entry;
+    cache->recency.next = entry;
+}
+
+static size_t HashEntry(const void *entry)
+{
+    const cache_entry_t *cache_entry = entry;
+
+    return (cache_entry->cache->hash_func(cache_entry->data));
+}
+
+static int IsMatchEntry(const void *entry1, const void *entry2)
+{
+    const cache_entry_t *cache_entry1 = entry1;
+    const cache_entry_t *cache_entry2 = entry2;
+
+    return (cache_entry1->cache->is_match(cache_entry1->data,
+                                                        cache_entry2->data));
+}
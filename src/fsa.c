@@ -30,17 +30,27 @@ enum {FALSE, TRUE};
 (NUMBER = (((unsigned long)(NUMBER + (WORD_SIZE - 1))) & ~(WORD_SIZE - 1)))
 
 
+/*
+* next_free_offset heads the list of the freed blocks, the blocks that were
+* never allocated start at untouched_offset, the counters are updated by
+* every allocation and free
+*/
 struct fsa
 {
     size_t next_free_offset;
+    size_t untouched_offset;
+    size_t block_size;
+    size_t num_blocks;
+    size_t num_free;
+    size_t high_water_mark;
+    size_t num_allocs;
+    size_t num_frees;
 };
 
 
 fsa_t *FSAInit(size_t size_of_block, size_t number_of_blocks, void *memory_pool)
 {
 	fsa_t *new_fsa = NULL;
-	void *runner = NULL;
-	size_t offset_runner = FSA_STRUCT_SIZE;
 
 	assert(NULL != memory_pool);
 	assert(TRUE == IS_MEMORY_ALIGN(memory_pool));
@@ -49,20 +59,14 @@ fsa_t *FSAInit(size_t size_of_block, size_t number_of_blocks, void *memory_pool)
 
 	new_fsa = memory_pool;
 
-	new_fsa->next_free_offset = FSA_STRUCT_SIZE;
-
-	runner = (char *)new_fsa + new_fsa->next_free_offset;
-
-	while(1 != number_of_blocks)
-	{
-		*(size_t *) runner = offset_runner + size_of_block;
-
-		offset_runner += size_of_block;
-		runner = (char *)runner + size_of_block;
-		--number_of_blocks;
-	}
-
-	*(size_t *) runner = LAST_BLOCK;
+	new_fsa->next_free_offset = LAST_BLOCK;
+	new_fsa->untouched_offset = FSA_STRUCT_SIZE;
+	new_fsa->block_size = size_of_block;
+	new_fsa->num_blocks = number_of_blocks;
+	new_fsa->num_free = number_of_blocks;
+	new_fsa->high_water_mark = 0;
+	new_fsa->num_allocs = 0;
+	new_fsa->num_frees = 0;
 
 	return (new_fsa);
 }
@@ -73,14 +77,30 @@ void *FSAAlloc(fsa_t *fsa)
 
 	assert(NULL != fsa);
 
-	if (LAST_BLOCK == fsa->next_free_offset)
+	if (0 == fsa->num_free)
 	{
 		return (NULL);
 	}
 
-	free_block = (char *)fsa + (fsa->next_free_offset);
+	/* the pool is not touched before its blocks are needed */
+	if (LAST_BLOCK == fsa->next_free_offset)
+	{
+		free_block = (char *)fsa + fsa->untouched_offset;
+		fsa->untouched_offset += fsa->block_size;
+	}
+	else
+	{
+		free_block = (char *)fsa + fsa->next_free_offset;
+		fsa->next_free_offset = *(size_t *) free_block;
+	}
+
+	--fsa->num_free;
+	++fsa->num_allocs;
 
-	fsa->next_free_offset = *(size_t *) free_block;
+	if (fsa->num_blocks - fsa->num_free > fsa->high_water_mark)
+	{
+		fsa->high_water_mark = fsa->num_blocks - fsa->num_free;
+	}
 
 	return (free_block);
 }
@@ -100,6 +120,9 @@ void FSAFree(fsa_t *fsa, void *block_to_free)
 	fsa->next_free_offset = block_offset;
 
 	*(size_t *) block_to_free = fsa_curr_offset;
+
+	++fsa->num_free;
+	++fsa->num_frees;
 }
 
 size_t FSASuggestSize(size_t numb_of_blocks, size_t block_size)
@@ -111,27 +134,22 @@ size_t FSASuggestSize(size_t numb_of_blocks, size_t block_size)
 
 size_t FSACountFree(const fsa_t *fsa)
 {
-	char *runner = NULL;
-	size_t counter = 0;
-
 	assert(NULL != fsa);
 
-	if (LAST_BLOCK == fsa->next_free_offset)
-	{
-		return (0);
-	}
-
-	runner = ((char *)fsa + (fsa->next_free_offset));
-
-	++counter;
-
-	while(LAST_BLOCK != *(size_t *) runner)
-	{
-		++counter;
-		runner = (char *)fsa + (*(size_t *) runner);
-	}
+	return (fsa->num_free);
+}
 
-	return (counter);
+void FSAGetStats(const fsa_t *fsa, fsa_stats_t *stats)
+{
+	assert(NULL != fsa);
+	assert(NULL != stats);
+
+	stats->live_blocks = fsa->num_blocks - fsa->num_free;
+	stats->free_blocks = fsa->num_free;
+	stats->bytes_in_use = stats->live_blocks * fsa->block_size;
+	stats->high_water_mark = fsa->high_water_mark * fsa->block_size;
+	stats->num_allocs = fsa->num_allocs;
+	stats->num_frees = fsa->num_frees;
 }
 
 
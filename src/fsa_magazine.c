@@ -0,0 +1,406 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_magazine.c
+*
+* DESCRIPTION : Thread-safe fixed-size allocator with per-thread magazines
+* implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <pthread.h> /* pthread_mutex_t, pthread_key_t */
+#include <stdlib.h> /* malloc, free */
+
+#include "fsa_magazine.h"
+#include "fsa.h"
+
+#define MAGAZINE_SIZE (32)
+
+typedef struct magazine magazine_t;
+typedef struct thread_cache thread_cache_t;
+
+struct magazine
+{
+    magazine_t *next;
+    size_t rounds;
+    void *blocks[MAGAZINE_SIZE];
+};
+
+/* loaded is used first, previous is either full or empty once used */
+struct thread_cache
+{
+    fsa_magazine_t *owner;
+    thread_cache_t *next;
+    thread_cache_t *prev;
+    magazine_t *loaded;
+    magazine_t *previous;
+};
+
+/*
+* the depot keeps full magazines and empty ones on two lists, everything but
+* the key is guarded by lock
+*/
+struct fsa_magazine
+{
+    pthread_mutex_t lock;
+    pthread_key_t cache_key;
+    fsa_t *fsa;
+    thread_cache_t *caches;
+    magazine_t *full;
+    magazine_t *empty;
+    size_t num_full;
+};
+
+static thread_cache_t *GetCache(fsa_magazine_t *fsa_magazine);
+static void DestroyCache(void *cache_to_destroy);
+static void Reload(fsa_magazine_t *fsa_magazine, thread_cache_t *cache);
+static int Unload(fsa_magazine_t *fsa_magazine, thread_cache_t *cache);
+static void SwapMagazines(thread_cache_t *cache);
+static void EmptyMagazine(fsa_magazine_t *fsa_magazine, magazine_t *magazine);
+static void FreeMagazines(magazine_t *magazine);
+
+fsa_magazine_t *FSAMagazineCreate(size_t size_of_block,
+                                size_t number_of_blocks, void *memory_pool)
+{
+    fsa_magazine_t *fsa_magazine = NULL;
+
+    assert(NULL != memory_pool);
+
+    fsa_magazine = (fsa_magazine_t *) malloc(sizeof(fsa_magazine_t));
+    if (NULL == fsa_magazine)
+    {
+        return (NULL);
+    }
+
+    if (0 != pthread_mutex_init(&fsa_magazine->lock, NULL))
+    {
+        free(fsa_magazine);
+        return (NULL);
+    }
+
+    if (0 != pthread_key_create(&fsa_magazine->cache_key, DestroyCache))
+    {
+        pthread_mutex_destroy(&fsa_magazine->lock);
+        free(fsa_magazine);
+        return (NULL);
+    }
+
+    fsa_magazine->fsa = FSAInit(size_of_block, number_of_blocks, memory_pool);
+    fsa_magazine->caches = NULL;
+    fsa_magazine->full = NULL;
+    fsa_magazine->empty = NULL;
+    fsa_magazine->num_full = 0;
+
+    return (fsa_magazine);
+}
+
+void FSAMagazineDestroy(fsa_magazine_t *fsa_magazine)
+{
+    thread_cache_t *next = NULL;
+
+    assert(NULL != fsa_magazine);
+
+    /* the destructors are not called for a deleted key */
+    pthread_key_delete(fsa_magazine->cache_key);
+
+    while (NULL != fsa_magazine->caches)
+    {
+        next = fsa_magazine->caches->next;
+        free(fsa_magazine->caches->loaded);
+        free(fsa_magazine->caches->previous);
+        free(fsa_magazine->caches);
+        fsa_magazine->caches = next;
+    }
+
+    FreeMagazines(fsa_magazine->full);
+    FreeMagazines(fsa_magazine->empty);
+
+    pthread_mutex_destroy(&fsa_magazine->lock);
+    free(fsa_magazine);
+}
+
+void *FSAMagazineAlloc(fsa_magazine_t *fsa_magazine)
+{
+    thread_cache_t *cache = NULL;
+    void *block = NULL;
+
+    assert(NULL != fsa_magazine);
+
+    cache = GetCache(fsa_magazine);
+    if (NULL == cache)
+    {
+        pthread_mutex_lock(&fsa_magazine->lock);
+        block = FSAAlloc(fsa_magazine->fsa);
+        pthread_mutex_unlock(&fsa_magazine->lock);
+
+        return (block);
+    }
+
+    if (0 == cache->loaded->rounds)
+    {
+        if (0 != cache->previous->rounds)
+        {
+            SwapMagazines(cache);
+        }
+        else
+        {
+            Reload(fsa_magazine, cache);
+
+            if (0 == cache->loaded->rounds)
+            {
+                return (NULL);
+            }
+        }
+    }
+
+    --cache->loaded->rounds;
+
+    return (cache->loaded->blocks[cache->loaded->rounds]);
+}
+
+void FSAMagazineFree(fsa_magazine_t *fsa_magazine, void *block_to_free)
+{
+    thread_cache_t *cache = NULL;
+
+    assert(NULL != fsa_magazine);
+    assert(NULL != block_to_free);
+
+    cache = GetCache(fsa_magazine);
+
+    if (NULL != cache && MAGAZINE_SIZE == cache->loaded->rounds)
+    {
+        if (MAGAZINE_SIZE != cache->previous->rounds)
+        {
+            SwapMagazines(cache);
+        }
+        else if (0 != Unload(fsa_magazine, cache))
+        {
+            cache = NULL;
+        }
+    }
+
+    /* without magazines the block goes back to the fsa right away */
+    if (NULL == cache)
+    {
+        pthread_mutex_lock(&fsa_magazine->lock);
+        FSAFree(fsa_magazine->fsa, block_to_free);
+        pthread_mutex_unlock(&fsa_magazine->lock);
+
+        return;
+    }
+
+    cache->loaded->blocks[cache->loaded->rounds] = block_to_free;
+    ++cache->loaded->rounds;
+}
+
+void FSAMagazineFlushCache(fsa_magazine_t *fsa_magazine)
+{
+    thread_cache_t *cache = NULL;
+
+    assert(NULL != fsa_magazine);
+
+    cache = (thread_cache_t *) pthread_getspecific(fsa_magazine->cache_key);
+    if (NULL == cache)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+    EmptyMagazine(fsa_magazine, cache->loaded);
+    EmptyMagazine(fsa_magazine, cache->previous);
+    pthread_mutex_unlock(&fsa_magazine->lock);
+}
+
+size_t FSAMagazineCountFree(fsa_magazine_t *fsa_magazine)
+{
+    size_t num_free = 0;
+
+    assert(NULL != fsa_magazine);
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+    num_free = FSACountFree(fsa_magazine->fsa) +
+                                    fsa_magazine->num_full * MAGAZINE_SIZE;
+    pthread_mutex_unlock(&fsa_magazine->lock);
+
+    return (num_free);
+}
+
+static thread_cache_t *GetCache(fsa_magazine_t *fsa_magazine)
+{
+    thread_cache_t *cache = NULL;
+
+    cache = (thread_cache_t *) pthread_getspecific(fsa_magazine->cache_key);
+    if (NULL != cache)
+    {
+        return (cache);
+    }
+
+    /* without magazines the thread goes to the fsa every time */
+    cache = (thread_cache_t *) malloc(sizeof(thread_cache_t));
+    if (NULL == cache)
+    {
+        return (NULL);
+    }
+
+    cache->loaded = (magazine_t *) malloc(sizeof(magazine_t));
+    cache->previous = (magazine_t *) malloc(sizeof(magazine_t));
+    if (NULL == cache->loaded || NULL == cache->previous ||
+            0 != pthread_setspecific(fsa_magazine->cache_key, cache))
+    {
+        free(cache->loaded);
+        free(cache->previous);
+        free(cache);
+        return (NULL);
+    }
+
+    cache->loaded->rounds = 0;
+    cache->previous->rounds = 0;
+    cache->owner = fsa_magazine;
+    cache->prev = NULL;
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+
+    cache->next = fsa_magazine->caches;
+    if (NULL != cache->next)
+    {
+        cache->next->prev = cache;
+    }
+    fsa_magazine->caches = cache;
+
+    pthread_mutex_unlock(&fsa_magazine->lock);
+
+    return (cache);
+}
+
+/* called at the exit of the thread that owns the cache */
+static void DestroyCache(void *cache_to_destroy)
+{
+    thread_cache_t *cache = (thread_cache_t *) cache_to_destroy;
+    fsa_magazine_t *fsa_magazine = cache->owner;
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+
+    EmptyMagazine(fsa_magazine, cache->loaded);
+    EmptyMagazine(fsa_magazine, cache->previous);
+
+    if (NULL != cache->next)
+    {
+        cache->next->prev = cache->prev;
+    }
+
+    if (NULL != cache->prev)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        fsa_magazine->caches = cache->next;
+    }
+
+    pthread_mutex_unlock(&fsa_magazine->lock);
+
+    free(cache->loaded);
+    free(cache->previous);
+    free(cache);
+}
+
+/* both magazines are empty: a full one is taken from the depot or filled */
+static void Reload(fsa_magazine_t *fsa_magazine, thread_cache_t *cache)
+{
+    magazine_t *magazine = NULL;
+    void *block = NULL;
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+
+    if (NULL != fsa_magazine->full)
+    {
+        magazine = fsa_magazine->full;
+        fsa_magazine->full = magazine->next;
+        --fsa_magazine->num_full;
+
+        cache->previous->next = fsa_magazine->empty;
+        fsa_magazine->empty = cache->previous;
+
+        cache->previous = cache->loaded;
+        cache->loaded = magazine;
+    }
+    else
+    {
+        while (MAGAZINE_SIZE > cache->loaded->rounds &&
+                            NULL != (block = FSAAlloc(fsa_magazine->fsa)))
+        {
+            cache->loaded->blocks[cache->loaded->rounds] = block;
+            ++cache->loaded->rounds;
+        }
+    }
+
+    pthread_mutex_unlock(&fsa_magazine->lock);
+}
+
+/* both magazines are full: one of them is traded for an empty one */
+static int Unload(fsa_magazine_t *fsa_magazine, thread_cache_t *cache)
+{
+    magazine_t *magazine = NULL;
+
+    pthread_mutex_lock(&fsa_magazine->lock);
+
+    magazine = fsa_magazine->empty;
+    if (NULL != magazine)
+    {
+        fsa_magazine->empty = magazine->next;
+    }
+    else
+    {
+        magazine = (magazine_t *) malloc(sizeof(magazine_t));
+        if (NULL == magazine)
+        {
+            pthread_mutex_unlock(&fsa_magazine->lock);
+            return (1);
+        }
+    }
+
+    cache->previous->next = fsa_magazine->full;
+    fsa_magazine->full = cache->previous;
+    ++fsa_magazine->num_full;
+
+    pthread_mutex_unlock(&fsa_magazine->lock);
+
+    magazine->rounds = 0;
+    cache->previous = cache->loaded;
+    cache->loaded = magazine;
+
+    return (0);
+}
+
+static void SwapMagazines(thread_cache_t *cache)
+{
+    magazine_t *magazine = cache->loaded;
+
+    cache->loaded = cache->previous;
+    cache->previous = magazine;
+}
+
+static void EmptyMagazine(fsa_magazine_t *fsa_magazine, magazine_t *magazine)
+{
+    while (0 < magazine->rounds)
+    {
+        --magazine->rounds;
+        FSAFree(fsa_magazine->fsa, magazine->blocks[magazine->rounds]);
+    }
+}
+
+static void FreeMagazines(magazine_t *magazine)
+{
+    magazine_t *next = NULL;
+
+    while (NULL != magazine)
+    {
+        next = magazine->next;
+        free(magazine);
+        magazine = next;
+    }
+}
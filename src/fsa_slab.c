@@ -0,0 +1,317 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_slab.c
+*
+* DESCRIPTION : Growable fixed-size allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, madvise */
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, free */
+#include <sys/mman.h> /* mmap, munmap, madvise */
+#include <unistd.h> /* sysconf */
+
+#include "fsa_slab.h"
+#include "fsa.h"
+
+#define SLAB_STRUCT_SIZE (sizeof(slab_t))
+#define ALIGN_UP(NUMBER, ALIGN) (((NUMBER) + (ALIGN) - 1) & ~((ALIGN) - 1))
+/* every slab starts at a multiple of slab_size, its blocks lead to it */
+#define GET_SLAB(FSA_SLAB, BLOCK) \
+((slab_t *) ((size_t) (BLOCK) & ~((FSA_SLAB)->slab_size - 1)))
+#define POOL(SLAB) ((char *) (SLAB) + SLAB_STRUCT_SIZE)
+
+typedef struct slab slab_t;
+
+/* kept at the beginning of a mapping, the pool of the fsa follows */
+struct slab
+{
+    slab_t *next;
+    slab_t *prev;
+    fsa_t *fsa;
+};
+
+/* a slab is on the list of its state, the empty ones were reinitialized */
+struct fsa_slab
+{
+    slab_t *full;
+    slab_t *partial;
+    slab_t *empty;
+    size_t block_size;
+    size_t slab_size;
+    size_t page_size;
+    size_t blocks_per_slab;
+    size_t max_empty_slabs;
+    size_t num_slabs;
+    size_t num_empty;
+};
+
+static slab_t *MapSlab(fsa_slab_t *fsa_slab);
+static void UnmapSlabs(slab_t *slab, size_t slab_size);
+static void ResetSlab(fsa_slab_t *fsa_slab, slab_t *slab);
+static void LinkSlab(slab_t **list, slab_t *slab);
+static void UnlinkSlab(slab_t **list, slab_t *slab);
+static size_t RoundUpPowerOfTwo(size_t number);
+
+fsa_slab_t *FSASlabCreate(size_t size_of_block, size_t slab_size,
+                                                    size_t max_empty_slabs)
+{
+    fsa_slab_t *fsa_slab = NULL;
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t fsa_size = FSASuggestSize(0, size_of_block);
+    size_t pool_size = 0;
+
+    assert(0 < size_of_block);
+    assert(0 < slab_size);
+
+    fsa_slab = (fsa_slab_t *) malloc(sizeof(fsa_slab_t));
+    if (NULL == fsa_slab)
+    {
+        return (NULL);
+    }
+
+    fsa_slab->page_size = 0 < page_size ? (size_t) page_size : 4096;
+    if (slab_size < fsa_slab->page_size)
+    {
+        slab_size = fsa_slab->page_size;
+    }
+
+    fsa_slab->slab_size = RoundUpPowerOfTwo(slab_size);
+    fsa_slab->block_size = FSASuggestSize(1, size_of_block) - fsa_size;
+
+    pool_size = fsa_slab->slab_size - SLAB_STRUCT_SIZE;
+    if (0 == fsa_slab->slab_size ||
+                pool_size < fsa_size + fsa_slab->block_size)
+    {
+        free(fsa_slab);
+        return (NULL);
+    }
+
+    fsa_slab->blocks_per_slab = (pool_size - fsa_size) / fsa_slab->block_size;
+    fsa_slab->max_empty_slabs = max_empty_slabs;
+    fsa_slab->full = NULL;
+    fsa_slab->partial = NULL;
+    fsa_slab->empty = NULL;
+    fsa_slab->num_slabs = 0;
+    fsa_slab->num_empty = 0;
+
+    return (fsa_slab);
+}
+
+void FSASlabDestroy(fsa_slab_t *fsa_slab)
+{
+    assert(NULL != fsa_slab);
+
+    UnmapSlabs(fsa_slab->full, fsa_slab->slab_size);
+    UnmapSlabs(fsa_slab->partial, fsa_slab->slab_size);
+    UnmapSlabs(fsa_slab->empty, fsa_slab->slab_size);
+
+    free(fsa_slab);
+}
+
+void *FSASlabAlloc(fsa_slab_t *fsa_slab)
+{
+    slab_t *slab = NULL;
+    void *block = NULL;
+
+    assert(NULL != fsa_slab);
+
+    slab = fsa_slab->partial;
+    if (NULL == slab)
+    {
+        slab = fsa_slab->empty;
+        if (NULL != slab)
+        {
+            UnlinkSlab(&fsa_slab->empty, slab);
+            --fsa_slab->num_empty;
+        }
+        else
+        {
+            slab = MapSlab(fsa_slab);
+            if (NULL == slab)
+            {
+                return (NULL);
+            }
+        }
+
+        LinkSlab(&fsa_slab->partial, slab);
+    }
+
+    block = FSAAlloc(slab->fsa);
+    assert(NULL != block);
+
+    if (0 == FSACountFree(slab->fsa))
+    {
+        UnlinkSlab(&fsa_slab->partial, slab);
+        LinkSlab(&fsa_slab->full, slab);
+    }
+
+    return (block);
+}
+
+void FSASlabFree(fsa_slab_t *fsa_slab, void *block_to_free)
+{
+    slab_t *slab = NULL;
+
+    assert(NULL != fsa_slab);
+    assert(NULL != block_to_free);
+
+    slab = GET_SLAB(fsa_slab, block_to_free);
+
+    assert(fsa_slab->blocks_per_slab > FSACountFree(slab->fsa));
+
+    if (0 == FSACountFree(slab->fsa))
+    {
+        UnlinkSlab(&fsa_slab->full, slab);
+        LinkSlab(&fsa_slab->partial, slab);
+    }
+
+    FSAFree(slab->fsa, block_to_free);
+
+    if (fsa_slab->blocks_per_slab != FSACountFree(slab->fsa))
+    {
+        return;
+    }
+
+    UnlinkSlab(&fsa_slab->partial, slab);
+
+    if (fsa_slab->num_empty == fsa_slab->max_empty_slabs)
+    {
+        --fsa_slab->num_slabs;
+        munmap((void *) slab, fsa_slab->slab_size);
+        return;
+    }
+
+    ResetSlab(fsa_slab, slab);
+    LinkSlab(&fsa_slab->empty, slab);
+    ++fsa_slab->num_empty;
+}
+
+size_t FSASlabBlocksPerSlab(const fsa_slab_t *fsa_slab)
+{
+    assert(NULL != fsa_slab);
+
+    return (fsa_slab->blocks_per_slab);
+}
+
+size_t FSASlabCount(const fsa_slab_t *fsa_slab)
+{
+    assert(NULL != fsa_slab);
+
+    return (fsa_slab->num_slabs);
+}
+
+size_t FSASlabCountEmpty(const fsa_slab_t *fsa_slab)
+{
+    assert(NULL != fsa_slab);
+
+    return (fsa_slab->num_empty);
+}
+
+static slab_t *MapSlab(fsa_slab_t *fsa_slab)
+{
+    slab_t *slab = NULL;
+    char *map = NULL;
+    char *start = NULL;
+    size_t over_size = 2 * fsa_slab->slab_size;
+
+    /* mapped with extra room, then trimmed to start at a multiple */
+    map = (char *) mmap(NULL, over_size, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *) map)
+    {
+        return (NULL);
+    }
+
+    start = (char *) ALIGN_UP((size_t) map, fsa_slab->slab_size);
+
+    if (start != map)
+    {
+        munmap(map, start - map);
+    }
+
+    munmap(start + fsa_slab->slab_size,
+                        (map + over_size) - (start + fsa_slab->slab_size));
+
+    slab = (slab_t *) start;
+    slab->fsa = FSAInit(fsa_slab->block_size, fsa_slab->blocks_per_slab,
+                                                                POOL(slab));
+    ++fsa_slab->num_slabs;
+
+    return (slab);
+}
+
+static void UnmapSlabs(slab_t *slab, size_t slab_size)
+{
+    slab_t *next = NULL;
+
+    while (NULL != slab)
+    {
+        next = slab->next;
+        munmap((void *) slab, slab_size);
+        slab = next;
+    }
+}
+
+/*
+* the pages past the first one are dropped and read as zeros once touched
+* again, the fsa hands its blocks out anew without reading them
+*/
+static void ResetSlab(fsa_slab_t *fsa_slab, slab_t *slab)
+{
+    if (fsa_slab->slab_size > fsa_slab->page_size)
+    {
+        madvise((char *) slab + fsa_slab->page_size,
+                    fsa_slab->slab_size - fsa_slab->page_size, MADV_DONTNEED);
+    }
+
+    slab->fsa = FSAInit(fsa_slab->block_size, fsa_slab->blocks_per_slab,
+                                                                POOL(slab));
+}
+
+static void LinkSlab(slab_t **list, slab_t *slab)
+{
+    slab->prev = NULL;
+    slab->next = *list;
+    if (NULL != slab->next)
+    {
+        slab->next->prev = slab;
+    }
+
+    *list = slab;
+}
+
+static void UnlinkSlab(slab_t **list, slab_t *slab)
+{
+    if (NULL != slab->next)
+    {
+        slab->next->prev = slab->prev;
+    }
+
+    if (NULL != slab->prev)
+    {
+        slab->prev->next = slab->next;
+    }
+    else
+    {
+        *list = slab->next;
+    }
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number && 0 != power)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+*
+* FILENAME : hash_funcs.c
+*
+* DESCRIPTION : Hash functions implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+#include <string.h> /* memcpy, strlen */
+
+#include "hash_funcs.h"
+
+#define WORD_SIZE (sizeof(size_t))
+#define WORD_BITS (WORD_SIZE * CHAR_BIT)
+#define HALF_SHIFT (WORD_BITS / 2)
+#define ROTATE_SHIFT (HALF_SHIFT - 5)
+#define ROTATE_LEFT(WORD) \
+(((WORD) << ROTATE_SHIFT) | ((WORD) >> (WORD_BITS - ROTATE_SHIFT)))
+
+/* the high half drops out where size_t has only 32 bits */
+#define WIDE_CONSTANT(HIGH, LOW) \
+(((size_t) (HIGH) << 16 << 16) | (size_t) (LOW))
+#define MIX_MULTIPLIER_1 WIDE_CONSTANT(0xBF58476DUL, 0x1CE4E5B9UL)
+#define MIX_MULTIPLIER_2 WIDE_CONSTANT(0x94D049BBUL, 0x133111EBUL)
+#define GOLDEN_RATIO WIDE_CONSTANT(0x9E3779B9UL, 0x7F4A7C15UL)
+
+static size_t Mix(size_t word);
+static size_t ReadWord(const unsigned char *bytes, size_t len);
+
+size_t HashWord(size_t word)
+{
+    return (Mix(word));
+}
+
+size_t HashWordSeeded(size_t word, size_t seed)
+{
+    return (Mix(word ^ Mix(seed + GOLDEN_RATIO)));
+}
+
+size_t HashBytes(const void *data, size_t len)
+{
+    return (HashBytesSeeded(data, len, 0));
+}
+
+size_t HashBytesSeeded(const void *data, size_t len, size_t seed)
+{
+    const unsigned char *bytes = NULL;
+    size_t hash = 0;
+    size_t word = 0;
+
+    assert(NULL != data || 0 == len);
+
+    bytes = data;
+    hash = seed ^ (len * GOLDEN_RATIO);
+
+    for (; WORD_SIZE <= len; len -= WORD_SIZE, bytes += WORD_SIZE)
+    {
+        word = ReadWord(bytes, WORD_SIZE);
+        hash = ROTATE_LEFT(hash ^ (word * MIX_MULTIPLIER_1)) * MIX_MULTIPLIER_2;
+    }
+
+    if (0 < len)
+    {
+        word = ReadWord(bytes, len);
+        hash = ROTATE_LEFT(hash ^ (word * MIX_MULTIPLIER_1)) * MIX_MULTIPLIER_2;
+    }
+
+    return (Mix(hash));
+}
+
+size_t HashString(const void *str)
+{
+    assert(NULL != str);
+
+    return (HashBytesSeeded(str, strlen(str), 0));
+}
+
+size_t HashStringSeeded(const void *str, size_t seed)
+{
+    assert(NULL != str);
+
+    return (HashBytesSeeded(str, strlen(str), seed));
+}
+
+static size_t Mix(size_t word)
+{
+    word ^= word >> HALF_SHIFT;
+    word *= MIX_MULTIPLIER_1;
+    word ^= word >> HALF_SHIFT;
+    word *= MIX_MULTIPLIER_2;
+    word ^= word >> HALF_SHIFT;
+
+    return (word);
+}
+
+static size_t ReadWord(const unsigned char *bytes, size_t len)
+{
+    size_t word = 0;
+
+    assert(NULL != bytes);
+    assert(WORD_SIZE >= len);
+
+    /* compiles to a single unaligned load for a whole word */
+    memcpy(&word, bytes, len);
+
+    return (word);
+}
@@ -0,0 +1,557 @@
+/*******************************************************************************
+*
+* FILENAME : hash_snapshot.c
+*
+* DESCRIPTION : Hash snapshot implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L /* fileno, fsync */
+
+#include <assert.h> /* assert */
+#include <fcntl.h> /* open */
+#include <stdio.h> /* fopen, fwrite, fflush, fclose, rename, remove */
+#include <stdlib.h> /* malloc, realloc, free */
+#include <string.h> /* memcmp, memcpy, memset, strlen, strcpy, strcat */
+#include <sys/mman.h> /* mmap, munmap */
+#include <sys/stat.h> /* fstat */
+#include <unistd.h> /* close, fsync */
+
+#include "hash_snapshot.h"
+
+#define WORD_SIZE (sizeof(size_t))
+#define ALIGN(SIZE) (((SIZE) + WORD_SIZE - 1) & ~(WORD_SIZE - 1))
+#define MAGIC "NSRDHTSS"
+#define MAGIC_SIZE (8)
+#define VERSION (1)
+/* a byte order or a word size other than the saver's reads differently */
+#define FORMAT_MARK ((size_t) 0x5A0000UL | (VERSION << 8) | WORD_SIZE)
+#define MIN_SLOTS (8)
+#define INITIAL_CAPACITY (4096)
+#define TMP_SUFFIX ".tmp"
+#define RECORD_HEADER_SIZE (2 * WORD_SIZE)
+#define IS_SLOT_EMPTY(SLOT) (0 == (SLOT)->offset)
+
+enum {SUCCESS, FAILURE};
+
+/* the layout of the file: a header, the slots, then the records */
+typedef struct snapshot_header
+{
+    char magic[MAGIC_SIZE];
+    size_t format;
+    size_t num_slots;
+    size_t num_records;
+    size_t file_size;
+} snapshot_header_t;
+
+typedef struct snapshot_slot
+{
+    size_t hash;
+    size_t offset;
+} snapshot_slot_t;
+
+/* a record is the sizes of its key and value, then both, padded to words */
+typedef struct snapshot_record
+{
+    size_t key_size;
+    size_t value_size;
+} snapshot_record_t;
+
+struct hash_snapshot
+{
+    const snapshot_header_t *header;
+    const snapshot_slot_t *slots;
+    size_t map_size;
+};
+
+typedef struct snapshot_save
+{
+    hash_snapshot_encode_t encode_key;
+    hash_snapshot_encode_t encode_value;
+    void *param;
+    char *records;
+    size_t used;
+    size_t capacity;
+    snapshot_slot_t *entries;
+    size_t num_entries;
+    size_t max_entries;
+} snapshot_save_t;
+
+static int SaveElementAction(void *data, void *param);
+static int AppendEncoded(snapshot_save_t *save, hash_snapshot_encode_t encode,
+                                                const void *data, size_t *size);
+static int Reserve(snapshot_save_t *save, size_t size);
+static snapshot_slot_t *BuildSlots(const snapshot_save_t *save,
+                                                            size_t num_slots);
+static int WriteFile(const char *path, const snapshot_header_t *header,
+                    const snapshot_slot_t *slots, const snapshot_save_t *save);
+static int SyncDirectory(const char *path);
+static int IsValid(const snapshot_header_t *header, size_t map_size);
+static size_t RoundUpPowerOfTwo(size_t number);
+
+int HashSnapshotSave(h_table_t *table, const char *path,
+                                        hash_snapshot_encode_t encode_key,
+                            hash_snapshot_encode_t encode_value, void *param)
+{
+    snapshot_save_t save = {0};
+    snapshot_header_t header = {{0}, 0, 0, 0, 0};
+    snapshot_slot_t *slots = NULL;
+    int status = SUCCESS;
+
+    assert(NULL != table);
+    assert(NULL != path);
+    assert(NULL != encode_key);
+    assert(NULL != encode_value);
+
+    save.encode_key = encode_key;
+    save.encode_value = encode_value;
+    save.param = param;
+    save.max_entries = HashTableSize(table);
+    save.entries = (snapshot_slot_t *) malloc((save.max_entries + 1) *
+                                                    sizeof(snapshot_slot_t));
+
+    if (NULL == save.entries || SUCCESS != Reserve(&save, INITIAL_CAPACITY) ||
+                    0 != HashTableForEach(table, SaveElementAction, &save))
+    {
+        free(save.entries);
+        free(save.records);
+        return (FAILURE);
+    }
+
+    /* at most half full, so a miss ends after a probe or two */
+    memcpy(header.magic, MAGIC, MAGIC_SIZE);
+    header.format = FORMAT_MARK;
+    header.num_slots = RoundUpPowerOfTwo(save.num_entries * 2);
+    header.num_slots = (MIN_SLOTS < header.num_slots) ? header.num_slots :
+                                                                    MIN_SLOTS;
+    header.num_records = save.num_entries;
+    header.file_size = sizeof(snapshot_header_t) +
+                        header.num_slots * sizeof(snapshot_slot_t) + save.used;
+
+    slots = BuildSlots(&save, header.num_slots);
+    status = (NULL != slots) ? WriteFile(path, &header, slots, &save) : FAILURE;
+
+    free(slots);
+    free(save.entries);
+    free(save.records);
+
+    return (status);
+}
+
+hash_snapshot_t *HashSnapshotOpen(const char *path)
+{
+    hash_snapshot_t *snapshot = NULL;
+    struct stat file_stat;
+    void *map = MAP_FAILED;
+    int fd = -1;
+
+    assert(NULL != path);
+
+    fd = open(path, O_RDONLY);
+    if (0 > fd)
+    {
+        return (NULL);
+    }
+
+    if (0 == fstat(fd, &file_stat) &&
+                sizeof(snapshot_header_t) <= (size_t) file_stat.st_size)
+    {
+        map = mmap(NULL, (size_t) file_stat.st_size, PROT_READ, MAP_SHARED,
+                                                                        fd, 0);
+    }
+
+    /* the mapping stays valid without the descriptor */
+    close(fd);
+
+    if (MAP_FAILED == map)
+    {
+        return (NULL);
+    }
+
+    snapshot = (hash_snapshot_t *) malloc(sizeof(hash_snapshot_t));
+    if (NULL == snapshot || !IsValid(map, (size_t) file_stat.st_size))
+    {
+        munmap(map, (size_t) file_stat.st_size);
+        free(snapshot);
+        return (NULL);
+    }
+
+    snapshot->header = map;
+    snapshot->slots = (const snapshot_slot_t *) (snapshot->header + 1);
+    snapshot->map_size = (size_t) file_stat.st_size;
+
+    return (snapshot);
+}
+
+void HashSnapshotClose(hash_snapshot_t *snapshot)
+{
+    assert(NULL != snapshot);
+
+    munmap((void *) snapshot->header, snapshot->map_size);
+    free(snapshot);
+    snapshot = NULL;
+}
+
+const void *HashSnapshotFind(const hash_snapshot_t *snapshot, const void *key,
+                                        size_t key_size, size_t *value_size)
+{
+    const snapshot_record_t *record = NULL;
+    const char *bytes = NULL;
+    size_t mask = 0;
+    size_t hash = 0;
+    size_t idx = 0;
+    size_t probes = 0;
+    size_t offset = 0;
+    size_t remaining = 0;
+
+    assert(NULL != snapshot);
+    assert(NULL != key || 0 == key_size);
+
+    mask = snapshot->header->num_slots - 1;
+    hash = HashBytes(key, key_size);
+    idx = hash & mask;
+
+    for (; probes <= mask && !IS_SLOT_EMPTY(&snapshot->slots[idx]);
+                                            ++probes, idx = (idx + 1) & mask)
+    {
+        if (hash != snapshot->slots[idx].hash)
+        {
+            continue;
+        }
+
+        /* a damaged file must not lead the lookup out of the mapping */
+        offset = snapshot->slots[idx].offset;
+        if (snapshot->map_size - RECORD_HEADER_SIZE < offset ||
+                                                    0 != offset % WORD_SIZE)
+        {
+            return (NULL);
+        }
+
+        bytes = (const char *) snapshot->header + offset;
+        record = (const snapshot_record_t *) bytes;
+        remaining = snapshot->map_size - offset - RECORD_HEADER_SIZE;
+
+        if (key_size != record->key_size)
+        {
+            continue;
+        }
+
+        if (remaining < ALIGN(key_size) ||
+                            remaining - ALIGN(key_size) < record->value_size)
+        {
+            return (NULL);
+        }
+
+        if (0 != key_size &&
+                        0 != memcmp(bytes + RECORD_HEADER_SIZE, key, key_size))
+        {
+            continue;
+        }
+
+        if (NULL != value_size)
+        {
+            *value_size = record->value_size;
+        }
+
+        return (bytes + RECORD_HEADER_SIZE + ALIGN(key_size));
+    }
+
+    return (NULL);
+}
+
+size_t HashSnapshotSize(const hash_snapshot_t *snapshot)
+{
+    assert(NULL != snapshot);
+
+    return (snapshot->header->num_records);
+}
+
+static int SaveElementAction(void *data, void *param)
+{
+    snapshot_save_t *save = param;
+    snapshot_record_t record = {0};
+    snapshot_slot_t *entry = NULL;
+    size_t offset = 0;
+
+    assert(NULL != save);
+    assert(save->num_entries < save->max_entries);
+
+    offset = save->used;
+
+    if (SUCCESS != Reserve(save, RECORD_HEADER_SIZE))
+    {
+        return (FAILURE);
+    }
+
+    save->used += RECORD_HEADER_SIZE;
+
+    if (SUCCESS != AppendEncoded(save, save->encode_key, data,
+                                                        &record.key_size))
+    {
+        return (FAILURE);
+    }
+
+    entry = &save->entries[save->num_entries];
+    entry->hash = HashBytes(save->records + offset + RECORD_HEADER_SIZE,
+                                                            record.key_size);
+    entry->offset = offset;
+
+    if (SUCCESS != AppendEncoded(save, save->encode_value, data,
+                                                        &record.value_size))
+    {
+        return (FAILURE);
+    }
+
+    memcpy(save->records + offset, &record, sizeof(record));
+    ++save->num_entries;
+
+    return (SUCCESS);
+}
+
+static int AppendEncoded(snapshot_save_t *save, hash_snapshot_encode_t encode,
+                                                const void *data, size_t *size)
+{
+    assert(NULL != save);
+    assert(NULL != encode);
+    assert(NULL != size);
+
+    *size = encode(data, save->records + save->used,
+                                    save->capacity - save->used, save->param);
+
+    if (save->capacity - save->used < ALIGN(*size))
+    {
+        if (SUCCESS != Reserve(save, ALIGN(*size)))
+        {
+            return (FAILURE);
+        }
+
+        *size = encode(data, save->records + save->used,
+                                    save->capacity - save->used, save->param);
+        if (save->capacity - save->used < ALIGN(*size))
+        {
+            return (FAILURE);
+        }
+    }
+
+    /* zeroed padding keeps the files of equal tables equal */
+    memset(save->records + save->used + *size, 0, ALIGN(*size) - *size);
+    save->used += ALIGN(*size);
+
+    return (SUCCESS);
+}
+
+static int Reserve(snapshot_save_t *save, size_t size)
+{
+    char *records = NULL;
+    size_t capacity = 0;
+
+    assert(NULL != save);
+
+    if (size <= save->capacity - save->used)
+    {
+        return (SUCCESS);
+    }
+
+    capacity = (0 < save->capacity) ? save->capacity : size;
+    while (capacity - save->used < size)
+    {
+        capacity *= 2;
+    }
+
+    records = (char *) realloc(save->records, capacity);
+    if (NULL == records)
+    {
+        return (FAILURE);
+    }
+
+    save->records = records;
+    save->capacity = capacity;
+
+    return (SUCCESS);
+}
+
+static snapshot_slot_t *BuildSlots(const snapshot_save_t *save,
+                                                            size_t num_slots)
+{
+    snapshot_slot_t *slots = NULL;
+    size_t records_offset = 0;
+    size_t idx = 0;
+    size_t i = 0;
+
+    assert(NULL != save);
+
+    slots = (snapshot_slot_t *) calloc(num_slots, sizeof(snapshot_slot_t));
+    if (NULL == slots)
+    {
+        return (NULL);
+    }
+
+    /* the records follow the slots, so no record lies at offset 0 */
+    records_offset = sizeof(snapshot_header_t) +
+                                        num_slots * sizeof(snapshot_slot_t);
+
+    for (; i < save->num_entries; ++i)
+    {
+        idx = save->entries[i].hash & (num_slots - 1);
+        while (!IS_SLOT_EMPTY(&slots[idx]))
+        {
+            idx = (idx + 1) & (num_slots - 1);
+        }
+
+        slots[idx].hash = save->entries[i].hash;
+        slots[idx].offset = records_offset + save->entries[i].offset;
+    }
+
+    return (slots);
+}
+
+static int WriteFile(const char *path, const snapshot_header_t *header,
+                    const snapshot_slot_t *slots, const snapshot_save_t *save)
+{
+    FILE *file = NULL;
+    char *tmp_path = NULL;
+    int status = SUCCESS;
+
+    assert(NULL != path);
+    assert(NULL != header);
+    assert(NULL != slots);
+    assert(NULL != save);
+
+    tmp_path = (char *) malloc(strlen(path) + sizeof(TMP_SUFFIX));
+    if (NULL == tmp_path)
+    {
+        return (FAILURE);
+    }
+
+    strcpy(tmp_path, path);
+    strcat(tmp_path, TMP_SUFFIX);
+
+    file = fopen(tmp_path, "wb");
+    if (NULL == file)
+    {
+        free(tmp_path);
+        return (FAILURE);
+    }
+
+    if (1 != fwrite(header, sizeof(snapshot_header_t), 1, file) ||
+        header->num_slots != fwrite(slots, sizeof(snapshot_slot_t),
+                                                    header->num_slots, file) ||
+                        save->used != fwrite(save->records, 1, save->used, file))
+    {
+        status = FAILURE;
+    }
+
+    /*
+    * the data reaches the disk before the name does, or a crash may leave a
+    * truncated file under path
+    */
+    if (SUCCESS == status && (0 != fflush(file) || 0 != fsync(fileno(file))))
+    {
+        status = FAILURE;
+    }
+
+    if (0 != fclose(file) || SUCCESS != status || 0 != rename(tmp_path, path))
+    {
+        remove(tmp_path);
+        status = FAILURE;
+    }
+
+    free(tmp_path);
+
+    if (SUCCESS == status)
+    {
+        status = SyncDirectory(path);
+    }
+
+    return (status);
+}
+
+/* makes the rename durable by syncing the directory that holds path */
+static int SyncDirectory(const char *path)
+{
+    const char *runner = NULL;
+    const char *slash = NULL;
+    char *dir_path = NULL;
+    size_t dir_length = 0;
+    int fd = -1;
+    int status = SUCCESS;
+
+    assert(NULL != path);
+
+    for (runner = path; '\0' != *runner; ++runner)
+    {
+        if ('/' == *runner)
+        {
+            slash = runner;
+        }
+    }
+
+    if (NULL == slash)
+    {
+        fd = open(".", O_RDONLY);
+    }
+    else
+    {
+        /* the root directory keeps its slash */
+        dir_length = (slash == path) ? 1 : (size_t) (slash - path);
+
+        dir_path = (char *) malloc(dir_length + 1);
+        if (NULL == dir_path)
+        {
+            return (FAILURE);
+        }
+
+        memcpy(dir_path, path, dir_length);
+        dir_path[dir_length] = '\0';
+
+        fd = open(dir_path, O_RDONLY);
+        free(dir_path);
+    }
+
+    if (0 > fd)
+    {
+        return (FAILURE);
+    }
+
+    if (0 != fsync(fd))
+    {
+        status = FAILURE;
+    }
+
+    close(fd);
+
+    return (status);
+}
+
+static int IsValid(const snapshot_header_t *header, size_t map_size)
+{
+    assert(NULL != header);
+
+    if (0 != memcmp(header->magic, MAGIC, MAGIC_SIZE) ||
+                FORMAT_MARK != header->format || map_size != header->file_size ||
+                0 == header->num_slots ||
+                0 != (header->num_slots & (header->num_slots - 1)) ||
+                (map_size - sizeof(snapshot_header_t)) / sizeof(snapshot_slot_t)
+                                                        < header->num_slots)
+    {
+        return (0);
+    }
+
+    return (1);
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
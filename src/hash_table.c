@@ -3,257 +3,2577 @@
 * FILENAME : hash_table.c
 *
 * DESCRIPTION : Hash table implementation.
-* 
+*
 * AUTHOR : Nick Shenderov
 *
 * DATE : 05.06.2023
-* 
+*
 *******************************************************************************/
 
 #include <assert.h> /* assert */
-#include <stdlib.h> /* malloc, free */
+#include <float.h> /* DBL_MAX */
+#include <pthread.h> /* pthread_create, pthread_join */
+#include <stdlib.h> /* malloc, calloc, free */
+#include <string.h> /* memset */
+
+#ifdef __SSE2__
+#include <emmintrin.h> /* _mm_cmpeq_epi8, _mm_movemask_epi8 */
+#endif
 
-#include "dlist.h"
 #include "hash_table.h"
 
 #define SIZE_OF_HT_STRUCT (sizeof(struct h_table))
-#define COMPUTE_SIZE_OF_BUCKET(SIZE) (sizeof(void *) * SIZE)
-#define COMPUTE_INDEX(TABLE, DATA) (TABLE->hash_func(DATA) % TABLE->num_buckets)
-#define FIND_LIST(TABLE, DATA) (table->bucket[COMPUTE_INDEX(TABLE, DATA)])
+#define HASH_KEY(TABLE, KEY) (HashWord((TABLE)->hash_func(KEY)))
+#define COMPUTE_INDEX(STORE, HASH) (HASH & ((STORE)->num_buckets - 1))
+#define FIND_CHAIN(STORE, HASH) \
+(((ht_node_t **) (STORE)->buckets)[COMPUTE_INDEX(STORE, HASH)])
+
+#define FLAT_MIN_SLOTS (8)
+#define FLAT_MASK(STORE) ((STORE)->num_buckets - 1)
+#define FLAT_HOME(STORE, HASH) (HASH & FLAT_MASK(STORE))
+#define FLAT_DISTANCE(STORE, SLOT, IDX) \
+((IDX - FLAT_HOME(STORE, (SLOT)->hash)) & FLAT_MASK(STORE))
+#define FLAT_NEXT(STORE, IDX) ((IDX + 1) & FLAT_MASK(STORE))
+#define FLAT_MAX_LOAD(NUM_SLOTS) (NUM_SLOTS - (NUM_SLOTS >> 3))
+#define IS_SLOT_EMPTY(SLOT) (NULL == (SLOT)->data)
+#define MIN_SLOTS_FOR(CAPACITY) (CAPACITY + (CAPACITY / 7) + 1)
+
+#define GROUP_WIDTH (16)
+#define CTRL_EMPTY ((unsigned char) 0x80)
+#define CTRL_DELETED ((unsigned char) 0xFE)
+#define IS_CTRL_FULL(CTRL) (0 == ((CTRL) & 0x80))
+#define H1_SHIFT (7)
+#define H1(HASH) ((HASH) >> H1_SHIFT)
+#define H2(HASH) ((unsigned char) ((HASH) & 0x7F))
+#define SWISS_CTRL(STORE) ((unsigned char *) (STORE)->buckets)
+#define SWISS_SLOTS(STORE) \
+((ht_slot_t *) (SWISS_CTRL(STORE) + (STORE)->num_buckets))
+#define SWISS_GROUP_MASK(STORE) ((STORE)->num_buckets / GROUP_WIDTH - 1)
+
+#define CUCKOO_BUCKET_SLOTS (4)
+#define CUCKOO_STASH_SIZE (8)
+#define CUCKOO_MAX_KICKS (128)
+#define CUCKOO_MIN_SLOTS (2 * CUCKOO_BUCKET_SLOTS)
+#define CUCKOO_BUCKET_MASK(STORE) \
+((STORE)->num_buckets / CUCKOO_BUCKET_SLOTS - 1)
+#define CUCKOO_BUCKET(STORE, BUCKET) \
+((ht_slot_t *) (STORE)->buckets + (BUCKET) * CUCKOO_BUCKET_SLOTS)
+#define CUCKOO_STASH(STORE) \
+((ht_slot_t *) (STORE)->buckets + (STORE)->num_buckets)
+
+#define CHAIN_DEFAULT_LOAD_FACTOR (1.0)
+#define CHAIN_LOAD_FACTOR_LIMIT (DBL_MAX)
+#define FLAT_DEFAULT_LOAD_FACTOR (0.875)
+#define FLAT_LOAD_FACTOR_LIMIT (0.875)
+#define SWISS_DEFAULT_LOAD_FACTOR (0.875)
+#define SWISS_LOAD_FACTOR_LIMIT (0.875)
+#define CUCKOO_DEFAULT_LOAD_FACTOR (0.875)
+#define CUCKOO_LOAD_FACTOR_LIMIT (0.95)
+#define BATCH_CHUNK (16)
+#define PREFETCH(ADDR) (__builtin_prefetch(ADDR))
+#define REHASH_STEPS (4)
+#define REHASH_EMPTY_VISITS (REHASH_STEPS * 10)
+#define IS_REHASHING(TABLE) (NULL != (TABLE)->store[OLD].buckets)
+#define HOME_MASK(TABLE, STORE) \
+((STORE)->num_buckets / (TABLE)->ops->home_width - 1)
+#define HOME(TABLE, STORE, HASH) \
+(((HASH) >> (TABLE)->ops->home_shift) & HOME_MASK(TABLE, STORE))
+#define BUILD_MAX_THREADS (8)
+#define BUILD_MIN_ITEMS_PER_THREAD (1 << 15)
+#define BUILD_MAX_PARTS (1 << 10)
+#define BUILD_PART(BUILD, HASH) \
+(HOME((BUILD)->table, &(BUILD)->table->store[NEW], HASH) >> (BUILD)->part_shift)
 
 enum {SUCCESS, FAILURE};
+enum {NEW, OLD};
+enum {PREFETCH_BUCKET, PREFETCH_ENTRY};
 
-struct h_table
+typedef struct ht_node
+{
+    struct ht_node *next;
+    size_t hash;
+    void *data;
+} ht_node_t;
+
+typedef struct ht_slot
+{
+    size_t hash;
+    void *data;
+} ht_slot_t;
+
+typedef struct ht_store
 {
     size_t num_buckets;
+    size_t size;
+    size_t deleted;
+    size_t stashed;
+    void *buckets;
+} ht_store_t;
+
+typedef struct ht_ops
+{
+    int (*create)(ht_store_t *store, size_t num_buckets);
+    void (*destroy)(ht_store_t *store);
+    void *(*find)(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+    int (*insert)(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash);
+    int (*place)(ht_store_t *store, void *data, size_t hash);
+    void *(*remove)(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+    int (*for_each)(ht_store_t *store, h_table_action_t action, void *param);
+    size_t (*migrate)(h_table_t *table, size_t idx);
+    void (*prefetch)(const ht_store_t *store, size_t hash, int level);
+    int (*scan)(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param);
+    size_t home_width;
+    size_t home_shift;
+    double default_load_factor;
+    double load_factor_limit;
+} ht_ops_t;
+
+struct h_table
+{
+    const ht_ops_t *ops;
     h_table_hash_t hash_func;
     h_table_is_match_t is_match;
-    dlist_t **bucket;
+    ht_store_t store[2];
+    size_t rehash_idx;
+    size_t rehash_visits;
+    size_t min_buckets;
+    size_t grow_at;
+    size_t shrink_at;
+    double max_load;
+    double min_load;
+    bloom_filter_t *filter;
+    size_t filter_bits;
+};
+
+typedef struct filter_fill
+{
+    const h_table_t *table;
+    bloom_filter_t *filter;
+} filter_fill_t;
+
+typedef struct ht_build
+{
+    const h_table_t *table;
+    void **items;
+    size_t *hashes;
+    ht_slot_t *sorted;
+    size_t num_parts;
+    size_t part_shift;
+} ht_build_t;
+
+typedef struct ht_build_part
+{
+    ht_build_t *build;
+    size_t *counts;
+    size_t begin;
+    size_t end;
+} ht_build_part_t;
+
+typedef h_table_t *(*ht_create_t)(size_t capacity, h_table_hash_t hash_func,
+                                                h_table_is_match_t is_match);
+
+static h_table_t *CreateTable(const ht_ops_t *ops, size_t num_buckets,
+                        h_table_hash_t hash_func, h_table_is_match_t is_match);
+static void UpdateThresholds(h_table_t *table);
+static void StartResize(h_table_t *table, size_t num_buckets);
+static void Resize(h_table_t *table, size_t num_buckets);
+static void RehashStep(h_table_t *table);
+static int RehashComplete(h_table_t *table);
+static void FinishRehash(h_table_t *table);
+static size_t NextCursor(size_t cursor, size_t mask);
+static int FillFilter(h_table_t *table, size_t capacity, size_t bits);
+static int AddToFilterAction(void *data, void *param);
+static int SortItems(h_table_t *table, void **items, size_t n,
+                                                            ht_slot_t *sorted);
+static void RunParts(ht_build_part_t *parts, size_t num_parts,
+                                                    void *(*routine)(void *));
+static void *CountPart(void *part);
+static void *ScatterPart(void *part);
+static int FillTable(h_table_t *table, const ht_slot_t *sorted, size_t n,
+                                                                int is_unique);
+
+static int ChainCreate(ht_store_t *store, size_t num_buckets);
+static void ChainDestroy(ht_store_t *store);
+static void *ChainFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int ChainInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash);
+static int ChainPlace(ht_store_t *store, void *data, size_t hash);
+static void *ChainRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int ChainForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param);
+static size_t ChainMigrate(h_table_t *table, size_t idx);
+static void ChainPrefetch(const ht_store_t *store, size_t hash, int level);
+static int ChainScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param);
+static ht_node_t **ChainLookup(const h_table_t *table, ht_node_t **bucket,
+                                                const void *key, size_t hash);
+
+static int FlatCreate(ht_store_t *store, size_t num_buckets);
+static void FlatDestroy(ht_store_t *store);
+static void *FlatFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int FlatInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash);
+static int FlatPlace(ht_store_t *store, void *data, size_t hash);
+static void *FlatRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int FlatForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param);
+static size_t FlatMigrate(h_table_t *table, size_t idx);
+static void FlatPrefetch(const ht_store_t *store, size_t hash, int level);
+static int FlatScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param);
+static size_t FlatLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash);
+static void FlatErase(ht_store_t *store, size_t idx);
+
+static int SwissCreate(ht_store_t *store, size_t num_buckets);
+static void SwissDestroy(ht_store_t *store);
+static void *SwissFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int SwissInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash);
+static void *SwissRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int SwissForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param);
+static size_t SwissMigrate(h_table_t *table, size_t idx);
+static void SwissPrefetch(const ht_store_t *store, size_t hash, int level);
+static int SwissScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param);
+static size_t SwissLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash);
+static int SwissPlace(ht_store_t *store, void *data, size_t hash);
+static void SwissErase(ht_store_t *store, size_t idx);
+static unsigned int GroupMatch(const unsigned char *group, unsigned char ctrl);
+static unsigned int GroupMatchFree(const unsigned char *group);
+
+static int CuckooCreate(ht_store_t *store, size_t num_buckets);
+static void CuckooDestroy(ht_store_t *store);
+static void *CuckooFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int CuckooInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash);
+static void *CuckooRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash);
+static int CuckooForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param);
+static size_t CuckooMigrate(h_table_t *table, size_t idx);
+static void CuckooPrefetch(const ht_store_t *store, size_t hash, int level);
+static int CuckooScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param);
+static ht_slot_t *CuckooLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash);
+static int CuckooPlace(ht_store_t *store, void *data, size_t hash);
+static size_t CuckooMoveSlot(h_table_t *table, ht_slot_t *slot, int is_stashed);
+static void CuckooBuckets(const ht_store_t *store, size_t hash, size_t *first,
+                                                                size_t *second);
+static ht_slot_t *FindFreeSlot(ht_slot_t *slots, size_t num_slots);
+
+static size_t RoundUpPowerOfTwo(size_t number);
+
+static const ht_ops_t g_chain_ops =
+{
+    ChainCreate, ChainDestroy, ChainFind, ChainInsert, ChainPlace, ChainRemove,
+    ChainForEach, ChainMigrate, ChainPrefetch, ChainScan, 1, 0,
+    CHAIN_DEFAULT_LOAD_FACTOR, CHAIN_LOAD_FACTOR_LIMIT
+};
+
+static const ht_ops_t g_flat_ops =
+{
+    FlatCreate, FlatDestroy, FlatFind, FlatInsert, FlatPlace, FlatRemove,
+    FlatForEach, FlatMigrate, FlatPrefetch, FlatScan, 1, 0,
+    FLAT_DEFAULT_LOAD_FACTOR, FLAT_LOAD_FACTOR_LIMIT
+};
+
+static const ht_ops_t g_swiss_ops =
+{
+    SwissCreate, SwissDestroy, SwissFind, SwissInsert, SwissPlace, SwissRemove,
+    SwissForEach, SwissMigrate, SwissPrefetch, SwissScan, GROUP_WIDTH, H1_SHIFT,
+    SWISS_DEFAULT_LOAD_FACTOR, SWISS_LOAD_FACTOR_LIMIT
+};
+
+static const ht_ops_t g_cuckoo_ops =
+{
+    CuckooCreate, CuckooDestroy, CuckooFind, CuckooInsert, CuckooPlace,
+    CuckooRemove, CuckooForEach, CuckooMigrate, CuckooPrefetch, CuckooScan,
+    CUCKOO_BUCKET_SLOTS, 0,
+    CUCKOO_DEFAULT_LOAD_FACTOR, CUCKOO_LOAD_FACTOR_LIMIT
 };
 
-static void CreateBuckets(h_table_t *table);
-static void DestroyBuckets(h_table_t *table);
+/* indexed by the table kind of the HashTableCreateFrom flags */
+static const ht_create_t g_creators[] =
+{
+    HashTableCreate, HashTableCreateFlat, HashTableCreateSwiss,
+    HashTableCreateCuckoo
+};
 
 h_table_t *HashTableCreate(size_t table_size, h_table_hash_t hash_func,
                                             h_table_is_match_t is_match)
 {
-    h_table_t *new_ht = NULL;
-
     assert(NULL != hash_func);
     assert(NULL != is_match);
     assert(0 < table_size);
 
-    new_ht =
-    (h_table_t *) malloc(SIZE_OF_HT_STRUCT + COMPUTE_SIZE_OF_BUCKET(table_size));
+    table_size = RoundUpPowerOfTwo(table_size);
 
-    new_ht->hash_func = hash_func;
-    new_ht->is_match = is_match;
-    new_ht->num_buckets = table_size;
-    new_ht->bucket = (dlist_t **) (new_ht + 1);
+    return (CreateTable(&g_chain_ops, table_size, hash_func, is_match));
+}
 
-    CreateBuckets(new_ht);
+h_table_t *HashTableCreateFlat(size_t capacity, h_table_hash_t hash_func,
+                                                h_table_is_match_t is_match)
+{
+    size_t num_slots = 0;
 
-    return (new_ht);
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+    assert(0 < capacity);
+
+    num_slots = RoundUpPowerOfTwo(MIN_SLOTS_FOR(capacity));
+    if (FLAT_MIN_SLOTS > num_slots)
+    {
+        num_slots = FLAT_MIN_SLOTS;
+    }
+
+    return (CreateTable(&g_flat_ops, num_slots, hash_func, is_match));
+}
+
+h_table_t *HashTableCreateSwiss(size_t capacity, h_table_hash_t hash_func,
+                                                h_table_is_match_t is_match)
+{
+    size_t num_slots = 0;
+
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+    assert(0 < capacity);
+
+    num_slots = RoundUpPowerOfTwo(MIN_SLOTS_FOR(capacity));
+    if (GROUP_WIDTH > num_slots)
+    {
+        num_slots = GROUP_WIDTH;
+    }
+
+    return (CreateTable(&g_swiss_ops, num_slots, hash_func, is_match));
+}
+
+h_table_t *HashTableCreateCuckoo(size_t capacity, h_table_hash_t hash_func,
+                                                h_table_is_match_t is_match)
+{
+    size_t num_slots = 0;
+
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+    assert(0 < capacity);
+
+    num_slots = RoundUpPowerOfTwo(MIN_SLOTS_FOR(capacity));
+    if (CUCKOO_MIN_SLOTS > num_slots)
+    {
+        num_slots = CUCKOO_MIN_SLOTS;
+    }
+
+    return (CreateTable(&g_cuckoo_ops, num_slots, hash_func, is_match));
+}
+
+h_table_t *HashTableCreateFrom(void **items, size_t n, h_table_hash_t hash_func,
+                                        h_table_is_match_t is_match, int flags)
+{
+    h_table_t *table = NULL;
+    ht_slot_t *sorted = NULL;
+    int status = SUCCESS;
+
+    assert(NULL != items || 0 == n);
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+
+    table = g_creators[flags & HT_FROM_KIND_MASK]((0 < n) ? n : 1, hash_func,
+                                                                    is_match);
+    if (NULL == table || 0 == n)
+    {
+        return (table);
+    }
+
+    sorted = (ht_slot_t *) malloc(n * sizeof(ht_slot_t));
+    if (NULL == sorted)
+    {
+        HashTableDestroy(table);
+        return (NULL);
+    }
+
+    status = SortItems(table, items, n, sorted);
+    if (SUCCESS == status)
+    {
+        status = FillTable(table, sorted, n, 0 != (flags & HT_FROM_UNIQUE));
+    }
+
+    free(sorted);
+
+    if (SUCCESS != status)
+    {
+        HashTableDestroy(table);
+        return (NULL);
+    }
+
+    return (table);
 }
 
 void HashTableDestroy(h_table_t *table)
 {
     assert(NULL != table);
 
-    DestroyBuckets(table);
+    table->ops->destroy(&table->store[NEW]);
+
+    if (IS_REHASHING(table))
+    {
+        table->ops->destroy(&table->store[OLD]);
+    }
+
+    HashTableDetachFilter(table);
 
     free(table);
     table = NULL;
 }
 
+int HashTableSetLoadFactor(h_table_t *table, double max_load, double min_load)
+{
+    assert(NULL != table);
+
+    if (0 >= max_load || table->ops->load_factor_limit < max_load ||
+                                    0 > min_load || max_load <= min_load * 2)
+    {
+        return (FAILURE);
+    }
+
+    table->max_load = max_load;
+    table->min_load = min_load;
+
+    UpdateThresholds(table);
+
+    return (SUCCESS);
+}
+
 void *HashTableFind(h_table_t *table, void *key)
 {
-    dlist_t *founded_list = NULL;
-    dlist_iterator_t list_begin = NULL;
-    dlist_iterator_t list_end = NULL;
-    dlist_iterator_t founded_item = NULL;
+    void *data = NULL;
+    size_t hash = 0;
 
     assert(NULL != table);
     assert(NULL != key);
 
-    founded_list = FIND_LIST(table, key);
+    hash = HASH_KEY(table, key);
 
-    list_begin = DListBegin(founded_list);
-    list_end = DListEnd(founded_list);
-
-    founded_item =
-    DListFind(list_begin,list_end, (dlist_is_match_func_t) table->is_match,key);
+    if (IS_REHASHING(table))
+    {
+        RehashStep(table);
+    }
 
-    if (DListIsSameIterator(founded_item, list_end))
+    if (NULL != table->filter && !BloomFilterMayContain(table->filter, hash))
     {
         return (NULL);
     }
 
-    if (!DListIsSameIterator(founded_item, list_begin))
+    data = table->ops->find(table, &table->store[NEW], key, hash);
+
+    if (NULL == data && IS_REHASHING(table))
+    {
+        data = table->ops->find(table, &table->store[OLD], key, hash);
+    }
+
+    return (data);
+}
+
+size_t HashTableFindBatch(h_table_t *table, void **keys, size_t n, void **out)
+{
+    size_t hashes[BATCH_CHUNK] = {0};
+    int may_contain[BATCH_CHUNK] = {0};
+    ht_store_t *store = NULL;
+    size_t chunk = 0;
+    size_t founded = 0;
+    size_t i = 0;
+
+    assert(NULL != table);
+    assert(NULL != keys || 0 == n);
+    assert(NULL != out || 0 == n);
+
+    for (; 0 < n; n -= chunk, keys += chunk, out += chunk)
     {
-        DListSplice(list_begin, founded_item, DListNext(founded_item));
+        chunk = (BATCH_CHUNK < n) ? BATCH_CHUNK : n;
+
+        if (IS_REHASHING(table))
+        {
+            RehashStep(table);
+        }
+
+        store = &table->store[NEW];
+
+        /*
+        * every stage touches memory the previous one asked for, so the
+        * cache misses of independent keys overlap instead of adding up
+        */
+        for (i = 0; i < chunk; ++i)
+        {
+            hashes[i] = HASH_KEY(table, keys[i]);
+            may_contain[i] = (NULL == table->filter ||
+                            BloomFilterMayContain(table->filter, hashes[i]));
+
+            if (may_contain[i])
+            {
+                table->ops->prefetch(store, hashes[i], PREFETCH_BUCKET);
+            }
+        }
+
+        for (i = 0; i < chunk; ++i)
+        {
+            if (may_contain[i])
+            {
+                table->ops->prefetch(store, hashes[i], PREFETCH_ENTRY);
+            }
+        }
+
+        for (i = 0; i < chunk; ++i)
+        {
+            out[i] = NULL;
+            if (!may_contain[i])
+            {
+                continue;
+            }
+
+            out[i] = table->ops->find(table, store, keys[i], hashes[i]);
+
+            if (NULL == out[i] && IS_REHASHING(table))
+            {
+                out[i] = table->ops->find(table, &table->store[OLD], keys[i],
+                                                                    hashes[i]);
+            }
+
+            founded += (NULL != out[i]);
+        }
     }
 
-    return (DListGetData(founded_item));
+    return (founded);
 }
 
 int HashTableInsert(h_table_t *table, void *data)
 {
-    dlist_t *list_to_insert_to = NULL;
-    dlist_iterator_t list_begin = NULL;
-    dlist_iterator_t list_end = NULL;
-    dlist_iterator_t founded_item = NULL;
+    size_t hash = 0;
+    size_t num_buckets = 0;
+    int status = SUCCESS;
 
     assert(NULL != table);
     assert(NULL != data);
 
-    list_to_insert_to = FIND_LIST(table, data);
+    hash = HASH_KEY(table, data);
 
-    list_begin = DListBegin(list_to_insert_to);
-    list_end = DListEnd(list_to_insert_to);
+    if (IS_REHASHING(table))
+    {
+        RehashStep(table);
+    }
 
-    founded_item =
-    DListFind(list_begin,list_end, (dlist_is_match_func_t)table->is_match,data);
-    
-    if (DListIsSameIterator(founded_item, list_end))
+    if (table->grow_at <= HashTableSize(table) + table->store[NEW].deleted)
     {
-        if(DListIsSameIterator(DListPushBack(list_to_insert_to,data), list_end))
+        /* tombstones alone only call for rebuilding at the same size */
+        num_buckets = table->store[NEW].num_buckets;
+        if (table->grow_at <= HashTableSize(table))
         {
-            return (FAILURE);
+            num_buckets *= 2;
         }
+
+        /* the steps have drained the old store by the time grow_at is hit */
+        assert(!IS_REHASHING(table));
+        Resize(table, num_buckets);
     }
-    else
+
+    status = table->ops->insert(table, &table->store[NEW], data, hash);
+
+    /*
+    * the cuckoo store may run out of places before reaching its load, but
+    * well below it only too many equal hashes get there and growing is futile
+    */
+    if (SUCCESS != status && table->grow_at <= HashTableSize(table) * 2)
     {
-        DListSetData(founded_item, data);
+        Resize(table, table->store[NEW].num_buckets * 2);
+        status = table->ops->insert(table, &table->store[NEW], data, hash);
     }
 
-    return (SUCCESS);
+    /* the old copy goes only once the new one is in, so failure loses none */
+    if (SUCCESS == status && IS_REHASHING(table))
+    {
+        table->ops->remove(table, &table->store[OLD], data, hash);
+    }
+
+    if (SUCCESS == status && NULL != table->filter)
+    {
+        BloomFilterAdd(table->filter, hash);
+    }
+
+    return (status);
 }
 
 void HashTableRemove(h_table_t *table, void *key)
 {
-    dlist_t *founded_list = NULL;
-    dlist_iterator_t list_begin = NULL;
-    dlist_iterator_t list_end = NULL;
-    dlist_iterator_t founded_item = NULL;
+    void *removed = NULL;
+    size_t hash = 0;
 
     assert(NULL != table);
     assert(NULL != key);
 
-    founded_list = FIND_LIST(table, key);
+    hash = HASH_KEY(table, key);
 
-    list_begin = DListBegin(founded_list);
-    list_end = DListEnd(founded_list);
+    if (IS_REHASHING(table))
+    {
+        RehashStep(table);
+    }
 
-    founded_item =
-    DListFind(list_begin, list_end, (dlist_is_match_func_t)table->is_match,key);
+    removed = table->ops->remove(table, &table->store[NEW], key, hash);
 
-    if (DListIsSameIterator(founded_item, list_end))
+    if (NULL == removed && IS_REHASHING(table))
     {
-        return;
+        removed = table->ops->remove(table, &table->store[OLD], key, hash);
     }
-    else
+
+    if (NULL != removed && !IS_REHASHING(table) &&
+                                    table->shrink_at > HashTableSize(table) &&
+                        table->min_buckets <= table->store[NEW].num_buckets / 2)
     {
-        DListRemove(founded_item);
+        StartResize(table, table->store[NEW].num_buckets / 2);
     }
-
 }
 
 size_t HashTableSize(const h_table_t *table)
 {
-    size_t table_size = 0;
-    size_t counter = 0;
-    size_t i = 0;
-
     assert(NULL != table);
 
-    table_size = table->num_buckets;
-    
-    for (; i < table_size; ++i)
-    {
-        counter += DListSize(table->bucket[i]);
-    }
-
-    return (counter);
+    return (table->store[NEW].size + table->store[OLD].size);
 }
 
 int HashTableIsEmpty(const h_table_t *table)
 {
-    size_t table_size = table->num_buckets;
-    size_t i = 0;
-    int flag = 1;
-
     assert(NULL != table);
 
-    for (; i < table_size && flag; ++i)
-    {
-        flag = DListIsEmpty(table->bucket[i]);
-    }
-
-    return (flag);
+    return (0 == HashTableSize(table));
 }
 
 int HashTableForEach(h_table_t *table, h_table_action_t action, void *param)
 {
-    dlist_t *founded_list = NULL;
-    dlist_iterator_t list_begin = NULL;
-    dlist_iterator_t list_end = NULL;
-    size_t table_size = 0;
-    size_t i = 0;
     int status = 0;
 
     assert(NULL != table);
     assert(NULL != action);
 
-    table_size = table->num_buckets;
+    status = table->ops->for_each(&table->store[NEW], action, param);
 
-    for (;i < table_size && 0 == status; ++i)
+    if (0 == status && IS_REHASHING(table))
     {
-        founded_list = table->bucket[i];
-        list_begin = DListBegin(founded_list);
-        list_end = DListEnd(founded_list);
-        status = DListForEach(list_begin, list_end, action, param);
+        status = table->ops->for_each(&table->store[OLD], action, param);
     }
 
     return (status);
 }
 
-static void CreateBuckets(h_table_t *table)
+size_t HashTableScan(h_table_t *table, size_t cursor, size_t batch,
+                                        h_table_action_t action, void *param)
 {
-    size_t i = 0;
-    size_t table_size = 0;
-    dlist_t *new_list = NULL;
+    ht_store_t *small = NULL;
+    ht_store_t *large = NULL;
+    ht_store_t *tmp = NULL;
+    size_t small_mask = 0;
+    size_t large_mask = 0;
+    int status = 0;
 
     assert(NULL != table);
+    assert(NULL != action);
+    assert(0 < batch);
+
+    small = &table->store[NEW];
+
+    if (IS_REHASHING(table))
+    {
+        large = &table->store[OLD];
+
+        if (HOME_MASK(table, small) > HOME_MASK(table, large))
+        {
+            tmp = small;
+            small = large;
+            large = tmp;
+        }
+
+        large_mask = HOME_MASK(table, large);
+    }
 
-    table_size = table->num_buckets;
+    small_mask = HOME_MASK(table, small);
 
-    for (; i < table_size; ++i)
+    /*
+    * the cursor counts with its bits reversed, so the buckets already visited
+    * in a table of any other power of two size are exactly the ones that
+    * share their low bits with the visited buckets of this one
+    */
+    do
     {
-        new_list = DListCreate();
+        status |= table->ops->scan(table, small, cursor & small_mask, action,
+                                                                        param);
 
-        if (NULL == new_list)
+        /* every bucket of the larger table that folds into the small one */
+        if (NULL != large)
         {
-            table->num_buckets = i;
-            HashTableDestroy(table);
-            return;
+            do
+            {
+                status |= table->ops->scan(table, large, cursor & large_mask,
+                                                                action, param);
+
+                cursor = (((cursor | small_mask) + 1) & ~small_mask) |
+                                                        (cursor & small_mask);
+            }
+            while (0 != (cursor & (small_mask ^ large_mask)));
         }
 
-        table->bucket[i] = new_list;
+        cursor = NextCursor(cursor, small_mask);
+        --batch;
+    }
+    while (0 != cursor && 0 < batch && 0 == status);
+
+    return (cursor);
+}
+
+int HashTableAttachFilter(h_table_t *table, size_t capacity,
+                                                    size_t bits_per_element)
+{
+    assert(NULL != table);
+    assert(0 < bits_per_element);
+
+    if (capacity < HashTableSize(table))
+    {
+        capacity = HashTableSize(table);
+    }
+
+    return (FillFilter(table, capacity, bits_per_element));
+}
+
+int HashTableRebuildFilter(h_table_t *table)
+{
+    size_t capacity = 0;
+
+    assert(NULL != table);
+    assert(NULL != table->filter);
+
+    /* a table that outgrew its filter gets a larger one */
+    capacity = BloomFilterCapacity(table->filter);
+    if (capacity < HashTableSize(table))
+    {
+        capacity = HashTableSize(table);
+    }
+
+    return (FillFilter(table, capacity, table->filter_bits));
+}
+
+void HashTableDetachFilter(h_table_t *table)
+{
+    assert(NULL != table);
+
+    if (NULL != table->filter)
+    {
+        BloomFilterDestroy(table->filter);
+        table->filter = NULL;
+    }
+}
+
+/******************************** Filtering ***********************************/
+
+static int FillFilter(h_table_t *table, size_t capacity, size_t bits)
+{
+    filter_fill_t fill = {NULL, NULL};
+
+    assert(NULL != table);
+
+    fill.table = table;
+    fill.filter = BloomFilterCreate(capacity, bits);
+    if (NULL == fill.filter)
+    {
+        return (FAILURE);
     }
+
+    HashTableForEach(table, AddToFilterAction, &fill);
+
+    /* the old filter stays in use until the new one is complete */
+    HashTableDetachFilter(table);
+    table->filter = fill.filter;
+    table->filter_bits = bits;
+
+    return (SUCCESS);
+}
+
+static int AddToFilterAction(void *data, void *param)
+{
+    filter_fill_t *fill = param;
+
+    assert(NULL != fill);
+
+    BloomFilterAdd(fill->filter, HASH_KEY(fill->table, data));
+
+    return (SUCCESS);
 }
 
-static void DestroyBuckets(h_table_t *table)
+/******************************* Bulk building ********************************/
+
+static int SortItems(h_table_t *table, void **items, size_t n,
+                                                            ht_slot_t *sorted)
 {
+    ht_build_part_t parts[BUILD_MAX_THREADS];
+    ht_build_t build = {0};
+    size_t *counts = NULL;
+    size_t num_threads = 0;
+    size_t num_homes = 0;
+    size_t offset = 0;
+    size_t part = 0;
     size_t i = 0;
-    size_t table_size = 0;
 
     assert(NULL != table);
+    assert(NULL != items);
+    assert(NULL != sorted);
+
+    num_threads = n / BUILD_MIN_ITEMS_PER_THREAD;
+    num_threads = (BUILD_MAX_THREADS < num_threads) ? BUILD_MAX_THREADS :
+                                                                num_threads;
+    num_threads = (0 < num_threads) ? num_threads : 1;
+
+    /* every part is a run of adjacent home buckets */
+    num_homes = HOME_MASK(table, &table->store[NEW]) + 1;
+    build.num_parts = (BUILD_MAX_PARTS < num_homes) ? BUILD_MAX_PARTS :
+                                                                    num_homes;
+    while (build.num_parts < (num_homes >> build.part_shift))
+    {
+        ++build.part_shift;
+    }
+
+    build.table = table;
+    build.items = items;
+    build.sorted = sorted;
+    build.hashes = (size_t *) malloc(n * sizeof(size_t));
+    counts = (size_t *) calloc(num_threads * build.num_parts, sizeof(size_t));
+    if (NULL == build.hashes || NULL == counts)
+    {
+        free(build.hashes);
+        free(counts);
+        return (FAILURE);
+    }
+
+    for (i = 0; i < num_threads; ++i)
+    {
+        parts[i].build = &build;
+        parts[i].counts = counts + i * build.num_parts;
+        parts[i].begin = n / num_threads * i;
+        parts[i].end = (i + 1 < num_threads) ? n / num_threads * (i + 1) : n;
+    }
 
-    table_size = table->num_buckets;
+    RunParts(parts, num_threads, CountPart);
 
-    for (; i < table_size; ++i)
+    /* a stable counting sort, every thread scatters from its own offsets */
+    for (part = 0; part < build.num_parts; ++part)
     {
-        DListDestroy(table->bucket[i]);
+        for (i = 0; i < num_threads; ++i)
+        {
+            offset += parts[i].counts[part];
+            parts[i].counts[part] = offset - parts[i].counts[part];
+        }
     }
-}
\ No newline at end of file
+
+    RunParts(parts, num_threads, ScatterPart);
+
+    free(build.hashes);
+    free(counts);
+
+    return (SUCCESS);
+}
+
+static void RunParts(ht_build_part_t *parts, size_t num_parts,
+                                                    void *(*routine)(void *))
+{
+    pthread_t threads[BUILD_MAX_THREADS];
+    int is_started[BUILD_MAX_THREADS] = {0};
+    size_t i = 1;
+
+    assert(NULL != parts);
+    assert(BUILD_MAX_THREADS >= num_parts);
+
+    for (; i < num_parts; ++i)
+    {
+        is_started[i] = (0 == pthread_create(&threads[i], NULL, routine,
+                                                                &parts[i]));
+    }
+
+    routine(&parts[0]);
+
+    /* a part without a thread is done by the caller instead */
+    for (i = 1; i < num_parts; ++i)
+    {
+        if (is_started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            routine(&parts[i]);
+        }
+    }
+}
+
+static void *CountPart(void *part)
+{
+    ht_build_part_t *build_part = part;
+    ht_build_t *build = NULL;
+    size_t i = 0;
+
+    assert(NULL != build_part);
+
+    build = build_part->build;
+
+    for (i = build_part->begin; i < build_part->end; ++i)
+    {
+        build->hashes[i] = HASH_KEY(build->table, build->items[i]);
+        ++build_part->counts[BUILD_PART(build, build->hashes[i])];
+    }
+
+    return (NULL);
+}
+
+static void *ScatterPart(void *part)
+{
+    ht_build_part_t *build_part = part;
+    ht_build_t *build = NULL;
+    ht_slot_t *slot = NULL;
+    size_t i = 0;
+
+    assert(NULL != build_part);
+
+    build = build_part->build;
+
+    for (i = build_part->begin; i < build_part->end; ++i)
+    {
+        slot = &build->sorted[build_part->counts[BUILD_PART(build,
+                                                        build->hashes[i])]++];
+        slot->hash = build->hashes[i];
+        slot->data = build->items[i];
+    }
+
+    return (NULL);
+}
+
+static int FillTable(h_table_t *table, const ht_slot_t *sorted, size_t n,
+                                                                int is_unique)
+{
+    ht_store_t *store = NULL;
+    size_t i = 0;
+    int status = SUCCESS;
+
+    assert(NULL != table);
+    assert(NULL != sorted);
+
+    store = &table->store[NEW];
+
+    for (; i < n && SUCCESS == status; ++i)
+    {
+        status = FAILURE;
+
+        if (!IS_REHASHING(table))
+        {
+            status = is_unique ?
+                    table->ops->place(store, sorted[i].data, sorted[i].hash) :
+                    table->ops->insert(table, store, sorted[i].data,
+                                                            sorted[i].hash);
+        }
+
+        /* only a cuckoo table may run out of places, it grows then */
+        if (SUCCESS != status)
+        {
+            status = HashTableInsert(table, sorted[i].data);
+        }
+    }
+
+    return (status);
+}
+
+/********************************* Resizing ***********************************/
+
+static h_table_t *CreateTable(const ht_ops_t *ops, size_t num_buckets,
+                        h_table_hash_t hash_func, h_table_is_match_t is_match)
+{
+    h_table_t *new_ht = NULL;
+
+    assert(NULL != ops);
+
+    new_ht = (h_table_t *) malloc(SIZE_OF_HT_STRUCT);
+    if (NULL == new_ht)
+    {
+        return (NULL);
+    }
+
+    if (SUCCESS != ops->create(&new_ht->store[NEW], num_buckets))
+    {
+        free(new_ht);
+        return (NULL);
+    }
+
+    new_ht->store[OLD].num_buckets = 0;
+    new_ht->store[OLD].size = 0;
+    new_ht->store[OLD].deleted = 0;
+    new_ht->store[OLD].stashed = 0;
+    new_ht->store[OLD].buckets = NULL;
+
+    new_ht->ops = ops;
+    new_ht->hash_func = hash_func;
+    new_ht->is_match = is_match;
+    new_ht->rehash_idx = 0;
+    new_ht->rehash_visits = 0;
+    new_ht->min_buckets = num_buckets;
+    new_ht->max_load = ops->default_load_factor;
+    new_ht->min_load = 0;
+    new_ht->filter = NULL;
+    new_ht->filter_bits = 0;
+
+    UpdateThresholds(new_ht);
+
+    return (new_ht);
+}
+
+static void UpdateThresholds(h_table_t *table)
+{
+    double num_buckets = 0;
+    size_t headroom = 1;
+
+    assert(NULL != table);
+
+    num_buckets = (double) table->store[NEW].num_buckets;
+
+    table->grow_at = (size_t) (table->max_load * num_buckets);
+    table->shrink_at = (size_t) (table->min_load * num_buckets);
+
+    if (!IS_REHASHING(table))
+    {
+        return;
+    }
+
+    /*
+    * every operation grows the size by one at most, so spreading the rest of
+    * the old buckets over the operations left before grow_at drains the old
+    * store before another resize may start
+    */
+    if (HashTableSize(table) < table->grow_at)
+    {
+        headroom = table->grow_at - HashTableSize(table);
+    }
+
+    table->rehash_visits = (table->store[OLD].num_buckets - table->rehash_idx
+                                                + headroom - 1) / headroom;
+}
+
+static void StartResize(h_table_t *table, size_t num_buckets)
+{
+    ht_store_t old_store = {0};
+
+    assert(NULL != table);
+    assert(!IS_REHASHING(table));
+
+    old_store = table->store[NEW];
+
+    /* on allocation failure the table just keeps its current buckets */
+    if (SUCCESS != table->ops->create(&table->store[NEW], num_buckets))
+    {
+        table->store[NEW] = old_store;
+        return;
+    }
+
+    table->store[OLD] = old_store;
+    table->rehash_idx = 0;
+
+    UpdateThresholds(table);
+
+    if (0 == old_store.size)
+    {
+        FinishRehash(table);
+    }
+}
+
+static void Resize(h_table_t *table, size_t num_buckets)
+{
+    assert(NULL != table);
+
+    /*
+    * the steps drain the old store before grow_at is reached, so only a
+    * cuckoo store out of places gets here while rehashing. A rehash that
+    * can not be completed keeps the current stores
+    */
+    if (IS_REHASHING(table) && SUCCESS != RehashComplete(table))
+    {
+        return;
+    }
+
+    StartResize(table, num_buckets);
+}
+
+static void RehashStep(h_table_t *table)
+{
+    ht_store_t *old_store = NULL;
+    size_t steps = REHASH_STEPS;
+    size_t empty_visits = REHASH_EMPTY_VISITS;
+
+    assert(NULL != table);
+    assert(IS_REHASHING(table));
+
+    old_store = &table->store[OLD];
+
+    /* either limit alone lets at least rehash_visits buckets be visited */
+    if (steps < table->rehash_visits)
+    {
+        steps = table->rehash_visits;
+    }
+
+    if (empty_visits < table->rehash_visits)
+    {
+        empty_visits = table->rehash_visits;
+    }
+
+    while (0 < steps && 0 < empty_visits && 0 < old_store->size)
+    {
+        if (0 == table->ops->migrate(table, table->rehash_idx))
+        {
+            --empty_visits;
+        }
+        else
+        {
+            --steps;
+        }
+
+        table->rehash_idx = (table->rehash_idx + 1) % old_store->num_buckets;
+    }
+
+    if (0 == old_store->size)
+    {
+        FinishRehash(table);
+    }
+}
+
+static int RehashComplete(h_table_t *table)
+{
+    ht_store_t *old_store = NULL;
+    size_t idle_visits = 0;
+
+    assert(NULL != table);
+    assert(IS_REHASHING(table));
+
+    old_store = &table->store[OLD];
+
+    while (0 < old_store->size)
+    {
+        if (0 != table->ops->migrate(table, table->rehash_idx))
+        {
+            idle_visits = 0;
+        }
+        else if (old_store->num_buckets <= ++idle_visits)
+        {
+            /* a whole round without progress, the new store is out of places */
+            return (FAILURE);
+        }
+
+        table->rehash_idx = (table->rehash_idx + 1) % old_store->num_buckets;
+    }
+
+    FinishRehash(table);
+
+    return (SUCCESS);
+}
+
+static void FinishRehash(h_table_t *table)
+{
+    assert(NULL != table);
+
+    table->ops->destroy(&table->store[OLD]);
+
+    table->store[OLD].num_buckets = 0;
+    table->store[OLD].size = 0;
+    table->store[OLD].deleted = 0;
+    table->store[OLD].stashed = 0;
+    table->store[OLD].buckets = NULL;
+    table->rehash_idx = 0;
+}
+
+static size_t NextCursor(size_t cursor, size_t mask)
+{
+    size_t bit = mask ^ (mask >> 1);
+
+    /* increments the masked cursor from its highest bit down */
+    cursor &= mask;
+
+    while (0 != (cursor & bit))
+    {
+        cursor ^= bit;
+        bit >>= 1;
+    }
+
+    return (cursor | bit);
+}
+
+/********************************* Chaining ***********************************/
+
+static int ChainCreate(ht_store_t *store, size_t num_buckets)
+{
+    assert(NULL != store);
+    assert(0 < num_buckets);
+    assert(0 == (num_buckets & (num_buckets - 1)));
+
+    store->buckets = calloc(num_buckets, sizeof(ht_node_t *));
+    if (NULL == store->buckets)
+    {
+        return (FAILURE);
+    }
+
+    store->num_buckets = num_buckets;
+    store->size = 0;
+    store->deleted = 0;
+
+    return (SUCCESS);
+}
+
+static void ChainDestroy(ht_store_t *store)
+{
+    ht_node_t **bucket = NULL;
+    ht_node_t *node = NULL;
+    ht_node_t *next = NULL;
+    size_t i = 0;
+
+    assert(NULL != store);
+
+    bucket = store->buckets;
+
+    for (; i < store->num_buckets; ++i)
+    {
+        for (node = bucket[i]; NULL != node; node = next)
+        {
+            next = node->next;
+            free(node);
+        }
+    }
+
+    free(bucket);
+    store->buckets = NULL;
+}
+
+static void *ChainFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    ht_node_t **bucket = NULL;
+    ht_node_t **link = NULL;
+    ht_node_t *founded_node = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != key);
+
+    bucket = &FIND_CHAIN(store, hash);
+
+    link = ChainLookup(table, bucket, key, hash);
+    founded_node = *link;
+
+    if (NULL == founded_node)
+    {
+        return (NULL);
+    }
+
+    if (link != bucket)
+    {
+        *link = founded_node->next;
+        founded_node->next = *bucket;
+        *bucket = founded_node;
+    }
+
+    return (founded_node->data);
+}
+
+static int ChainInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash)
+{
+    ht_node_t **link = NULL;
+    ht_node_t *new_node = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != data);
+
+    link = ChainLookup(table, &FIND_CHAIN(store, hash), data, hash);
+
+    if (NULL != *link)
+    {
+        (*link)->data = data;
+        return (SUCCESS);
+    }
+
+    new_node = (ht_node_t *) malloc(sizeof(ht_node_t));
+    if (NULL == new_node)
+    {
+        return (FAILURE);
+    }
+
+    new_node->next = NULL;
+    new_node->hash = hash;
+    new_node->data = data;
+
+    *link = new_node;
+    ++store->size;
+
+    return (SUCCESS);
+}
+
+static int ChainPlace(ht_store_t *store, void *data, size_t hash)
+{
+    ht_node_t **bucket = NULL;
+    ht_node_t *new_node = NULL;
+
+    assert(NULL != store);
+    assert(NULL != data);
+
+    new_node = (ht_node_t *) malloc(sizeof(ht_node_t));
+    if (NULL == new_node)
+    {
+        return (FAILURE);
+    }
+
+    bucket = &FIND_CHAIN(store, hash);
+
+    new_node->next = *bucket;
+    new_node->hash = hash;
+    new_node->data = data;
+
+    *bucket = new_node;
+    ++store->size;
+
+    return (SUCCESS);
+}
+
+static void *ChainRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    ht_node_t **link = NULL;
+    ht_node_t *founded_node = NULL;
+    void *removed = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != key);
+
+    link = ChainLookup(table, &FIND_CHAIN(store, hash), key, hash);
+    founded_node = *link;
+
+    if (NULL != founded_node)
+    {
+        removed = founded_node->data;
+        *link = founded_node->next;
+        free(founded_node);
+        --store->size;
+    }
+
+    return (removed);
+}
+
+static int ChainForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param)
+{
+    ht_node_t **bucket = NULL;
+    ht_node_t *node = NULL;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != store);
+    assert(NULL != action);
+
+    bucket = store->buckets;
+
+    for (; i < store->num_buckets && 0 == status; ++i)
+    {
+        for (node = bucket[i]; NULL != node && 0 == status; node = node->next)
+        {
+            status = action(node->data, param);
+        }
+    }
+
+    return (status);
+}
+
+static size_t ChainMigrate(h_table_t *table, size_t idx)
+{
+    ht_node_t **from_bucket = NULL;
+    ht_node_t **tail = NULL;
+    ht_node_t *node = NULL;
+    ht_store_t *new_store = NULL;
+    ht_store_t *old_store = NULL;
+    size_t to_idx = 0;
+    size_t last_idx = 0;
+    size_t moved = 0;
+
+    assert(NULL != table);
+
+    new_store = &table->store[NEW];
+    old_store = &table->store[OLD];
+    from_bucket = &((ht_node_t **) old_store->buckets)[idx];
+
+    /* nodes keep their order and are relinked by the cached hash */
+    while (NULL != *from_bucket)
+    {
+        node = *from_bucket;
+        *from_bucket = node->next;
+        node->next = NULL;
+
+        to_idx = COMPUTE_INDEX(new_store, node->hash);
+        if (NULL == tail || to_idx != last_idx)
+        {
+            tail = &((ht_node_t **) new_store->buckets)[to_idx];
+            last_idx = to_idx;
+        }
+
+        while (NULL != *tail)
+        {
+            tail = &(*tail)->next;
+        }
+
+        *tail = node;
+        ++moved;
+    }
+
+    old_store->size -= moved;
+    new_store->size += moved;
+
+    return (moved);
+}
+
+static void ChainPrefetch(const ht_store_t *store, size_t hash, int level)
+{
+    ht_node_t **bucket = NULL;
+
+    assert(NULL != store);
+
+    bucket = &FIND_CHAIN(store, hash);
+
+    if (PREFETCH_BUCKET == level)
+    {
+        PREFETCH(bucket);
+    }
+    else if (NULL != *bucket)
+    {
+        PREFETCH(*bucket);
+    }
+}
+
+static int ChainScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param)
+{
+    ht_node_t *node = NULL;
+    int status = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != action);
+
+    (void) table;
+
+    for (node = ((ht_node_t **) store->buckets)[home]; NULL != node;
+                                                            node = node->next)
+    {
+        status |= action(node->data, param);
+    }
+
+    return (status);
+}
+
+static ht_node_t **ChainLookup(const h_table_t *table, ht_node_t **bucket,
+                                                const void *key, size_t hash)
+{
+    ht_node_t **link = NULL;
+
+    assert(NULL != table);
+    assert(NULL != bucket);
+
+    /* the cached hash rejects most mismatches without calling is_match */
+    for (link = bucket; NULL != *link; link = &(*link)->next)
+    {
+        if (hash == (*link)->hash && table->is_match((*link)->data, key))
+        {
+            break;
+        }
+    }
+
+    return (link);
+}
+
+/******************************** Robin Hood **********************************/
+
+static int FlatCreate(ht_store_t *store, size_t num_buckets)
+{
+    assert(NULL != store);
+    assert(0 == (num_buckets & (num_buckets - 1)));
+
+    store->buckets = calloc(num_buckets, sizeof(ht_slot_t));
+    if (NULL == store->buckets)
+    {
+        return (FAILURE);
+    }
+
+    store->num_buckets = num_buckets;
+    store->size = 0;
+    store->deleted = 0;
+
+    return (SUCCESS);
+}
+
+static void FlatDestroy(ht_store_t *store)
+{
+    assert(NULL != store);
+
+    free(store->buckets);
+    store->buckets = NULL;
+}
+
+static void *FlatFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    idx = FlatLookup(table, store, key, hash);
+    if (store->num_buckets == idx)
+    {
+        return (NULL);
+    }
+
+    return (((ht_slot_t *) store->buckets)[idx].data);
+}
+
+static int FlatInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash)
+{
+    ht_slot_t *slots = NULL;
+    ht_slot_t carry = {0};
+    ht_slot_t tmp = {0};
+    size_t idx = 0;
+    size_t dist = 0;
+    int is_searching = 1;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != data);
+
+    slots = store->buckets;
+    carry.hash = hash;
+    carry.data = data;
+    idx = FLAT_HOME(store, hash);
+
+    while (!IS_SLOT_EMPTY(&slots[idx]))
+    {
+        if (is_searching && hash == slots[idx].hash &&
+                                        table->is_match(slots[idx].data, data))
+        {
+            slots[idx].data = data;
+            return (SUCCESS);
+        }
+
+        if (FLAT_DISTANCE(store, &slots[idx], idx) < dist)
+        {
+            /* the key can not live past a richer slot, start displacing */
+            if (is_searching && FLAT_MAX_LOAD(store->num_buckets) <= store->size)
+            {
+                return (FAILURE);
+            }
+
+            is_searching = 0;
+            tmp = slots[idx];
+            slots[idx] = carry;
+            carry = tmp;
+            dist = FLAT_DISTANCE(store, &carry, idx);
+        }
+
+        idx = FLAT_NEXT(store, idx);
+        ++dist;
+    }
+
+    if (is_searching && FLAT_MAX_LOAD(store->num_buckets) <= store->size)
+    {
+        return (FAILURE);
+    }
+
+    slots[idx] = carry;
+    ++store->size;
+
+    return (SUCCESS);
+}
+
+static int FlatPlace(ht_store_t *store, void *data, size_t hash)
+{
+    ht_slot_t *slots = NULL;
+    ht_slot_t carry = {0};
+    ht_slot_t tmp = {0};
+    size_t idx = 0;
+    size_t dist = 0;
+
+    assert(NULL != store);
+    assert(NULL != data);
+
+    if (FLAT_MAX_LOAD(store->num_buckets) <= store->size)
+    {
+        return (FAILURE);
+    }
+
+    slots = store->buckets;
+    carry.hash = hash;
+    carry.data = data;
+    idx = FLAT_HOME(store, hash);
+
+    /* same as FlatInsert once it starts displacing, no key is compared */
+    while (!IS_SLOT_EMPTY(&slots[idx]))
+    {
+        if (FLAT_DISTANCE(store, &slots[idx], idx) < dist)
+        {
+            tmp = slots[idx];
+            slots[idx] = carry;
+            carry = tmp;
+            dist = FLAT_DISTANCE(store, &carry, idx);
+        }
+
+        idx = FLAT_NEXT(store, idx);
+        ++dist;
+    }
+
+    slots[idx] = carry;
+    ++store->size;
+
+    return (SUCCESS);
+}
+
+static void *FlatRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    void *removed = NULL;
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    idx = FlatLookup(table, store, key, hash);
+    if (store->num_buckets == idx)
+    {
+        return (NULL);
+    }
+
+    removed = ((ht_slot_t *) store->buckets)[idx].data;
+    FlatErase(store, idx);
+
+    return (removed);
+}
+
+static int FlatForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param)
+{
+    ht_slot_t *slots = NULL;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != store);
+    assert(NULL != action);
+
+    slots = store->buckets;
+
+    for (; i < store->num_buckets && 0 == status; ++i)
+    {
+        if (!IS_SLOT_EMPTY(&slots[i]))
+        {
+            status = action(slots[i].data, param);
+        }
+    }
+
+    return (status);
+}
+
+static size_t FlatMigrate(h_table_t *table, size_t idx)
+{
+    ht_store_t *old_store = NULL;
+    ht_slot_t *slot = NULL;
+    size_t moved = 0;
+
+    assert(NULL != table);
+
+    old_store = &table->store[OLD];
+    slot = &((ht_slot_t *) old_store->buckets)[idx];
+
+    /*
+    * backward shift may pull the rest of the cluster into this slot. A slot
+    * the new store has no room for stays in place, the step is over
+    */
+    while (!IS_SLOT_EMPTY(slot) && SUCCESS ==
+                FlatInsert(table, &table->store[NEW], slot->data, slot->hash))
+    {
+        FlatErase(old_store, idx);
+        ++moved;
+    }
+
+    return (moved);
+}
+
+static void FlatPrefetch(const ht_store_t *store, size_t hash, int level)
+{
+    ht_slot_t *slot = NULL;
+
+    assert(NULL != store);
+
+    slot = &((ht_slot_t *) store->buckets)[FLAT_HOME(store, hash)];
+
+    if (PREFETCH_BUCKET == level)
+    {
+        PREFETCH(slot);
+    }
+    else if (!IS_SLOT_EMPTY(slot))
+    {
+        PREFETCH(slot->data);
+    }
+}
+
+static int FlatScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param)
+{
+    ht_slot_t *slots = NULL;
+    size_t idx = home;
+    size_t dist = 0;
+    int status = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != action);
+
+    (void) table;
+
+    slots = store->buckets;
+
+    /* the run of a home starts after the poorer slots and ends at a richer */
+    while (!IS_SLOT_EMPTY(&slots[idx]) &&
+                                dist <= FLAT_DISTANCE(store, &slots[idx], idx))
+    {
+        if (dist == FLAT_DISTANCE(store, &slots[idx], idx))
+        {
+            status |= action(slots[idx].data, param);
+        }
+
+        idx = FLAT_NEXT(store, idx);
+        ++dist;
+    }
+
+    return (status);
+}
+
+static size_t FlatLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash)
+{
+    const ht_slot_t *slots = NULL;
+    size_t idx = 0;
+    size_t dist = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != key);
+
+    slots = store->buckets;
+    idx = FLAT_HOME(store, hash);
+
+    while (!IS_SLOT_EMPTY(&slots[idx]) &&
+                                dist <= FLAT_DISTANCE(store, &slots[idx], idx))
+    {
+        if (hash == slots[idx].hash && table->is_match(slots[idx].data, key))
+        {
+            return (idx);
+        }
+
+        idx = FLAT_NEXT(store, idx);
+        ++dist;
+    }
+
+    return (store->num_buckets);
+}
+
+static void FlatErase(ht_store_t *store, size_t idx)
+{
+    ht_slot_t *slots = NULL;
+    size_t next = 0;
+
+    assert(NULL != store);
+
+    slots = store->buckets;
+    next = FLAT_NEXT(store, idx);
+
+    /* backward shift: pull the rest of the cluster one slot closer to home */
+    while (!IS_SLOT_EMPTY(&slots[next]) &&
+                                    0 != FLAT_DISTANCE(store, &slots[next], next))
+    {
+        slots[idx] = slots[next];
+        idx = next;
+        next = FLAT_NEXT(store, next);
+    }
+
+    slots[idx].data = NULL;
+    slots[idx].hash = 0;
+    --store->size;
+}
+
+/******************************** Swiss table *********************************/
+
+static int SwissCreate(ht_store_t *store, size_t num_buckets)
+{
+    assert(NULL != store);
+    assert(0 == (num_buckets & (num_buckets - 1)));
+    assert(GROUP_WIDTH <= num_buckets);
+
+    store->buckets = malloc(num_buckets + num_buckets * sizeof(ht_slot_t));
+    if (NULL == store->buckets)
+    {
+        return (FAILURE);
+    }
+
+    memset(store->buckets, CTRL_EMPTY, num_buckets);
+
+    store->num_buckets = num_buckets;
+    store->size = 0;
+    store->deleted = 0;
+
+    return (SUCCESS);
+}
+
+static void SwissDestroy(ht_store_t *store)
+{
+    assert(NULL != store);
+
+    free(store->buckets);
+    store->buckets = NULL;
+}
+
+static void *SwissFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    idx = SwissLookup(table, store, key, hash);
+    if (store->num_buckets == idx)
+    {
+        return (NULL);
+    }
+
+    return (SWISS_SLOTS(store)[idx].data);
+}
+
+static int SwissInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash)
+{
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != data);
+
+    idx = SwissLookup(table, store, data, hash);
+    if (store->num_buckets != idx)
+    {
+        SWISS_SLOTS(store)[idx].data = data;
+        return (SUCCESS);
+    }
+
+    return (SwissPlace(store, data, hash));
+}
+
+static void *SwissRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    void *removed = NULL;
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    idx = SwissLookup(table, store, key, hash);
+    if (store->num_buckets == idx)
+    {
+        return (NULL);
+    }
+
+    removed = SWISS_SLOTS(store)[idx].data;
+    SwissErase(store, idx);
+
+    return (removed);
+}
+
+static int SwissForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param)
+{
+    const unsigned char *ctrl = NULL;
+    ht_slot_t *slots = NULL;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != store);
+    assert(NULL != action);
+
+    ctrl = SWISS_CTRL(store);
+    slots = SWISS_SLOTS(store);
+
+    for (; i < store->num_buckets && 0 == status; ++i)
+    {
+        if (IS_CTRL_FULL(ctrl[i]))
+        {
+            status = action(slots[i].data, param);
+        }
+    }
+
+    return (status);
+}
+
+static size_t SwissMigrate(h_table_t *table, size_t idx)
+{
+    ht_store_t *old_store = NULL;
+    ht_slot_t *slot = NULL;
+
+    assert(NULL != table);
+
+    old_store = &table->store[OLD];
+
+    if (!IS_CTRL_FULL(SWISS_CTRL(old_store)[idx]))
+    {
+        return (0);
+    }
+
+    /* a slot the new store has no room for stays in place */
+    slot = &SWISS_SLOTS(old_store)[idx];
+    if (SUCCESS != SwissPlace(&table->store[NEW], slot->data, slot->hash))
+    {
+        return (0);
+    }
+
+    SwissErase(old_store, idx);
+
+    return (1);
+}
+
+static void SwissPrefetch(const ht_store_t *store, size_t hash, int level)
+{
+    size_t first = 0;
+
+    assert(NULL != store);
+
+    first = (H1(hash) & SWISS_GROUP_MASK(store)) * GROUP_WIDTH;
+
+    if (PREFETCH_BUCKET == level)
+    {
+        PREFETCH(&SWISS_CTRL(store)[first]);
+    }
+    else
+    {
+        PREFETCH(&SWISS_SLOTS(store)[first]);
+    }
+}
+
+static int SwissScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param)
+{
+    const unsigned char *ctrl = NULL;
+    ht_slot_t *slots = NULL;
+    size_t group_mask = 0;
+    size_t group = home;
+    size_t probe = 0;
+    size_t idx = 0;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != action);
+
+    (void) table;
+
+    ctrl = SWISS_CTRL(store);
+    slots = SWISS_SLOTS(store);
+    group_mask = SWISS_GROUP_MASK(store);
+
+    /* elements of a home group lie on its probe sequence, as lookups see it */
+    for (;;)
+    {
+        for (i = 0; i < GROUP_WIDTH; ++i)
+        {
+            idx = group * GROUP_WIDTH + i;
+
+            if (IS_CTRL_FULL(ctrl[idx]) &&
+                                home == (H1(slots[idx].hash) & group_mask))
+            {
+                status |= action(slots[idx].data, param);
+            }
+        }
+
+        if (0 != GroupMatch(ctrl + group * GROUP_WIDTH, CTRL_EMPTY))
+        {
+            return (status);
+        }
+
+        ++probe;
+        group = (group + probe) & group_mask;
+    }
+}
+
+static size_t SwissLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash)
+{
+    const unsigned char *ctrl = NULL;
+    const ht_slot_t *slots = NULL;
+    size_t group_mask = 0;
+    size_t group = 0;
+    size_t probe = 0;
+    size_t idx = 0;
+    unsigned int match = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != key);
+
+    ctrl = SWISS_CTRL(store);
+    slots = SWISS_SLOTS(store);
+    group_mask = SWISS_GROUP_MASK(store);
+    group = H1(hash) & group_mask;
+
+    for (;;)
+    {
+        match = GroupMatch(ctrl + group * GROUP_WIDTH, H2(hash));
+
+        for (; 0 != match; match &= match - 1)
+        {
+            idx = group * GROUP_WIDTH + __builtin_ctz(match);
+
+            if (hash == slots[idx].hash && table->is_match(slots[idx].data, key))
+            {
+                return (idx);
+            }
+        }
+
+        /* a group with an empty slot ends every probe that reached it */
+        if (0 != GroupMatch(ctrl + group * GROUP_WIDTH, CTRL_EMPTY))
+        {
+            return (store->num_buckets);
+        }
+
+        ++probe;
+        group = (group + probe) & group_mask;
+    }
+}
+
+static int SwissPlace(ht_store_t *store, void *data, size_t hash)
+{
+    unsigned char *ctrl = NULL;
+    ht_slot_t *slot = NULL;
+    size_t group_mask = 0;
+    size_t group = 0;
+    size_t probe = 0;
+    size_t idx = 0;
+    unsigned int match = 0;
+
+    assert(NULL != store);
+    assert(NULL != data);
+
+    ctrl = SWISS_CTRL(store);
+    group_mask = SWISS_GROUP_MASK(store);
+    group = H1(hash) & group_mask;
+
+    while (0 == (match = GroupMatchFree(ctrl + group * GROUP_WIDTH)))
+    {
+        ++probe;
+        group = (group + probe) & group_mask;
+    }
+
+    idx = group * GROUP_WIDTH + __builtin_ctz(match);
+
+    if (CTRL_DELETED == ctrl[idx])
+    {
+        --store->deleted;
+    }
+    else if (FLAT_MAX_LOAD(store->num_buckets) <= store->size + store->deleted)
+    {
+        return (FAILURE);
+    }
+
+    ctrl[idx] = H2(hash);
+    slot = &SWISS_SLOTS(store)[idx];
+    slot->hash = hash;
+    slot->data = data;
+    ++store->size;
+
+    return (SUCCESS);
+}
+
+static void SwissErase(ht_store_t *store, size_t idx)
+{
+    unsigned char *ctrl = NULL;
+
+    assert(NULL != store);
+    assert(IS_CTRL_FULL(SWISS_CTRL(store)[idx]));
+
+    ctrl = SWISS_CTRL(store);
+
+    /*
+    * if the group still has an empty slot no probe ever went past it, so
+    * the slot can become empty too instead of leaving a tombstone
+    */
+    if (0 != GroupMatch(ctrl + (idx & ~(size_t) (GROUP_WIDTH - 1)), CTRL_EMPTY))
+    {
+        ctrl[idx] = CTRL_EMPTY;
+    }
+    else
+    {
+        ctrl[idx] = CTRL_DELETED;
+        ++store->deleted;
+    }
+
+    SWISS_SLOTS(store)[idx].data = NULL;
+    --store->size;
+}
+
+#ifdef __SSE2__
+
+static unsigned int GroupMatch(const unsigned char *group, unsigned char ctrl)
+{
+    __m128i ctrl_bytes = _mm_loadu_si128((const __m128i *) group);
+
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_bytes,
+                                                _mm_set1_epi8((char) ctrl))));
+}
+
+static unsigned int GroupMatchFree(const unsigned char *group)
+{
+    /* both empty and deleted have the high bit set, full slots do not */
+    return (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *) group)));
+}
+
+#else
+
+static unsigned int GroupMatch(const unsigned char *group, unsigned char ctrl)
+{
+    unsigned int mask = 0;
+    size_t i = 0;
+
+    for (; i < GROUP_WIDTH; ++i)
+    {
+        mask |= (unsigned int) (ctrl == group[i]) << i;
+    }
+
+    return (mask);
+}
+
+static unsigned int GroupMatchFree(const unsigned char *group)
+{
+    unsigned int mask = 0;
+    size_t i = 0;
+
+    for (; i < GROUP_WIDTH; ++i)
+    {
+        mask |= (unsigned int) (group[i] >> 7) << i;
+    }
+
+    return (mask);
+}
+
+#endif /* __SSE2__ */
+
+/********************************** Cuckoo ************************************/
+
+static int CuckooCreate(ht_store_t *store, size_t num_buckets)
+{
+    assert(NULL != store);
+    assert(0 == (num_buckets & (num_buckets - 1)));
+    assert(CUCKOO_MIN_SLOTS <= num_buckets);
+
+    store->buckets = calloc(num_buckets + CUCKOO_STASH_SIZE, sizeof(ht_slot_t));
+    if (NULL == store->buckets)
+    {
+        return (FAILURE);
+    }
+
+    store->num_buckets = num_buckets;
+    store->size = 0;
+    store->deleted = 0;
+    store->stashed = 0;
+
+    return (SUCCESS);
+}
+
+static void CuckooDestroy(ht_store_t *store)
+{
+    assert(NULL != store);
+
+    free(store->buckets);
+    store->buckets = NULL;
+}
+
+static void *CuckooFind(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    ht_slot_t *slot = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    slot = CuckooLookup(table, store, key, hash);
+
+    return ((NULL != slot) ? slot->data : NULL);
+}
+
+static int CuckooInsert(h_table_t *table, ht_store_t *store, void *data,
+                                                                size_t hash)
+{
+    ht_slot_t *slot = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != data);
+
+    slot = CuckooLookup(table, store, data, hash);
+    if (NULL != slot)
+    {
+        slot->data = data;
+        return (SUCCESS);
+    }
+
+    return (CuckooPlace(store, data, hash));
+}
+
+static void *CuckooRemove(h_table_t *table, ht_store_t *store, const void *key,
+                                                                size_t hash)
+{
+    ht_slot_t *slot = NULL;
+    void *removed = NULL;
+
+    assert(NULL != table);
+    assert(NULL != store);
+
+    slot = CuckooLookup(table, store, key, hash);
+    if (NULL == slot)
+    {
+        return (NULL);
+    }
+
+    if (CUCKOO_STASH(store) <= slot)
+    {
+        --store->stashed;
+    }
+
+    removed = slot->data;
+    slot->data = NULL;
+    slot->hash = 0;
+    --store->size;
+
+    return (removed);
+}
+
+static int CuckooForEach(ht_store_t *store, h_table_action_t action,
+                                                                void *param)
+{
+    ht_slot_t *slots = NULL;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != store);
+    assert(NULL != action);
+
+    slots = store->buckets;
+
+    for (; i < store->num_buckets + CUCKOO_STASH_SIZE && 0 == status; ++i)
+    {
+        if (!IS_SLOT_EMPTY(&slots[i]))
+        {
+            status = action(slots[i].data, param);
+        }
+    }
+
+    return (status);
+}
+
+static size_t CuckooMigrate(h_table_t *table, size_t idx)
+{
+    ht_store_t *old_store = NULL;
+    ht_slot_t *stash = NULL;
+    size_t moved = 0;
+    size_t i = 0;
+
+    assert(NULL != table);
+
+    old_store = &table->store[OLD];
+
+    moved = CuckooMoveSlot(table, CUCKOO_BUCKET(old_store, 0) + idx, 0);
+
+    /* the stash rides along with the first slot */
+    if (0 == idx)
+    {
+        stash = CUCKOO_STASH(old_store);
+
+        for (; i < CUCKOO_STASH_SIZE; ++i)
+        {
+            moved += CuckooMoveSlot(table, &stash[i], 1);
+        }
+    }
+
+    return (moved);
+}
+
+static void CuckooPrefetch(const ht_store_t *store, size_t hash, int level)
+{
+    size_t first = 0;
+    size_t second = 0;
+
+    assert(NULL != store);
+
+    CuckooBuckets(store, hash, &first, &second);
+
+    PREFETCH(CUCKOO_BUCKET(store, (PREFETCH_BUCKET == level) ? first : second));
+}
+
+static int CuckooScan(const h_table_t *table, ht_store_t *store, size_t home,
+                                        h_table_action_t action, void *param)
+{
+    ht_slot_t *slot = NULL;
+    size_t i = 0;
+    int status = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != action);
+
+    (void) table;
+
+    slot = CUCKOO_BUCKET(store, home);
+
+    for (; i < CUCKOO_BUCKET_SLOTS; ++i, ++slot)
+    {
+        if (!IS_SLOT_EMPTY(slot))
+        {
+            status |= action(slot->data, param);
+        }
+    }
+
+    /* the stash goes with the first bucket, like when migrating */
+    if (0 == home && 0 != store->stashed)
+    {
+        slot = CUCKOO_STASH(store);
+
+        for (i = 0; i < CUCKOO_STASH_SIZE; ++i, ++slot)
+        {
+            if (!IS_SLOT_EMPTY(slot))
+            {
+                status |= action(slot->data, param);
+            }
+        }
+    }
+
+    return (status);
+}
+
+static ht_slot_t *CuckooLookup(const h_table_t *table, const ht_store_t *store,
+                                                const void *key, size_t hash)
+{
+    ht_slot_t *slot = NULL;
+    size_t buckets[2] = {0};
+    size_t i = 0;
+    size_t j = 0;
+
+    assert(NULL != table);
+    assert(NULL != store);
+    assert(NULL != key);
+
+    CuckooBuckets(store, hash, &buckets[0], &buckets[1]);
+
+    /* an element only ever lives in one of its two buckets or the stash */
+    for (; i < 2; ++i)
+    {
+        slot = CUCKOO_BUCKET(store, buckets[i]);
+
+        for (j = 0; j < CUCKOO_BUCKET_SLOTS; ++j, ++slot)
+        {
+            if (hash == slot->hash && !IS_SLOT_EMPTY(slot) &&
+                                            table->is_match(slot->data, key))
+            {
+                return (slot);
+            }
+        }
+    }
+
+    if (0 == store->stashed)
+    {
+        return (NULL);
+    }
+
+    slot = CUCKOO_STASH(store);
+
+    for (j = 0; j < CUCKOO_STASH_SIZE; ++j, ++slot)
+    {
+        if (hash == slot->hash && !IS_SLOT_EMPTY(slot) &&
+                                            table->is_match(slot->data, key))
+        {
+            return (slot);
+        }
+    }
+
+    return (NULL);
+}
+
+static int CuckooPlace(ht_store_t *store, void *data, size_t hash)
+{
+    ht_slot_t *slots = NULL;
+    ht_slot_t *free_slot = NULL;
+    ht_slot_t carry = {0};
+    ht_slot_t tmp = {0};
+    size_t path[CUCKOO_MAX_KICKS] = {0};
+    size_t kicks = 0;
+    size_t first = 0;
+    size_t second = 0;
+    size_t from = 0;
+    size_t victim = 0;
+
+    assert(NULL != store);
+    assert(NULL != data);
+
+    slots = store->buckets;
+    carry.hash = hash;
+    carry.data = data;
+    from = CUCKOO_BUCKET_MASK(store) + 1;
+
+    for (;;)
+    {
+        CuckooBuckets(store, carry.hash, &first, &second);
+
+        free_slot = FindFreeSlot(CUCKOO_BUCKET(store, first),
+                                                        CUCKOO_BUCKET_SLOTS);
+        if (NULL == free_slot)
+        {
+            free_slot = FindFreeSlot(CUCKOO_BUCKET(store, second),
+                                                        CUCKOO_BUCKET_SLOTS);
+        }
+
+        if (NULL != free_slot)
+        {
+            *free_slot = carry;
+            ++store->size;
+            return (SUCCESS);
+        }
+
+        if (CUCKOO_MAX_KICKS == kicks)
+        {
+            break;
+        }
+
+        /* evict from the bucket the carried element was not kicked out of */
+        from = (first != from) ? first : second;
+        victim = from * CUCKOO_BUCKET_SLOTS +
+                            ((carry.hash >> 7) + kicks) % CUCKOO_BUCKET_SLOTS;
+
+        tmp = slots[victim];
+        slots[victim] = carry;
+        carry = tmp;
+        path[kicks] = victim;
+        ++kicks;
+    }
+
+    free_slot = FindFreeSlot(CUCKOO_STASH(store), CUCKOO_STASH_SIZE);
+    if (NULL != free_slot)
+    {
+        *free_slot = carry;
+        ++store->stashed;
+        ++store->size;
+        return (SUCCESS);
+    }
+
+    /* nowhere to go, walk the kicks back so the store is left as it was */
+    while (0 < kicks)
+    {
+        --kicks;
+        tmp = slots[path[kicks]];
+        slots[path[kicks]] = carry;
+        carry = tmp;
+    }
+
+    return (FAILURE);
+}
+
+static size_t CuckooMoveSlot(h_table_t *table, ht_slot_t *slot, int is_stashed)
+{
+    ht_store_t *old_store = NULL;
+
+    assert(NULL != table);
+    assert(NULL != slot);
+
+    old_store = &table->store[OLD];
+
+    if (IS_SLOT_EMPTY(slot) ||
+            SUCCESS != CuckooPlace(&table->store[NEW], slot->data, slot->hash))
+    {
+        return (0);
+    }
+
+    slot->data = NULL;
+    slot->hash = 0;
+    --old_store->size;
+    old_store->stashed -= (0 != is_stashed);
+
+    return (1);
+}
+
+static void CuckooBuckets(const ht_store_t *store, size_t hash, size_t *first,
+                                                                size_t *second)
+{
+    size_t mask = 0;
+
+    assert(NULL != store);
+    assert(NULL != first);
+    assert(NULL != second);
+
+    mask = CUCKOO_BUCKET_MASK(store);
+
+    /* the cached hash is mixed already, mixing it again gives another one */
+    *first = hash & mask;
+    *second = HashWord(hash) & mask;
+
+    if (*first == *second)
+    {
+        *second ^= 1;
+    }
+}
+
+static ht_slot_t *FindFreeSlot(ht_slot_t *slots, size_t num_slots)
+{
+    size_t i = 0;
+
+    assert(NULL != slots);
+
+    for (; i < num_slots; ++i)
+    {
+        if (IS_SLOT_EMPTY(&slots[i]))
+        {
+            return (&slots[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
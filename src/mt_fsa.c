@@ -0,0 +1,165 @@
+/*******************************************************************************
+*
+* FILENAME : mt_fsa.c
+*
+* DESCRIPTION : Lock-free fixed-size allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+
+#include "mt_fsa.h"
+
+#define WORD_SIZE (sizeof(size_t))
+#define ALIGN_NUMBER(NUMBER) (((NUMBER) + WORD_SIZE - 1) & ~(WORD_SIZE - 1))
+#define CACHE_LINE_SIZE (64)
+#define ALIGN_TO_LINE(NUMBER) \
+(((NUMBER) + CACHE_LINE_SIZE - 1) & ~(size_t) (CACHE_LINE_SIZE - 1))
+/*
+* the head is placed at the first cache line of the pool and the blocks start
+* at the next one, so they never share a line with it
+*/
+#define MT_FSA_STRUCT_SIZE (ALIGN_TO_LINE(sizeof(struct mt_fsa)))
+/* the most bytes a word aligned pool may need to reach a cache line */
+#define ALIGN_SLACK (CACHE_LINE_SIZE - WORD_SIZE)
+
+/* the head is the tag in the high half of a word and the index in the low */
+#define INDEX_BITS (sizeof(size_t) * CHAR_BIT / 2)
+#define INDEX_MASK (((size_t) 1 << INDEX_BITS) - 1)
+#define HEAD_INDEX(HEAD) ((HEAD) & INDEX_MASK)
+#define NEXT_HEAD(HEAD, INDEX) \
+((((HEAD) >> INDEX_BITS) + 1) << INDEX_BITS | (INDEX))
+/* indices start from 1, 0 ends the list */
+#define END_INDEX (0)
+#define BLOCK(FSA, INDEX) \
+((size_t *) ((char *) (FSA) + MT_FSA_STRUCT_SIZE + \
+                                        ((INDEX) - 1) * (FSA)->block_size))
+
+#define LOAD(PTR) (__atomic_load_n(PTR, __ATOMIC_RELAXED))
+#define LOAD_ACQ(PTR) (__atomic_load_n(PTR, __ATOMIC_ACQUIRE))
+#define STORE(PTR, VAL) (__atomic_store_n(PTR, VAL, __ATOMIC_RELAXED))
+#define CAS_ACQ(PTR, EXPECTED, DESIRED) \
+(__atomic_compare_exchange_n(PTR, EXPECTED, DESIRED, 1, \
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+#define CAS_REL(PTR, EXPECTED, DESIRED) \
+(__atomic_compare_exchange_n(PTR, EXPECTED, DESIRED, 1, \
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+
+struct mt_fsa
+{
+    size_t head;
+    size_t block_size;
+};
+
+mt_fsa_t *MTFSAInit(size_t size_of_block, size_t number_of_blocks,
+                                                            void *memory_pool)
+{
+    mt_fsa_t *mt_fsa = NULL;
+    size_t i = 1;
+
+    assert(NULL != memory_pool);
+    assert(0 == (size_t) memory_pool % WORD_SIZE);
+    assert(0 < number_of_blocks);
+    assert(number_of_blocks < INDEX_MASK);
+
+    mt_fsa = (mt_fsa_t *) ALIGN_TO_LINE((size_t) memory_pool);
+    mt_fsa->block_size = ALIGN_NUMBER(size_of_block);
+    if (0 == mt_fsa->block_size)
+    {
+        mt_fsa->block_size = WORD_SIZE;
+    }
+
+    for (; i < number_of_blocks; ++i)
+    {
+        *BLOCK(mt_fsa, i) = i + 1;
+    }
+
+    *BLOCK(mt_fsa, number_of_blocks) = END_INDEX;
+    mt_fsa->head = 1;
+
+    return (mt_fsa);
+}
+
+void *MTFSAAlloc(mt_fsa_t *mt_fsa)
+{
+    size_t *block = NULL;
+    size_t head = 0;
+
+    assert(NULL != mt_fsa);
+
+    head = LOAD_ACQ(&mt_fsa->head);
+
+    /*
+    * the block may be popped and written by another thread before the swap,
+    * then the link read is garbage, but the tag has changed and the swap fails
+    */
+    do
+    {
+        if (END_INDEX == HEAD_INDEX(head))
+        {
+            return (NULL);
+        }
+
+        block = BLOCK(mt_fsa, HEAD_INDEX(head));
+    }
+    while (!CAS_ACQ(&mt_fsa->head, &head, NEXT_HEAD(head, LOAD(block))));
+
+    return (block);
+}
+
+void MTFSAFree(mt_fsa_t *mt_fsa, void *block_to_free)
+{
+    size_t index = 0;
+    size_t head = 0;
+
+    assert(NULL != mt_fsa);
+    assert(NULL != block_to_free);
+
+    index = ((char *) block_to_free - (char *) mt_fsa - MT_FSA_STRUCT_SIZE) /
+                                                    mt_fsa->block_size + 1;
+
+    assert(BLOCK(mt_fsa, index) == block_to_free);
+
+    head = LOAD(&mt_fsa->head);
+
+    /* the link is published together with the head by the release */
+    do
+    {
+        STORE((size_t *) block_to_free, HEAD_INDEX(head));
+    }
+    while (!CAS_REL(&mt_fsa->head, &head, NEXT_HEAD(head, index)));
+}
+
+size_t MTFSASuggestSize(size_t number_of_blocks, size_t size_of_block)
+{
+    size_of_block = ALIGN_NUMBER(size_of_block);
+    if (0 == size_of_block)
+    {
+        size_of_block = WORD_SIZE;
+    }
+
+    return (ALIGN_SLACK + MT_FSA_STRUCT_SIZE +
+                                        number_of_blocks * size_of_block);
+}
+
+size_t MTFSACountFree(const mt_fsa_t *mt_fsa)
+{
+    size_t index = 0;
+    size_t counter = 0;
+
+    assert(NULL != mt_fsa);
+
+    index = HEAD_INDEX(LOAD_ACQ(&mt_fsa->head));
+
+    for (; END_INDEX != index; index = *BLOCK(mt_fsa, index))
+    {
+        ++counter;
+    }
+
+    return (counter);
+}
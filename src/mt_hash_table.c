@@ -0,0 +1,459 @@
+/*******************************************************************************
+*
+* FILENAME : mt_hash_table.c
+*
+* DESCRIPTION : Thread-safe hash table implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L /* posix_memalign, pthread_rwlock_t */
+
+#include <assert.h> /* assert */
+#include <pthread.h> /* pthread_rwlock_t */
+#include <stdlib.h> /* malloc, calloc, free, posix_memalign */
+
+#include "mt_hash_table.h"
+
+#define CACHE_LINE_SIZE (64)
+#define HASH_KEY(TABLE, KEY) (HashWord((TABLE)->hash_func(KEY)))
+#define COMPUTE_INDEX(TABLE, HASH) (HASH & ((TABLE)->num_buckets - 1))
+#define GET_STRIPE(TABLE, IDX) \
+(&(TABLE)->stripes[IDX & (TABLE)->stripe_mask].s)
+
+#define LOAD(PTR) (__atomic_load_n(PTR, __ATOMIC_RELAXED))
+#define LOAD_ACQ(PTR) (__atomic_load_n(PTR, __ATOMIC_ACQUIRE))
+#define STORE(PTR, VAL) (__atomic_store_n(PTR, VAL, __ATOMIC_RELAXED))
+#define STORE_REL(PTR, VAL) (__atomic_store_n(PTR, VAL, __ATOMIC_RELEASE))
+#define IS_WRITE_IN_PROGRESS(SEQ) (SEQ & 1)
+
+enum {SUCCESS, FAILURE};
+
+typedef struct mt_node
+{
+    struct mt_node *next;
+    size_t hash;
+    void *data;
+} mt_node_t;
+
+typedef struct stripe
+{
+    pthread_rwlock_t lock;
+    size_t seq;
+    size_t size;
+    mt_node_t *free_nodes;
+} stripe_t;
+
+/* every stripe sits on its own cache lines to avoid false sharing */
+typedef union padded_stripe
+{
+    stripe_t s;
+    char padding[((sizeof(stripe_t) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE)
+                                                            * CACHE_LINE_SIZE];
+} padded_stripe_t;
+
+struct mt_h_table
+{
+    size_t num_buckets;
+    size_t stripe_mask;
+    h_table_hash_t hash_func;
+    h_table_is_match_t is_match;
+    mt_node_t **buckets;
+    padded_stripe_t *stripes;
+};
+
+static void WriteBegin(stripe_t *stripe);
+static void WriteEnd(stripe_t *stripe);
+static mt_node_t **LockedLookup(const mt_h_table_t *table, mt_node_t **bucket,
+                                                const void *key, size_t hash);
+static mt_node_t *GetNode(stripe_t *stripe);
+static void FreeChain(mt_node_t *node);
+static size_t RoundUpPowerOfTwo(size_t number);
+
+mt_h_table_t *MTHashTableCreate(size_t table_size, size_t num_stripes,
+                        h_table_hash_t hash_func, h_table_is_match_t is_match)
+{
+    mt_h_table_t *new_ht = NULL;
+    size_t i = 0;
+
+    assert(NULL != hash_func);
+    assert(NULL != is_match);
+    assert(0 < table_size);
+    assert(0 < num_stripes);
+
+    table_size = RoundUpPowerOfTwo(table_size);
+    num_stripes = RoundUpPowerOfTwo(num_stripes);
+    while (1 < num_stripes && table_size < num_stripes)
+    {
+        num_stripes >>= 1;
+    }
+
+    new_ht = (mt_h_table_t *) malloc(sizeof(mt_h_table_t));
+    if (NULL == new_ht)
+    {
+        return (NULL);
+    }
+
+    /* the stripes start at a cache line, so the padding keeps them apart */
+    new_ht->buckets = (mt_node_t **) calloc(table_size, sizeof(mt_node_t *));
+    if (0 != posix_memalign((void **) &new_ht->stripes, CACHE_LINE_SIZE,
+                                    num_stripes * sizeof(padded_stripe_t)))
+    {
+        new_ht->stripes = NULL;
+    }
+
+    if (NULL == new_ht->buckets || NULL == new_ht->stripes)
+    {
+        free(new_ht->buckets);
+        free(new_ht->stripes);
+        free(new_ht);
+        return (NULL);
+    }
+
+    for (; i < num_stripes; ++i)
+    {
+        if (0 != pthread_rwlock_init(&new_ht->stripes[i].s.lock, NULL))
+        {
+            while (0 < i)
+            {
+                --i;
+                pthread_rwlock_destroy(&new_ht->stripes[i].s.lock);
+            }
+
+            free(new_ht->buckets);
+            free(new_ht->stripes);
+            free(new_ht);
+            return (NULL);
+        }
+
+        new_ht->stripes[i].s.seq = 0;
+        new_ht->stripes[i].s.size = 0;
+        new_ht->stripes[i].s.free_nodes = NULL;
+    }
+
+    new_ht->num_buckets = table_size;
+    new_ht->stripe_mask = num_stripes - 1;
+    new_ht->hash_func = hash_func;
+    new_ht->is_match = is_match;
+
+    return (new_ht);
+}
+
+void MTHashTableDestroy(mt_h_table_t *table)
+{
+    size_t i = 0;
+
+    assert(NULL != table);
+
+    for (; i < table->num_buckets; ++i)
+    {
+        FreeChain(table->buckets[i]);
+    }
+
+    for (i = 0; i <= table->stripe_mask; ++i)
+    {
+        FreeChain(table->stripes[i].s.free_nodes);
+        pthread_rwlock_destroy(&table->stripes[i].s.lock);
+    }
+
+    free(table->buckets);
+    free(table->stripes);
+    free(table);
+    table = NULL;
+}
+
+void *MTHashTableFind(const mt_h_table_t *table, const void *key)
+{
+    stripe_t *stripe = NULL;
+    mt_node_t **bucket = NULL;
+    const mt_node_t *node = NULL;
+    void *founded = NULL;
+    size_t hash = 0;
+    size_t idx = 0;
+    size_t seq = 0;
+    int is_candidate = 0;
+
+    assert(NULL != table);
+    assert(NULL != key);
+
+    hash = HASH_KEY(table, key);
+    idx = COMPUTE_INDEX(table, hash);
+    bucket = &table->buckets[idx];
+    stripe = (stripe_t *) GET_STRIPE(table, idx);
+
+    /*
+    * only the hashes are read without the lock: the data belongs to the user
+    * and may be freed as soon as it is removed. Nodes are only ever recycled,
+    * never freed, so following a stale pointer is harmless, the sequence
+    * check throws such a pass away
+    */
+    do
+    {
+        seq = LOAD_ACQ(&stripe->seq);
+        if (IS_WRITE_IN_PROGRESS(seq))
+        {
+            continue;
+        }
+
+        is_candidate = 0;
+
+        for (node = LOAD_ACQ(bucket); NULL != node && !is_candidate;
+                                                    node = LOAD(&node->next))
+        {
+            is_candidate = (hash == LOAD(&node->hash));
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (seq != LOAD(&stripe->seq))
+            {
+                break;
+            }
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    }
+    while (seq != LOAD(&stripe->seq) || IS_WRITE_IN_PROGRESS(seq));
+
+    /* a key that is missing is known to be missing without the lock */
+    if (!is_candidate)
+    {
+        return (NULL);
+    }
+
+    /* readers of the same stripe compare their data side by side */
+    pthread_rwlock_rdlock(&stripe->lock);
+
+    node = *LockedLookup(table, bucket, key, hash);
+    if (NULL != node)
+    {
+        founded = node->data;
+    }
+
+    pthread_rwlock_unlock(&stripe->lock);
+
+    return (founded);
+}
+
+int MTHashTableInsert(mt_h_table_t *table, void *data)
+{
+    stripe_t *stripe = NULL;
+    mt_node_t **bucket = NULL;
+    mt_node_t **link = NULL;
+    mt_node_t *new_node = NULL;
+    size_t hash = 0;
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != data);
+
+    hash = HASH_KEY(table, data);
+    idx = COMPUTE_INDEX(table, hash);
+    bucket = &table->buckets[idx];
+    stripe = GET_STRIPE(table, idx);
+
+    pthread_rwlock_wrlock(&stripe->lock);
+
+    link = LockedLookup(table, bucket, data, hash);
+    if (NULL != *link)
+    {
+        WriteBegin(stripe);
+        STORE(&(*link)->data, data);
+        WriteEnd(stripe);
+
+        pthread_rwlock_unlock(&stripe->lock);
+
+        return (SUCCESS);
+    }
+
+    new_node = GetNode(stripe);
+    if (NULL == new_node)
+    {
+        pthread_rwlock_unlock(&stripe->lock);
+
+        return (FAILURE);
+    }
+
+    WriteBegin(stripe);
+    STORE(&new_node->hash, hash);
+    STORE(&new_node->data, data);
+    STORE(&new_node->next, *bucket);
+    STORE_REL(bucket, new_node);
+    STORE(&stripe->size, stripe->size + 1);
+    WriteEnd(stripe);
+
+    pthread_rwlock_unlock(&stripe->lock);
+
+    return (SUCCESS);
+}
+
+void *MTHashTableRemove(mt_h_table_t *table, const void *key)
+{
+    stripe_t *stripe = NULL;
+    mt_node_t **link = NULL;
+    mt_node_t *founded_node = NULL;
+    void *removed = NULL;
+    size_t hash = 0;
+    size_t idx = 0;
+
+    assert(NULL != table);
+    assert(NULL != key);
+
+    hash = HASH_KEY(table, key);
+    idx = COMPUTE_INDEX(table, hash);
+    stripe = GET_STRIPE(table, idx);
+
+    pthread_rwlock_wrlock(&stripe->lock);
+
+    link = LockedLookup(table, &table->buckets[idx], key, hash);
+    founded_node = *link;
+
+    if (NULL != founded_node)
+    {
+        removed = founded_node->data;
+
+        WriteBegin(stripe);
+        STORE(link, founded_node->next);
+        STORE(&stripe->size, stripe->size - 1);
+        WriteEnd(stripe);
+
+        /* the node may still be read by lookups, keep it for reuse */
+        STORE(&founded_node->next, stripe->free_nodes);
+        stripe->free_nodes = founded_node;
+    }
+
+    pthread_rwlock_unlock(&stripe->lock);
+
+    return (removed);
+}
+
+size_t MTHashTableSize(const mt_h_table_t *table)
+{
+    size_t counter = 0;
+    size_t i = 0;
+
+    assert(NULL != table);
+
+    for (; i <= table->stripe_mask; ++i)
+    {
+        counter += LOAD(&table->stripes[i].s.size);
+    }
+
+    return (counter);
+}
+
+int MTHashTableIsEmpty(const mt_h_table_t *table)
+{
+    assert(NULL != table);
+
+    return (0 == MTHashTableSize(table));
+}
+
+int MTHashTableForEach(mt_h_table_t *table, h_table_action_t action,
+                                                                void *param)
+{
+    stripe_t *stripe = NULL;
+    mt_node_t *node = NULL;
+    size_t i = 0;
+    size_t idx = 0;
+    int status = 0;
+
+    assert(NULL != table);
+    assert(NULL != action);
+
+    for (; i <= table->stripe_mask && 0 == status; ++i)
+    {
+        stripe = &table->stripes[i].s;
+
+        pthread_rwlock_wrlock(&stripe->lock);
+
+        for (idx = i; idx < table->num_buckets && 0 == status;
+                                                idx += table->stripe_mask + 1)
+        {
+            for (node = table->buckets[idx]; NULL != node && 0 == status;
+                                                            node = node->next)
+            {
+                status = action(node->data, param);
+            }
+        }
+
+        pthread_rwlock_unlock(&stripe->lock);
+    }
+
+    return (status);
+}
+
+static void WriteBegin(stripe_t *stripe)
+{
+    assert(NULL != stripe);
+
+    STORE(&stripe->seq, stripe->seq + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void WriteEnd(stripe_t *stripe)
+{
+    assert(NULL != stripe);
+
+    STORE_REL(&stripe->seq, stripe->seq + 1);
+}
+
+static mt_node_t **LockedLookup(const mt_h_table_t *table, mt_node_t **bucket,
+                                                const void *key, size_t hash)
+{
+    mt_node_t **link = NULL;
+
+    assert(NULL != table);
+    assert(NULL != bucket);
+
+    for (link = bucket; NULL != *link; link = &(*link)->next)
+    {
+        if (hash == (*link)->hash && table->is_match((*link)->data, key))
+        {
+            break;
+        }
+    }
+
+    return (link);
+}
+
+static mt_node_t *GetNode(stripe_t *stripe)
+{
+    mt_node_t *node = NULL;
+
+    assert(NULL != stripe);
+
+    node = stripe->free_nodes;
+
+    if (NULL != node)
+    {
+        stripe->free_nodes = node->next;
+        return (node);
+    }
+
+    return ((mt_node_t *) malloc(sizeof(mt_node_t)));
+}
+
+static void FreeChain(mt_node_t *node)
+{
+    mt_node_t *next = NULL;
+
+    for (; NULL != node; node = next)
+    {
+        next = node->next;
+        free(node);
+    }
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
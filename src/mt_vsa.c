@@ -0,0 +1,388 @@
+/*******************************************************************************
+*
+* FILENAME : mt_vsa.c
+*
+* DESCRIPTION : Thread-safe variable-size allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+#include <pthread.h> /* pthread_mutex_t, pthread_key_t */
+#include <stdlib.h> /* malloc, free */
+
+#include "mt_vsa.h"
+#include "vsa.h"
+
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+#define MIN_LOG (4)
+#define MAX_LOG (12)
+#define NUM_CLASSES (MAX_LOG - MIN_LOG + 1)
+#define CLASS_SIZE(CLASS) ((size_t) 1 << ((CLASS) + MIN_LOG))
+#define CACHE_CAPACITY (32)
+#define BATCH_SIZE (CACHE_CAPACITY / 2)
+/* a refill takes at most a block of the largest class worth of bytes */
+#define REFILL_BYTES (CLASS_SIZE(NUM_CLASSES - 1))
+#define REFILL_COUNT(CLASS) \
+(BATCH_SIZE * CLASS_SIZE(CLASS) < REFILL_BYTES ? \
+BATCH_SIZE : REFILL_BYTES / CLASS_SIZE(CLASS))
+
+typedef struct thread_cache thread_cache_t;
+
+struct thread_cache
+{
+    mt_vsa_t *owner;
+    thread_cache_t *next;
+    thread_cache_t *prev;
+    size_t counts[NUM_CLASSES];
+    void *blocks[NUM_CLASSES][CACHE_CAPACITY];
+};
+
+/* caches is the list of the caches of all the threads, guarded by lock */
+struct mt_vsa
+{
+    pthread_mutex_t lock;
+    pthread_key_t cache_key;
+    vsa_t *vsa;
+    thread_cache_t *caches;
+};
+
+static thread_cache_t *GetCache(mt_vsa_t *mt_vsa);
+static void DestroyCache(void *cache_to_destroy);
+static void Refill(mt_vsa_t *mt_vsa, thread_cache_t *cache, size_t class);
+static void Drain(mt_vsa_t *mt_vsa, thread_cache_t *cache, size_t class,
+                                                            size_t num_blocks);
+static void *LockedAlloc(mt_vsa_t *mt_vsa, size_t bytes);
+static void LockedFree(mt_vsa_t *mt_vsa, void *block);
+static size_t FloorLog2(size_t number);
+
+mt_vsa_t *MTVSACreate(size_t pool_size, void *memory_pool)
+{
+    mt_vsa_t *mt_vsa = NULL;
+
+    assert(NULL != memory_pool);
+
+    mt_vsa = (mt_vsa_t *) malloc(sizeof(mt_vsa_t));
+    if (NULL == mt_vsa)
+    {
+        return (NULL);
+    }
+
+    /*
+    * a tagged vsa would set a flag in the header of an allocated block when
+    * its neighbour is freed, while the owner reads the size of the block
+    * without the lock, so the plain one is used
+    */
+    mt_vsa->vsa = VSAInit(pool_size, memory_pool);
+    if (NULL == mt_vsa->vsa || 0 != pthread_mutex_init(&mt_vsa->lock, NULL))
+    {
+        free(mt_vsa);
+        return (NULL);
+    }
+
+    if (0 != pthread_key_create(&mt_vsa->cache_key, DestroyCache))
+    {
+        pthread_mutex_destroy(&mt_vsa->lock);
+        free(mt_vsa);
+        return (NULL);
+    }
+
+    mt_vsa->caches = NULL;
+
+    return (mt_vsa);
+}
+
+void MTVSADestroy(mt_vsa_t *mt_vsa)
+{
+    thread_cache_t *next = NULL;
+
+    assert(NULL != mt_vsa);
+
+    /* the destructors are not called for a deleted key */
+    pthread_key_delete(mt_vsa->cache_key);
+
+    while (NULL != mt_vsa->caches)
+    {
+        next = mt_vsa->caches->next;
+        free(mt_vsa->caches);
+        mt_vsa->caches = next;
+    }
+
+    pthread_mutex_destroy(&mt_vsa->lock);
+    free(mt_vsa);
+}
+
+void *MTVSAAlloc(mt_vsa_t *mt_vsa, size_t bytes)
+{
+    thread_cache_t *cache = NULL;
+    size_t class = 0;
+
+    assert(NULL != mt_vsa);
+    assert(0 < bytes);
+
+    if (CLASS_SIZE(NUM_CLASSES - 1) < bytes)
+    {
+        return (LockedAlloc(mt_vsa, bytes));
+    }
+
+    if (CLASS_SIZE(0) < bytes)
+    {
+        class = FloorLog2(bytes - 1) + 1 - MIN_LOG;
+    }
+
+    cache = GetCache(mt_vsa);
+    if (NULL == cache)
+    {
+        return (LockedAlloc(mt_vsa, CLASS_SIZE(class)));
+    }
+
+    if (0 == cache->counts[class])
+    {
+        Refill(mt_vsa, cache, class);
+
+        /* no block of the whole class is left, one of the exact size may be */
+        if (0 == cache->counts[class])
+        {
+            return (LockedAlloc(mt_vsa, bytes));
+        }
+    }
+
+    --cache->counts[class];
+
+    return (cache->blocks[class][cache->counts[class]]);
+}
+
+void MTVSAFree(mt_vsa_t *mt_vsa, void *block_to_free)
+{
+    thread_cache_t *cache = NULL;
+    size_t log = 0;
+    size_t class = 0;
+
+    assert(NULL != mt_vsa);
+    assert(NULL != block_to_free);
+
+    /* a block may be larger than it was asked for, its class is rounded down */
+    log = FloorLog2(VSABlockSize(block_to_free));
+    cache = GetCache(mt_vsa);
+
+    if (MIN_LOG > log || MAX_LOG < log || NULL == cache)
+    {
+        LockedFree(mt_vsa, block_to_free);
+        return;
+    }
+
+    class = log - MIN_LOG;
+
+    if (CACHE_CAPACITY == cache->counts[class])
+    {
+        Drain(mt_vsa, cache, class, BATCH_SIZE);
+    }
+
+    cache->blocks[class][cache->counts[class]] = block_to_free;
+    ++cache->counts[class];
+}
+
+void MTVSAFlushCache(mt_vsa_t *mt_vsa)
+{
+    thread_cache_t *cache = NULL;
+    size_t class = 0;
+
+    assert(NULL != mt_vsa);
+
+    cache = (thread_cache_t *) pthread_getspecific(mt_vsa->cache_key);
+    if (NULL == cache)
+    {
+        return;
+    }
+
+    for (; class < NUM_CLASSES; ++class)
+    {
+        Drain(mt_vsa, cache, class, cache->counts[class]);
+    }
+}
+
+size_t MTVSALargestChunkAvailable(mt_vsa_t *mt_vsa)
+{
+    size_t largest_chunk = 0;
+
+    assert(NULL != mt_vsa);
+
+    pthread_mutex_lock(&mt_vsa->lock);
+    largest_chunk = VSALargestChunkAvailable(mt_vsa->vsa);
+    pthread_mutex_unlock(&mt_vsa->lock);
+
+    return (largest_chunk);
+}
+
+static thread_cache_t *GetCache(mt_vsa_t *mt_vsa)
+{
+    thread_cache_t *cache = NULL;
+    size_t class = 0;
+
+    cache = (thread_cache_t *) pthread_getspecific(mt_vsa->cache_key);
+    if (NULL != cache)
+    {
+        return (cache);
+    }
+
+    /* without a cache the thread goes to the shared pool every time */
+    cache = (thread_cache_t *) malloc(sizeof(thread_cache_t));
+    if (NULL == cache)
+    {
+        return (NULL);
+    }
+
+    if (0 != pthread_setspecific(mt_vsa->cache_key, cache))
+    {
+        free(cache);
+        return (NULL);
+    }
+
+    for (; class < NUM_CLASSES; ++class)
+    {
+        cache->counts[class] = 0;
+    }
+
+    cache->owner = mt_vsa;
+    cache->prev = NULL;
+
+    pthread_mutex_lock(&mt_vsa->lock);
+
+    cache->next = mt_vsa->caches;
+    if (NULL != cache->next)
+    {
+        cache->next->prev = cache;
+    }
+    mt_vsa->caches = cache;
+
+    pthread_mutex_unlock(&mt_vsa->lock);
+
+    return (cache);
+}
+
+/* called at the exit of the thread that owns the cache */
+static void DestroyCache(void *cache_to_destroy)
+{
+    thread_cache_t *cache = (thread_cache_t *) cache_to_destroy;
+    mt_vsa_t *mt_vsa = cache->owner;
+    size_t class = 0;
+    size_t i = 0;
+
+    pthread_mutex_lock(&mt_vsa->lock);
+
+    for (; class < NUM_CLASSES; ++class)
+    {
+        for (i = 0; i < cache->counts[class]; ++i)
+        {
+            VSAFree(cache->blocks[class][i]);
+        }
+    }
+
+    if (NULL != cache->next)
+    {
+        cache->next->prev = cache->prev;
+    }
+
+    if (NULL != cache->prev)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        mt_vsa->caches = cache->next;
+    }
+
+    pthread_mutex_unlock(&mt_vsa->lock);
+
+    free(cache);
+}
+
+static void Refill(mt_vsa_t *mt_vsa, thread_cache_t *cache, size_t class)
+{
+    void *block = NULL;
+
+    pthread_mutex_lock(&mt_vsa->lock);
+
+    while (REFILL_COUNT(class) > cache->counts[class])
+    {
+        block = VSAAlloc(mt_vsa->vsa, CLASS_SIZE(class));
+        if (NULL == block)
+        {
+            break;
+        }
+
+        cache->blocks[class][cache->counts[class]] = block;
+        ++cache->counts[class];
+    }
+
+    pthread_mutex_unlock(&mt_vsa->lock);
+}
+
+/* the oldest blocks go first, the recently freed ones are kept warm */
+static void Drain(mt_vsa_t *mt_vsa, thread_cache_t *cache, size_t class,
+                                                            size_t num_blocks)
+{
+    size_t i = 0;
+
+    if (0 == num_blocks)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&mt_vsa->lock);
+
+    for (; i < num_blocks; ++i)
+    {
+        VSAFree(cache->blocks[class][i]);
+    }
+
+    pthread_mutex_unlock(&mt_vsa->lock);
+
+    for (i = num_blocks; i < cache->counts[class]; ++i)
+    {
+        cache->blocks[class][i - num_blocks] = cache->blocks[class][i];
+    }
+
+    cache->counts[class] -= num_blocks;
+}
+
+static void *LockedAlloc(mt_vsa_t *mt_vsa, size_t bytes)
+{
+    void *block = NULL;
+
+    pthread_mutex_lock(&mt_vsa->lock);
+    block = VSAAlloc(mt_vsa->vsa, bytes);
+    pthread_mutex_unlock(&mt_vsa->lock);
+
+    return (block);
+}
+
+static void LockedFree(mt_vsa_t *mt_vsa, void *block)
+{
+    pthread_mutex_lock(&mt_vsa->lock);
+    VSAFree(block);
+    pthread_mutex_unlock(&mt_vsa->lock);
+}
+
+static size_t FloorLog2(size_t number)
+{
+    size_t log = 0;
+    size_t shift = WORD_BITS / 2;
+
+    assert(0 < number);
+
+    for (; 0 < shift; shift /= 2)
+    {
+        if (0 != (number >> shift))
+        {
+            number >>= shift;
+            log += shift;
+        }
+    }
+
+    return (log);
+}
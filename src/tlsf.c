@@ -0,0 +1,428 @@
+/*******************************************************************************
+*
+* FILENAME : tlsf.c
+*
+* DESCRIPTION : Two-level segregated fit allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+
+#include "tlsf.h"
+
+enum {FALSE, TRUE};
+
+#define DGB_TLSF_MAGIC_NUMBER (0xDEADBABE)
+#define WORD_SIZE (sizeof(size_t))
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+#define ALIGN_MASK (WORD_SIZE - 1)
+#define ALIGN_LOG (sizeof(size_t) == 8 ? 3 : 2)
+#define HEADER_STRUCT_SIZE (sizeof(struct block_header))
+#define TLSF_STRUCT_SIZE (sizeof(struct tlsf))
+/* the links of a free block, then its size repeated in the last word */
+#define MIN_BLOCK_SIZE (sizeof(struct free_links) + WORD_SIZE)
+
+/* every power of two of the sizes is split into SL_COUNT lists */
+#define SL_LOG (4)
+#define SL_COUNT (1 << SL_LOG)
+/* below SMALL_BLOCK_SIZE the lists are one word apart, all on level 0 */
+#define FL_SHIFT (SL_LOG + ALIGN_LOG)
+#define SMALL_BLOCK_SIZE ((size_t) 1 << FL_SHIFT)
+#define FL_INDEX_MAX (sizeof(size_t) == 8 ? 40 : 30)
+#define FL_COUNT (FL_INDEX_MAX - FL_SHIFT + 1)
+#define MAX_BLOCK_SIZE ((size_t) 1 << FL_INDEX_MAX)
+
+#define ALLOC_FLAG (1)
+/* set in the header of a block that follows a free block */
+#define PREV_FREE_FLAG (2)
+#define FLAGS_MASK (ALLOC_FLAG | PREV_FREE_FLAG)
+
+#define ALIGN_NUMBER(NUMBER) (((NUMBER) + ALIGN_MASK) & ~ALIGN_MASK)
+#define BLOCK_SIZE(HEADER) ((HEADER)->block_size & ~FLAGS_MASK)
+#define IS_BLOCK_FREE(HEADER) (0 == ((HEADER)->block_size & ALLOC_FLAG))
+#define PAYLOAD(HEADER) ((char *) (HEADER) + HEADER_STRUCT_SIZE)
+#define LINKS(HEADER) ((free_links_t *) PAYLOAD(HEADER))
+#define NEXT_HEADER(HEADER) \
+((block_t *) (PAYLOAD(HEADER) + BLOCK_SIZE(HEADER)))
+#define FOOTER(HEADER) ((size_t *) NEXT_HEADER(HEADER) - 1)
+#define GET_TLSF(HEADER) \
+((tlsf_t *) ((char *) (HEADER) - (HEADER)->tlsf_offset))
+
+typedef struct block_header block_t;
+typedef struct free_links free_links_t;
+
+struct block_header
+{
+    size_t block_size;
+    size_t tlsf_offset;
+};
+
+/* kept in the first bytes of a free block */
+struct free_links
+{
+    block_t *next;
+    block_t *prev;
+};
+
+/*
+* the bits of fl_bitmap tell which first level has a non-empty list, the bits
+* of sl_bitmaps[fl] tell which lists of that level are not empty
+*/
+struct tlsf
+{
+    size_t fl_bitmap;
+    unsigned int sl_bitmaps[FL_COUNT];
+    block_t *free_lists[FL_COUNT][SL_COUNT];
+
+    #ifndef NDEBUG
+    size_t magic_number;
+    #endif
+};
+
+static void Mapping(size_t size, size_t *fl, size_t *sl);
+static block_t *FindSuitableBlock(tlsf_t *tlsf, size_t size);
+static void UseBlock(tlsf_t *tlsf, block_t *block, size_t size);
+static void InsertBlock(tlsf_t *tlsf, block_t *block);
+static void RemoveBlock(tlsf_t *tlsf, block_t *block);
+static void TagFreeBlock(block_t *block);
+static void InitializeHeader(tlsf_t *tlsf, block_t *block, size_t size);
+static size_t FloorLog2(size_t number);
+static size_t LowestBit(size_t number);
+
+tlsf_t *TLSFInit(size_t pool_size, void *memory_pool)
+{
+    tlsf_t *tlsf = NULL;
+    block_t *first_block = NULL;
+    block_t *sentinel = NULL;
+    size_t i = 0;
+    size_t j = 0;
+
+    assert(NULL != memory_pool);
+    assert(0 == ((size_t) memory_pool & ALIGN_MASK));
+
+    pool_size &= ~ALIGN_MASK;
+
+    /* the size of the first block must map to one of the lists */
+    if (TLSFSuggestSize(0) > pool_size ||
+                            pool_size - TLSFSuggestSize(0) >= MAX_BLOCK_SIZE)
+    {
+        return (NULL);
+    }
+
+    tlsf = (tlsf_t *) memory_pool;
+    tlsf->fl_bitmap = 0;
+
+    for (; i < FL_COUNT; ++i)
+    {
+        tlsf->sl_bitmaps[i] = 0;
+
+        for (j = 0; j < SL_COUNT; ++j)
+        {
+            tlsf->free_lists[i][j] = NULL;
+        }
+    }
+
+    #ifndef NDEBUG
+    tlsf->magic_number = DGB_TLSF_MAGIC_NUMBER;
+    #endif
+
+    /* a zero-size block in use closes the pool, it is never merged */
+    first_block = (block_t *) ((char *) tlsf + TLSF_STRUCT_SIZE);
+    sentinel = (block_t *) ((char *) memory_pool + pool_size -
+                                                        HEADER_STRUCT_SIZE);
+
+    InitializeHeader(tlsf, first_block, (char *) sentinel -
+                                                    PAYLOAD(first_block));
+    InitializeHeader(tlsf, sentinel, ALLOC_FLAG);
+
+    if (BLOCK_SIZE(first_block) < MIN_BLOCK_SIZE)
+    {
+        first_block->block_size |= ALLOC_FLAG;
+    }
+    else
+    {
+        InsertBlock(tlsf, first_block);
+        TagFreeBlock(first_block);
+    }
+
+    return (tlsf);
+}
+
+void *TLSFAlloc(tlsf_t *tlsf, size_t bytes)
+{
+    block_t *block = NULL;
+
+    assert(NULL != tlsf);
+    assert(0 < bytes);
+
+    if (MAX_BLOCK_SIZE <= bytes)
+    {
+        return (NULL);
+    }
+
+    bytes = ALIGN_NUMBER(bytes);
+    if (bytes < MIN_BLOCK_SIZE)
+    {
+        bytes = MIN_BLOCK_SIZE;
+    }
+
+    block = FindSuitableBlock(tlsf, bytes);
+    if (NULL == block)
+    {
+        return (NULL);
+    }
+
+    UseBlock(tlsf, block, bytes);
+
+    return (PAYLOAD(block));
+}
+
+void TLSFFree(void *block_to_free)
+{
+    tlsf_t *tlsf = NULL;
+    block_t *header = NULL;
+    block_t *neighbour = NULL;
+    size_t is_prev_free = 0;
+
+    assert(NULL != block_to_free);
+
+    header = (block_t *) ((char *) block_to_free - HEADER_STRUCT_SIZE);
+    tlsf = GET_TLSF(header);
+
+    assert(DGB_TLSF_MAGIC_NUMBER == tlsf->magic_number);
+    assert(FALSE == IS_BLOCK_FREE(header));
+
+    is_prev_free = header->block_size & PREV_FREE_FLAG;
+    header->block_size = BLOCK_SIZE(header);
+
+    neighbour = NEXT_HEADER(header);
+    if (TRUE == IS_BLOCK_FREE(neighbour))
+    {
+        RemoveBlock(tlsf, neighbour);
+        header->block_size += HEADER_STRUCT_SIZE + neighbour->block_size;
+    }
+
+    /* the footer of the preceding free block leads to its header */
+    if (0 != is_prev_free)
+    {
+        neighbour = (block_t *) ((char *) header - *((size_t *) header - 1) -
+                                                        HEADER_STRUCT_SIZE);
+        RemoveBlock(tlsf, neighbour);
+        neighbour->block_size += HEADER_STRUCT_SIZE + header->block_size;
+        header = neighbour;
+    }
+
+    InsertBlock(tlsf, header);
+    TagFreeBlock(header);
+}
+
+size_t TLSFLargestChunkAvailable(const tlsf_t *tlsf)
+{
+    const block_t *runner = NULL;
+    size_t max_available_size = 0;
+    size_t fl = 0;
+
+    assert(NULL != tlsf);
+
+    if (0 == tlsf->fl_bitmap)
+    {
+        return (0);
+    }
+
+    /* the largest block is on the highest non-empty list */
+    fl = FloorLog2(tlsf->fl_bitmap);
+    runner = tlsf->free_lists[fl][FloorLog2(tlsf->sl_bitmaps[fl])];
+
+    for (; NULL != runner; runner = LINKS(runner)->next)
+    {
+        if (runner->block_size > max_available_size)
+        {
+            max_available_size = runner->block_size;
+        }
+    }
+
+    return (max_available_size);
+}
+
+size_t TLSFSuggestSize(size_t bytes)
+{
+    bytes = ALIGN_NUMBER(bytes);
+    if (0 < bytes && bytes < MIN_BLOCK_SIZE)
+    {
+        bytes = MIN_BLOCK_SIZE;
+    }
+
+    return (TLSF_STRUCT_SIZE + (HEADER_STRUCT_SIZE * 2) + bytes);
+}
+
+static void Mapping(size_t size, size_t *fl, size_t *sl)
+{
+    if (size < SMALL_BLOCK_SIZE)
+    {
+        *fl = 0;
+        *sl = size >> ALIGN_LOG;
+    }
+    else
+    {
+        *fl = FloorLog2(size);
+        *sl = (size >> (*fl - SL_LOG)) ^ SL_COUNT;
+        *fl -= FL_SHIFT - 1;
+    }
+}
+
+static block_t *FindSuitableBlock(tlsf_t *tlsf, size_t size)
+{
+    size_t fl = 0;
+    size_t sl = 0;
+    size_t fl_map = 0;
+    size_t sl_map = 0;
+
+    /* rounded up to the next list, every block from there on fits */
+    if (SMALL_BLOCK_SIZE <= size)
+    {
+        size += ((size_t) 1 << (FloorLog2(size) - SL_LOG)) - 1;
+    }
+
+    Mapping(size, &fl, &sl);
+    if (FL_COUNT <= fl)
+    {
+        return (NULL);
+    }
+
+    sl_map = tlsf->sl_bitmaps[fl] & (~0U << sl);
+    if (0 == sl_map)
+    {
+        if (FL_COUNT <= fl + 1)
+        {
+            return (NULL);
+        }
+
+        fl_map = tlsf->fl_bitmap & (~(size_t) 0 << (fl + 1));
+        if (0 == fl_map)
+        {
+            return (NULL);
+        }
+
+        fl = LowestBit(fl_map);
+        sl_map = tlsf->sl_bitmaps[fl];
+    }
+
+    return (tlsf->free_lists[fl][LowestBit(sl_map)]);
+}
+
+static void UseBlock(tlsf_t *tlsf, block_t *block, size_t size)
+{
+    block_t *remainder = NULL;
+    size_t remain_size = block->block_size - size;
+
+    RemoveBlock(tlsf, block);
+
+    if (remain_size < HEADER_STRUCT_SIZE + MIN_BLOCK_SIZE)
+    {
+        block->block_size |= ALLOC_FLAG;
+        NEXT_HEADER(block)->block_size &= ~PREV_FREE_FLAG;
+    }
+    else
+    {
+        block->block_size = size | ALLOC_FLAG;
+
+        remainder = NEXT_HEADER(block);
+        InitializeHeader(tlsf, remainder, remain_size - HEADER_STRUCT_SIZE);
+        InsertBlock(tlsf, remainder);
+        TagFreeBlock(remainder);
+    }
+}
+
+static void InsertBlock(tlsf_t *tlsf, block_t *block)
+{
+    free_links_t *links = LINKS(block);
+    size_t fl = 0;
+    size_t sl = 0;
+
+    Mapping(block->block_size, &fl, &sl);
+
+    links->prev = NULL;
+    links->next = tlsf->free_lists[fl][sl];
+
+    if (NULL != links->next)
+    {
+        LINKS(links->next)->prev = block;
+    }
+
+    tlsf->free_lists[fl][sl] = block;
+    tlsf->sl_bitmaps[fl] |= 1U << sl;
+    tlsf->fl_bitmap |= (size_t) 1 << fl;
+}
+
+static void RemoveBlock(tlsf_t *tlsf, block_t *block)
+{
+    free_links_t *links = LINKS(block);
+    size_t fl = 0;
+    size_t sl = 0;
+
+    Mapping(block->block_size, &fl, &sl);
+
+    if (NULL != links->next)
+    {
+        LINKS(links->next)->prev = links->prev;
+    }
+
+    if (NULL != links->prev)
+    {
+        LINKS(links->prev)->next = links->next;
+        return;
+    }
+
+    tlsf->free_lists[fl][sl] = links->next;
+
+    if (NULL == links->next)
+    {
+        tlsf->sl_bitmaps[fl] &= ~(1U << sl);
+
+        if (0 == tlsf->sl_bitmaps[fl])
+        {
+            tlsf->fl_bitmap &= ~((size_t) 1 << fl);
+        }
+    }
+}
+
+static void TagFreeBlock(block_t *block)
+{
+    *FOOTER(block) = block->block_size;
+    NEXT_HEADER(block)->block_size |= PREV_FREE_FLAG;
+}
+
+static void InitializeHeader(tlsf_t *tlsf, block_t *block, size_t size)
+{
+    block->block_size = size;
+    block->tlsf_offset = (char *) block - (char *) tlsf;
+}
+
+static size_t FloorLog2(size_t number)
+{
+    size_t log = 0;
+    size_t shift = WORD_BITS / 2;
+
+    assert(0 < number);
+
+    for (; 0 < shift; shift /= 2)
+    {
+        if (0 != (number >> shift))
+        {
+            number >>= shift;
+            log += shift;
+        }
+    }
+
+    return (log);
+}
+
+static size_t LowestBit(size_t number)
+{
+    return (FloorLog2(number & (~number + 1)));
+}
@@ -11,6 +11,8 @@
 *******************************************************************************/
 
 #include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT */
+#include <string.h> /* memcpy */
 
 #include "vsa.h"
 
@@ -18,11 +20,23 @@
 enum {FALSE, TRUE};
 
 #define END_MAGIC_NUMBER (0xDEADBEEF)
-#define DGB_HEADER_MAGIC_NUMBER (0xDEADBABE)
+#define DGB_VSA_MAGIC_NUMBER (0xDEADBABE)
 #define HEADER_STRUCT_SIZE (sizeof(struct block_header))
+#define VSA_STRUCT_SIZE (sizeof(struct vsa))
 #define WORD_SIZE (sizeof(unsigned long))
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
 #define ALLOC_FLAG (1)
+/* set in the header of a block of a tagged vsa that follows a free block */
+#define PREV_FREE_FLAG (2)
+#define FLAGS_MASK (ALLOC_FLAG | PREV_FREE_FLAG)
 #define ALIGN_MASK ((WORD_SIZE - 1))
+/* a free block is put on a list only if its links fit in it */
+#define MIN_LISTED_SIZE (sizeof(struct free_links))
+#define MAX_CLASS_PROBES (8)
+/* a free block of a tagged vsa also keeps its size in its last word */
+#define MIN_TAGGED_SIZE (MIN_LISTED_SIZE + WORD_SIZE)
+#define MIN_BLOCK_SIZE(VSA) \
+(TRUE == (VSA)->is_tagged ? MIN_TAGGED_SIZE : WORD_SIZE)
 
 #define IS_MEMORY_ALIGN(POINTER) \
 (0 == ((unsigned long) POINTER & ALIGN_MASK))
@@ -38,47 +52,149 @@ enum {FALSE, TRUE};
 #define IS_BLOCK_FREE(HEADER) \
 (TRUE == IS_NUMBER_EVEN(HEADER->block_size))
 
-#define DEFLAG_SIZE(BLOCK_SIZE) (BLOCK_SIZE & ~ALLOC_FLAG)
+#define DEFLAG_SIZE(BLOCK_SIZE) (BLOCK_SIZE & ~FLAGS_MASK)
+
+#define IS_POWER_OF_TWO(NUMBER) (0 == ((NUMBER) & ((NUMBER) - 1)))
+
+#define FIRST_BLOCK(VSA) ((block_t *) ((char *) (VSA) + VSA_STRUCT_SIZE))
+
+#define LINKS(HEADER) \
+((free_links_t *) ((char *) (HEADER) + HEADER_STRUCT_SIZE))
+
+#define GET_VSA(HEADER) ((vsa_t *) ((char *) (HEADER) - (HEADER)->vsa_offset))
+
+#define FOOTER(HEADER) \
+((size_t *) ((char *) (HEADER) + HEADER_STRUCT_SIZE + (HEADER)->block_size) - 1)
 
 typedef struct block_header block_t;
+typedef struct free_links free_links_t;
 
 struct block_header
 {
     size_t block_size;
+    size_t vsa_offset;
+};
+
+/* kept in the first bytes of a listed free block */
+struct free_links
+{
+    block_t *next;
+    block_t *prev;
+};
+
+/*
+* free blocks are kept on lists by the power of two of their size, the bits of
+* free_classes tell which of the lists are not empty. stats is updated with
+* every change of a block, free_histogram and class_bytes hold the amount of
+* free blocks and free bytes of every class, the orphans included
+*/
+struct vsa
+{
+    size_t free_classes;
+    block_t *free_lists[sizeof(size_t) * CHAR_BIT];
+    int is_tagged;
+    vsa_stats_t stats;
+    size_t free_histogram[sizeof(size_t) * CHAR_BIT];
+    size_t class_bytes[sizeof(size_t) * CHAR_BIT];
 
     #ifndef NDEBUG
     size_t magic_number;
     #endif
 };
 
-static block_t *DefragFindSpace(vsa_t *header, size_t req_size);
+static vsa_t *InitVSA(size_t pool_size, void *memory_pool, int is_tagged);
+static size_t AdjustRequest(vsa_t *vsa, size_t bytes);
+static block_t *FindFreeBlock(vsa_t *vsa, size_t req_size);
+static void SplitTail(vsa_t *vsa, block_t *header, size_t size);
+static void CountInUse(vsa_t *vsa, size_t old_size, size_t new_size);
+static size_t LargestListedBlock(const vsa_t *vsa);
+static block_t *DefragFindSpace(vsa_t *vsa, size_t req_size);
+static void MergeBlocks(vsa_t *vsa, block_t *chunk_start, block_t *block);
+static void LinkBlock(vsa_t *vsa, block_t *block);
+static void UnlinkBlock(vsa_t *vsa, block_t *block);
+static void TagFreeBlock(block_t *block);
+static block_t *GetPrevHeader(block_t *block);
+static size_t FloorLog2(size_t number);
 static block_t *AccessHeader(block_t *block);
-static void InitializeHeader(block_t *block, size_t size);
-static void InitializeBlock(block_t *header, size_t alloc_size);
+static void InitializeHeader(vsa_t *vsa, block_t *block, size_t size);
+static void InitializeBlock(vsa_t *vsa, block_t *header, size_t alloc_size);
 static block_t *GetNextHeader(block_t *block);
 static size_t GetWholeBlockSize(block_t *block);
 
 vsa_t *VSAInit(size_t pool_size, void *memory_pool)
 {
+	return (InitVSA(pool_size, memory_pool, FALSE));
+}
+
+vsa_t *VSAInitTagged(size_t pool_size, void *memory_pool)
+{
+	return (InitVSA(pool_size, memory_pool, TRUE));
+}
+
+static vsa_t *InitVSA(size_t pool_size, void *memory_pool, int is_tagged)
+{
+	vsa_t *vsa = NULL;
 	block_t *header = NULL;
 	block_t *footer = NULL;
+	size_t i = 0;
 
 	assert(NULL != memory_pool);
 	assert(TRUE == IS_MEMORY_ALIGN(memory_pool));
-	assert(0 < pool_size);
 
-	if (!IS_NUMBER_EVEN(pool_size))
+	pool_size = pool_size & ~ALIGN_MASK;
+
+	/* the lists and the first and last headers would not fit */
+	if (VSASuggestSize(0) > pool_size)
+	{
+		return (NULL);
+	}
+
+	vsa = memory_pool;
+	vsa->free_classes = 0;
+	vsa->is_tagged = is_tagged;
+	vsa->stats.live_blocks = 0;
+	vsa->stats.free_blocks = 0;
+	vsa->stats.bytes_in_use = 0;
+	vsa->stats.free_bytes = 0;
+	vsa->stats.high_water_mark = 0;
+	vsa->stats.num_allocs = 0;
+	vsa->stats.num_frees = 0;
+	vsa->stats.fragmentation = 0;
+
+	for (; i < WORD_BITS; ++i)
+	{
+		vsa->free_lists[i] = NULL;
+		vsa->free_histogram[i] = 0;
+		vsa->class_bytes[i] = 0;
+	}
+
+	#ifndef NDEBUG
+	vsa->magic_number = DGB_VSA_MAGIC_NUMBER;
+	#endif
+
+	header = FIRST_BLOCK(vsa);
+	footer = (block_t *) ((char *) memory_pool + (pool_size - HEADER_STRUCT_SIZE));
+
+	InitializeHeader(vsa, header,
+				pool_size - VSA_STRUCT_SIZE - (HEADER_STRUCT_SIZE * 2));
+	InitializeHeader(vsa, footer, END_MAGIC_NUMBER);
+
+	/* a block too small to ever be allocated is just left out */
+	if (header->block_size < MIN_BLOCK_SIZE(vsa))
 	{
-		pool_size = pool_size & ~ALIGN_MASK;
+		header->block_size |= ALLOC_FLAG;
 	}
+	else
+	{
+		LinkBlock(vsa, header);
 
-	header = memory_pool;
-	footer = (vsa_t *) ((char *) memory_pool + (pool_size - HEADER_STRUCT_SIZE));
-	
-	InitializeHeader(header, pool_size - (HEADER_STRUCT_SIZE * 2));
-	InitializeHeader(footer, END_MAGIC_NUMBER);
+		if (TRUE == is_tagged)
+		{
+			TagFreeBlock(header);
+		}
+	}
 
-    return (header);
+    return (vsa);
 }
 
 void *VSAAlloc(vsa_t *vsa, size_t bytes)
@@ -89,64 +205,274 @@ void *VSAAlloc(vsa_t *vsa, size_t bytes)
 	assert(0 < bytes);
 	assert(NULL != vsa);
 
-	ALIGN_NUMBER(bytes);
+	bytes = AdjustRequest(vsa, bytes);
 
-	founded_block = DefragFindSpace(vsa, bytes);
-	if (END_MAGIC_NUMBER == founded_block->block_size)
+	founded_block = FindFreeBlock(vsa, bytes);
+
+	/* free neighbours of a tagged vsa are never left unmerged */
+	if (NULL == founded_block && FALSE == vsa->is_tagged)
+	{
+		founded_block = DefragFindSpace(vsa, bytes);
+	}
+
+	if (NULL == founded_block)
 	{
 		return (NULL);
 	}
 
-	InitializeBlock(founded_block, bytes);
+	InitializeBlock(vsa, founded_block, bytes);
 
 	initialized_block = (char *) founded_block + HEADER_STRUCT_SIZE;
 
 	return (initialized_block);
 }
 
-static void InitializeBlock(block_t *header, size_t alloc_size)
+void *VSAAllocAligned(vsa_t *vsa, size_t bytes, size_t align)
+{
+	block_t *founded_block = NULL;
+	block_t *aligned_block = NULL;
+	char *payload = NULL;
+	size_t lead_size = 0;
+	size_t search_size = 0;
+
+	assert(0 < bytes);
+	assert(NULL != vsa);
+	assert(IS_POWER_OF_TWO(align));
+
+	if (align <= WORD_SIZE)
+	{
+		return (VSAAlloc(vsa, bytes));
+	}
+
+	bytes = AdjustRequest(vsa, bytes);
+
+	/* room for the request at any offset and for a free block in front of it */
+	search_size = bytes + align + HEADER_STRUCT_SIZE + MIN_BLOCK_SIZE(vsa);
+	if (search_size < bytes)
+	{
+		return (NULL);
+	}
+
+	founded_block = FindFreeBlock(vsa, search_size);
+
+	if (NULL == founded_block && FALSE == vsa->is_tagged)
+	{
+		founded_block = DefragFindSpace(vsa, search_size);
+	}
+
+	if (NULL == founded_block)
+	{
+		return (NULL);
+	}
+
+	payload = (char *) founded_block + HEADER_STRUCT_SIZE;
+	payload = (char *) (((size_t) payload + align - 1) & ~(align - 1));
+
+	/* the skipped bytes must hold a block of their own */
+	while (payload != (char *) founded_block + HEADER_STRUCT_SIZE &&
+			(size_t) (payload - (char *) founded_block) <
+								2 * HEADER_STRUCT_SIZE + MIN_BLOCK_SIZE(vsa))
+	{
+		payload += align;
+	}
+
+	aligned_block = AccessHeader((block_t *) payload);
+
+	if (aligned_block != founded_block)
+	{
+		lead_size = (char *) aligned_block - (char *) founded_block -
+														HEADER_STRUCT_SIZE;
+
+		UnlinkBlock(vsa, founded_block);
+		InitializeHeader(vsa, aligned_block, founded_block->block_size -
+											lead_size - HEADER_STRUCT_SIZE);
+		LinkBlock(vsa, aligned_block);
+		founded_block->block_size = lead_size;
+	}
+
+	InitializeBlock(vsa, aligned_block, bytes);
+
+	/* the leading block is tagged after the flags of the next one are set */
+	if (aligned_block != founded_block)
+	{
+		LinkBlock(vsa, founded_block);
+
+		if (TRUE == vsa->is_tagged)
+		{
+			TagFreeBlock(founded_block);
+		}
+	}
+
+	return (payload);
+}
+
+static void InitializeBlock(vsa_t *vsa, block_t *header, size_t alloc_size)
 {
 	block_t *new_header = NULL;
 	size_t free_size = header->block_size;
 	size_t remain_size = free_size - alloc_size;
- 
-	if (remain_size < HEADER_STRUCT_SIZE + WORD_SIZE)
+
+	UnlinkBlock(vsa, header);
+
+	if (remain_size < HEADER_STRUCT_SIZE + MIN_BLOCK_SIZE(vsa))
 	{
 		header->block_size = free_size | ALLOC_FLAG;
+
+		new_header = GetNextHeader(header);
+		if (TRUE == vsa->is_tagged && FALSE != IS_THE_END(new_header))
+		{
+			new_header->block_size &= ~PREV_FREE_FLAG;
+		}
 	}
 	else
 	{
 		new_header = (block_t *) ((char *) header + alloc_size + HEADER_STRUCT_SIZE);
-		InitializeHeader(new_header, remain_size - HEADER_STRUCT_SIZE);
+		InitializeHeader(vsa, new_header, remain_size - HEADER_STRUCT_SIZE);
+		LinkBlock(vsa, new_header);
 		header->block_size = alloc_size | ALLOC_FLAG;
+
+		if (TRUE == vsa->is_tagged)
+		{
+			TagFreeBlock(new_header);
+		}
 	}
+
+	++vsa->stats.live_blocks;
+	++vsa->stats.num_allocs;
+	CountInUse(vsa, 0, DEFLAG_SIZE(header->block_size));
 }
 
 void VSAFree(void *block_to_free)
 {
-	vsa_t *header = NULL;
+	vsa_t *vsa = NULL;
+	block_t *header = NULL;
+	block_t *next_header = NULL;
+	block_t *prev_header = NULL;
+	size_t is_prev_free = 0;
 
 	assert(NULL != block_to_free);
 
 	header = AccessHeader(block_to_free);
+	vsa = GET_VSA(header);
 
-	assert(DGB_HEADER_MAGIC_NUMBER == header->magic_number);
+	assert(DGB_VSA_MAGIC_NUMBER == vsa->magic_number);
+	assert(FALSE == IS_BLOCK_FREE(header));
 
+	is_prev_free = header->block_size & PREV_FREE_FLAG;
 	header->block_size = DEFLAG_SIZE(header->block_size);
+
+	--vsa->stats.live_blocks;
+	++vsa->stats.num_frees;
+	CountInUse(vsa, header->block_size, 0);
+
+	/* the following block is found by the size, so it is merged right away */
+	next_header = GetNextHeader(header);
+	if (FALSE != IS_THE_END(next_header) && TRUE == IS_BLOCK_FREE(next_header))
+	{
+		UnlinkBlock(vsa, next_header);
+		header->block_size += GetWholeBlockSize(next_header);
+	}
+
+	/* the footer of the preceding free block leads to its header */
+	if (0 != is_prev_free)
+	{
+		prev_header = GetPrevHeader(header);
+		UnlinkBlock(vsa, prev_header);
+		prev_header->block_size += GetWholeBlockSize(header);
+		header = prev_header;
+	}
+
+	LinkBlock(vsa, header);
+
+	if (TRUE == vsa->is_tagged)
+	{
+		TagFreeBlock(header);
+	}
+}
+
+void *VSARealloc(vsa_t *vsa, void *block, size_t bytes)
+{
+	block_t *header = NULL;
+	block_t *next_header = NULL;
+	void *new_block = NULL;
+	size_t available_size = 0;
+
+	assert(NULL != vsa);
+	assert(0 < bytes);
+
+	if (NULL == block)
+	{
+		return (VSAAlloc(vsa, bytes));
+	}
+
+	header = AccessHeader(block);
+
+	assert(vsa == GET_VSA(header));
+	assert(FALSE == IS_BLOCK_FREE(header));
+
+	bytes = AdjustRequest(vsa, bytes);
+	available_size = DEFLAG_SIZE(header->block_size);
+
+	/* the free blocks that follow are enough to grow in place */
+	next_header = GetNextHeader(header);
+	while (available_size < bytes && FALSE != IS_THE_END(next_header) &&
+										TRUE == IS_BLOCK_FREE(next_header))
+	{
+		available_size += GetWholeBlockSize(next_header);
+		next_header = GetNextHeader(next_header);
+	}
+
+	if (available_size >= bytes)
+	{
+		available_size = DEFLAG_SIZE(header->block_size);
+
+		/* adding sizes that are multiples of the word keeps the flags */
+		while (DEFLAG_SIZE(header->block_size) < bytes)
+		{
+			next_header = GetNextHeader(header);
+			UnlinkBlock(vsa, next_header);
+			header->block_size += GetWholeBlockSize(next_header);
+		}
+
+		SplitTail(vsa, header, bytes);
+		CountInUse(vsa, available_size, DEFLAG_SIZE(header->block_size));
+
+		return (block);
+	}
+
+	new_block = VSAAlloc(vsa, bytes);
+	if (NULL == new_block)
+	{
+		return (NULL);
+	}
+
+	memcpy(new_block, block, DEFLAG_SIZE(header->block_size));
+	VSAFree(block);
+
+	return (new_block);
 }
 
 size_t VSALargestChunkAvailable(vsa_t *vsa)
 {
 	block_t *header_runner = NULL;
+	block_t *next_header = NULL;
 	block_t *chunk_start = NULL;
 	size_t max_available_size = 0;
 
 	assert(NULL != vsa);
 
-	header_runner = vsa;
+	if (TRUE == vsa->is_tagged)
+	{
+		return (LargestListedBlock(vsa));
+	}
+
+	header_runner = FIRST_BLOCK(vsa);
 
 	while(FALSE != IS_THE_END(header_runner))
 	{
+		/* the links of a merged block may overwrite the header it absorbs */
+		next_header = GetNextHeader(header_runner);
+
 		if (TRUE == IS_BLOCK_FREE(header_runner))
 		{
 			if (NULL == chunk_start)
@@ -155,7 +481,7 @@ size_t VSALargestChunkAvailable(vsa_t *vsa)
 			}
 			else
 			{
-				chunk_start->block_size += GetWholeBlockSize(header_runner);
+				MergeBlocks(vsa, chunk_start, header_runner);
 			}
 
 			if (chunk_start->block_size > max_available_size)
@@ -168,22 +494,236 @@ size_t VSALargestChunkAvailable(vsa_t *vsa)
 			chunk_start = NULL;
 		}
 
-		header_runner = GetNextHeader(header_runner);
+		header_runner = next_header;
+	}
+	return (max_available_size);
+}
+
+size_t VSABlockSize(const void *block)
+{
+	const block_t *header = NULL;
+
+	assert(NULL != block);
+
+	header = (const block_t *) ((const char *) block - HEADER_STRUCT_SIZE);
+
+	assert(FALSE == IS_BLOCK_FREE(header));
+
+	return (DEFLAG_SIZE(header->block_size));
+}
+
+size_t VSASuggestSize(size_t bytes)
+{
+	ALIGN_NUMBER(bytes);
+
+	return (VSA_STRUCT_SIZE + (HEADER_STRUCT_SIZE * 2) + bytes);
+}
+
+void VSAGetStats(const vsa_t *vsa, vsa_stats_t *stats)
+{
+	size_t top_class = 0;
+
+	assert(NULL != vsa);
+	assert(NULL != stats);
+
+	*stats = vsa->stats;
+
+	/* the orphans are too small to be listed, they count as fragments */
+	if (0 == stats->free_bytes)
+	{
+		return;
+	}
+
+	if (0 == vsa->free_classes)
+	{
+		stats->fragmentation = 1;
+		return;
+	}
+
+	/* the average block of the highest class stands for the largest one */
+	top_class = FloorLog2(vsa->free_classes);
+	stats->fragmentation = 1 - (double) vsa->class_bytes[top_class] /
+					vsa->free_histogram[top_class] / stats->free_bytes;
+}
+
+void VSAGetFreeHistogram(const vsa_t *vsa, size_t *histogram)
+{
+	assert(NULL != vsa);
+	assert(NULL != histogram);
+
+	memcpy(histogram, vsa->free_histogram, sizeof(vsa->free_histogram));
+}
+
+int VSAWalk(const vsa_t *vsa, vsa_walk_action_t action, void *param)
+{
+	const block_t *header_runner = NULL;
+	int status = 0;
+
+	assert(NULL != vsa);
+	assert(NULL != action);
+
+	header_runner = (const block_t *) ((const char *) vsa + VSA_STRUCT_SIZE);
+
+	while (0 == status && FALSE != IS_THE_END(header_runner))
+	{
+		status = action((const char *) header_runner + HEADER_STRUCT_SIZE,
+						DEFLAG_SIZE(header_runner->block_size),
+						IS_BLOCK_FREE(header_runner), param);
+
+		header_runner = (const block_t *) ((const char *) header_runner +
+			HEADER_STRUCT_SIZE + DEFLAG_SIZE(header_runner->block_size));
+	}
+
+	return (status);
+}
+
+static size_t AdjustRequest(vsa_t *vsa, size_t bytes)
+{
+	ALIGN_NUMBER(bytes);
+
+	if (bytes < MIN_BLOCK_SIZE(vsa))
+	{
+		bytes = MIN_BLOCK_SIZE(vsa);
+	}
+
+	return (bytes);
+}
+
+static void CountInUse(vsa_t *vsa, size_t old_size, size_t new_size)
+{
+	vsa->stats.bytes_in_use += new_size;
+	vsa->stats.bytes_in_use -= old_size;
+
+	if (vsa->stats.bytes_in_use > vsa->stats.high_water_mark)
+	{
+		vsa->stats.high_water_mark = vsa->stats.bytes_in_use;
+	}
+}
+
+/* frees the bytes of an allocated block past size, if they hold a block */
+static void SplitTail(vsa_t *vsa, block_t *header, size_t size)
+{
+	block_t *tail = NULL;
+	block_t *next_header = NULL;
+	size_t flags = header->block_size & FLAGS_MASK;
+	size_t whole_size = DEFLAG_SIZE(header->block_size);
+
+	if (whole_size - size < HEADER_STRUCT_SIZE + MIN_BLOCK_SIZE(vsa))
+	{
+		/* the block may have absorbed the free block before the next one */
+		next_header = GetNextHeader(header);
+		if (TRUE == vsa->is_tagged && FALSE != IS_THE_END(next_header))
+		{
+			next_header->block_size &= ~PREV_FREE_FLAG;
+		}
+
+		return;
+	}
+
+	header->block_size = size | flags;
+
+	tail = GetNextHeader(header);
+	InitializeHeader(vsa, tail, whole_size - size - HEADER_STRUCT_SIZE);
+
+	next_header = GetNextHeader(tail);
+	if (FALSE != IS_THE_END(next_header) && TRUE == IS_BLOCK_FREE(next_header))
+	{
+		UnlinkBlock(vsa, next_header);
+		tail->block_size += GetWholeBlockSize(next_header);
+	}
+
+	LinkBlock(vsa, tail);
+
+	if (TRUE == vsa->is_tagged)
+	{
+		TagFreeBlock(tail);
+	}
+}
+
+static block_t *FindFreeBlock(vsa_t *vsa, size_t req_size)
+{
+	block_t *runner = NULL;
+	size_t size_class = FloorLog2(req_size);
+	size_t fit_class = size_class + !IS_POWER_OF_TWO(req_size);
+	size_t fit_classes = 0;
+	size_t probes = 0;
+
+	/*
+	* a few blocks of the class of req_size are tried first, so freed blocks
+	* are reused before a larger one is split
+	*/
+	runner = vsa->free_lists[size_class];
+	for (; NULL != runner && probes < MAX_CLASS_PROBES; ++probes)
+	{
+		if (req_size <= runner->block_size)
+		{
+			return (runner);
+		}
+
+		runner = LINKS(runner)->next;
+	}
+
+	/* every block of a class from fit_class up is large enough */
+	if (fit_class < WORD_BITS)
+	{
+		fit_classes = vsa->free_classes & ~(((size_t) 1 << fit_class) - 1);
+	}
+
+	if (0 != fit_classes)
+	{
+		return (vsa->free_lists[FloorLog2(fit_classes & (~fit_classes + 1))]);
+	}
+
+	for (; NULL != runner; runner = LINKS(runner)->next)
+	{
+		if (req_size <= runner->block_size)
+		{
+			return (runner);
+		}
+	}
+
+	return (NULL);
+}
+
+static size_t LargestListedBlock(const vsa_t *vsa)
+{
+	const block_t *runner = NULL;
+	size_t max_available_size = 0;
+
+	if (0 == vsa->free_classes)
+	{
+		return (0);
+	}
+
+	/* the largest block is on the list of the highest class */
+	runner = vsa->free_lists[FloorLog2(vsa->free_classes)];
+
+	for (; NULL != runner; runner = LINKS(runner)->next)
+	{
+		if (runner->block_size > max_available_size)
+		{
+			max_available_size = runner->block_size;
+		}
 	}
+
 	return (max_available_size);
 }
 
-static block_t *DefragFindSpace(vsa_t *header, size_t req_size)
+static block_t *DefragFindSpace(vsa_t *vsa, size_t req_size)
 {
 	block_t *header_runner = NULL;
+	block_t *next_header = NULL;
 	block_t *chunk_start = NULL;
 
-	assert(NULL != header);
+	assert(NULL != vsa);
 
-	header_runner = header;
+	header_runner = FIRST_BLOCK(vsa);
 
 	while(FALSE != IS_THE_END(header_runner))
 	{
+		/* the links of a merged block may overwrite the header it absorbs */
+		next_header = GetNextHeader(header_runner);
+
 		if (TRUE == IS_BLOCK_FREE(header_runner))
 		{
 			if (NULL == chunk_start)
@@ -192,7 +732,7 @@ static block_t *DefragFindSpace(vsa_t *header, size_t req_size)
 			}
 			else
 			{
-				chunk_start->block_size += GetWholeBlockSize(header_runner);
+				MergeBlocks(vsa, chunk_start, header_runner);
 			}
 
 			if (req_size <= chunk_start->block_size)
@@ -206,10 +746,142 @@ static block_t *DefragFindSpace(vsa_t *header, size_t req_size)
 			chunk_start = NULL;
 		}
 
-		header_runner = GetNextHeader(header_runner);
+		header_runner = next_header;
+	}
+
+	return (NULL);
+}
+
+static void MergeBlocks(vsa_t *vsa, block_t *chunk_start, block_t *block)
+{
+	UnlinkBlock(vsa, chunk_start);
+	UnlinkBlock(vsa, block);
+
+	chunk_start->block_size += GetWholeBlockSize(block);
+
+	LinkBlock(vsa, chunk_start);
+}
+
+static void LinkBlock(vsa_t *vsa, block_t *block)
+{
+	free_links_t *links = NULL;
+	size_t size_class = 0;
+
+	assert(NULL != vsa);
+	assert(NULL != block);
+
+	size_class = FloorLog2(block->block_size);
+
+	++vsa->stats.free_blocks;
+	vsa->stats.free_bytes += block->block_size;
+	++vsa->free_histogram[size_class];
+	vsa->class_bytes[size_class] += block->block_size;
+
+	/* too small to be listed, it is reused once merged with a neighbour */
+	if (block->block_size < MIN_LISTED_SIZE)
+	{
+		return;
+	}
+
+	links = LINKS(block);
+
+	links->prev = NULL;
+	links->next = vsa->free_lists[size_class];
+
+	if (NULL != links->next)
+	{
+		LINKS(links->next)->prev = block;
+	}
+
+	vsa->free_lists[size_class] = block;
+	vsa->free_classes |= (size_t) 1 << size_class;
+}
+
+static void UnlinkBlock(vsa_t *vsa, block_t *block)
+{
+	free_links_t *links = NULL;
+	size_t size_class = 0;
+
+	assert(NULL != vsa);
+	assert(NULL != block);
+
+	size_class = FloorLog2(block->block_size);
+
+	--vsa->stats.free_blocks;
+	vsa->stats.free_bytes -= block->block_size;
+	--vsa->free_histogram[size_class];
+	vsa->class_bytes[size_class] -= block->block_size;
+
+	if (block->block_size < MIN_LISTED_SIZE)
+	{
+		return;
+	}
+
+	links = LINKS(block);
+
+	if (NULL != links->prev)
+	{
+		LINKS(links->prev)->next = links->next;
+	}
+	else
+	{
+		vsa->free_lists[size_class] = links->next;
+
+		if (NULL == links->next)
+		{
+			vsa->free_classes &= ~((size_t) 1 << size_class);
+		}
+	}
+
+	if (NULL != links->next)
+	{
+		LINKS(links->next)->prev = links->prev;
+	}
+}
+
+static void TagFreeBlock(block_t *block)
+{
+	block_t *next_header = NULL;
+
+	assert(NULL != block);
+
+	*FOOTER(block) = block->block_size;
+
+	next_header = GetNextHeader(block);
+	if (FALSE != IS_THE_END(next_header))
+	{
+		next_header->block_size |= PREV_FREE_FLAG;
+	}
+}
+
+static block_t *GetPrevHeader(block_t *block)
+{
+	size_t prev_size = 0;
+
+	assert(NULL != block);
+
+	prev_size = *((size_t *) block - 1);
+
+	return ((block_t *) ((char *) block - prev_size - HEADER_STRUCT_SIZE));
+}
+
+static size_t FloorLog2(size_t number)
+{
+	size_t log = 0;
+	size_t shift = WORD_BITS / 2;
+
+	assert(0 < number);
+
+	for (; 0 < shift; shift /= 2)
+	{
+		if (0 != (number >> shift))
+		{
+			number >>= shift;
+			log += shift;
+		}
 	}
 
-	return (header_runner);
+	return (log);
 }
 
 static block_t *AccessHeader(block_t *block)
@@ -217,7 +889,7 @@ static block_t *AccessHeader(block_t *block)
 	return ((block_t *) ((char *) block - HEADER_STRUCT_SIZE));
 }
 
-static void InitializeHeader(block_t *block, size_t size)
+static void InitializeHeader(vsa_t *vsa, block_t *block, size_t size)
 {
 	block_t *header = NULL;
 
@@ -226,10 +898,7 @@ static void InitializeHeader(block_t *block, size_t size)
 	header = block;
 
 	header->block_size = size;
-
-	#ifndef NDEBUG
-    header->magic_number = DGB_HEADER_MAGIC_NUMBER;
-    #endif
+	header->vsa_offset = (char *) header - (char *) vsa;
 }
 
 static block_t *GetNextHeader(block_t *block)
@@ -242,11 +911,11 @@ static block_t *GetNextHeader(block_t *block)
 
 	if (TRUE == IS_NUMBER_EVEN(block_size))
 	{
-		return ((block_t *) ((char *) block + block_size + HEADER_STRUCT_SIZE));	
+		return ((block_t *) ((char *) block + block_size + HEADER_STRUCT_SIZE));
 	}
 	else
 	{
-		return ((block_t *) ((char *) block + DEFLAG_SIZE(block_size) + HEADER_STRUCT_SIZE));	
+		return ((block_t *) ((char *) block + DEFLAG_SIZE(block_size) + HEADER_STRUCT_SIZE));
 	}
 }
 
@@ -259,4 +928,4 @@ static size_t GetWholeBlockSize(block_t *block)
 	block_size = block->block_size;
 
 	return (block_size + HEADER_STRUCT_SIZE);
-}
\ No newline at end of file
+}
@@ -0,0 +1,361 @@
+/*******************************************************************************
+*
+* FILENAME : vsa_arena.c
+*
+* DESCRIPTION : Growable variable-size allocator implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, madvise */
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, free */
+#include <sys/mman.h> /* mmap, munmap, madvise */
+#include <unistd.h> /* sysconf */
+
+#include "vsa_arena.h"
+#include "vsa.h"
+
+enum {FALSE, TRUE};
+
+#define ARENA_STRUCT_SIZE (sizeof(arena_t))
+#define ALIGN_UP(NUMBER, ALIGN) (((NUMBER) + (ALIGN) - 1) & ~((ALIGN) - 1))
+/* every arena starts at a multiple of arena_size, its blocks lead to it */
+#define GET_ARENA(VSA_ARENA, BLOCK) \
+((arena_t *) ((size_t) (BLOCK) & ~((VSA_ARENA)->arena_size - 1)))
+#define POOL(ARENA) ((char *) (ARENA) + ARENA_STRUCT_SIZE)
+/* an arena with no free chunk this large is not looked through */
+#define FULL_CHUNK_SIZE (256)
+
+typedef struct arena arena_t;
+
+/* kept at the beginning of a mapping, the pool of the vsa follows */
+struct arena
+{
+    arena_t *next;
+    arena_t *prev;
+    vsa_t *vsa;
+    size_t map_size;
+    size_t num_blocks;
+    int is_large;
+    int is_full;
+};
+
+/*
+* allocations look only through the available arenas. An arena left with no
+* room for a small request is put on the full list until one of its blocks
+* is freed, and the mappings of large blocks are kept on a list of their own
+*/
+struct vsa_arena
+{
+    arena_t *available;
+    arena_t *full;
+    arena_t *large;
+    arena_t *empty_arena;
+    size_t arena_size;
+    size_t page_size;
+    size_t num_arenas;
+};
+
+static arena_t *MapArena(vsa_arena_t *vsa_arena, arena_t **list,
+                                                            size_t map_size);
+static void UnmapArena(vsa_arena_t *vsa_arena, arena_t **list,
+                                                            arena_t *arena);
+static void UnmapArenas(vsa_arena_t *vsa_arena, arena_t **list);
+static void LinkArena(arena_t **list, arena_t *arena);
+static void UnlinkArena(arena_t **list, arena_t *arena);
+static void *AllocLarge(vsa_arena_t *vsa_arena, size_t bytes);
+static size_t RoundUpPowerOfTwo(size_t number);
+
+vsa_arena_t *VSAArenaCreate(size_t arena_size)
+{
+    vsa_arena_t *vsa_arena = NULL;
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    assert(0 < arena_size);
+
+    vsa_arena = (vsa_arena_t *) malloc(sizeof(vsa_arena_t));
+    if (NULL == vsa_arena)
+    {
+        return (NULL);
+    }
+
+    vsa_arena->page_size = 0 < page_size ? (size_t) page_size : 4096;
+    if (arena_size < vsa_arena->page_size)
+    {
+        arena_size = vsa_arena->page_size;
+    }
+
+    vsa_arena->arena_size = RoundUpPowerOfTwo(arena_size);
+    vsa_arena->available = NULL;
+    vsa_arena->full = NULL;
+    vsa_arena->large = NULL;
+    vsa_arena->empty_arena = NULL;
+    vsa_arena->num_arenas = 0;
+
+    return (vsa_arena);
+}
+
+void VSAArenaDestroy(vsa_arena_t *vsa_arena)
+{
+    assert(NULL != vsa_arena);
+
+    UnmapArenas(vsa_arena, &vsa_arena->available);
+    UnmapArenas(vsa_arena, &vsa_arena->full);
+    UnmapArenas(vsa_arena, &vsa_arena->large);
+
+    free(vsa_arena);
+}
+
+void *VSAArenaAlloc(vsa_arena_t *vsa_arena, size_t bytes)
+{
+    arena_t *arena = NULL;
+    arena_t *next = NULL;
+    void *block = NULL;
+
+    assert(NULL != vsa_arena);
+    assert(0 < bytes);
+
+    if (ARENA_STRUCT_SIZE + VSASuggestSize(bytes) > vsa_arena->arena_size ||
+                                        bytes >= vsa_arena->arena_size)
+    {
+        return (AllocLarge(vsa_arena, bytes));
+    }
+
+    for (arena = vsa_arena->available; NULL != arena; arena = next)
+    {
+        block = VSAAlloc(arena->vsa, bytes);
+        if (NULL != block)
+        {
+            break;
+        }
+
+        /* an arena that still has room for small requests stays listed */
+        next = arena->next;
+        if (FULL_CHUNK_SIZE > VSALargestChunkAvailable(arena->vsa))
+        {
+            UnlinkArena(&vsa_arena->available, arena);
+            LinkArena(&vsa_arena->full, arena);
+            arena->is_full = TRUE;
+        }
+    }
+
+    if (NULL == block)
+    {
+        arena = MapArena(vsa_arena, &vsa_arena->available,
+                                                    vsa_arena->arena_size);
+        if (NULL == arena)
+        {
+            return (NULL);
+        }
+
+        block = VSAAlloc(arena->vsa, bytes);
+        assert(NULL != block);
+    }
+
+    if (arena == vsa_arena->empty_arena)
+    {
+        vsa_arena->empty_arena = NULL;
+    }
+
+    ++arena->num_blocks;
+
+    return (block);
+}
+
+void VSAArenaFree(vsa_arena_t *vsa_arena, void *block_to_free)
+{
+    arena_t *arena = NULL;
+
+    assert(NULL != vsa_arena);
+    assert(NULL != block_to_free);
+
+    arena = GET_ARENA(vsa_arena, block_to_free);
+
+    assert(0 < arena->num_blocks);
+
+    VSAFree(block_to_free);
+    --arena->num_blocks;
+
+    /* the freed room is tried first by the next allocation */
+    if (TRUE == arena->is_full)
+    {
+        UnlinkArena(&vsa_arena->full, arena);
+        LinkArena(&vsa_arena->available, arena);
+        arena->is_full = FALSE;
+    }
+
+    if (0 != arena->num_blocks)
+    {
+        return;
+    }
+
+    if (TRUE == arena->is_large)
+    {
+        UnmapArena(vsa_arena, &vsa_arena->large, arena);
+        return;
+    }
+
+    if (NULL != vsa_arena->empty_arena)
+    {
+        UnmapArena(vsa_arena, &vsa_arena->available, arena);
+        return;
+    }
+
+    /*
+    * the pages past the first one are dropped and read as zeros once touched
+    * again, so the pool is laid out anew
+    */
+    madvise((char *) arena + vsa_arena->page_size,
+                            arena->map_size - vsa_arena->page_size,
+                                                        MADV_DONTNEED);
+    arena->vsa = VSAInitTagged(arena->map_size - ARENA_STRUCT_SIZE,
+                                                                POOL(arena));
+    vsa_arena->empty_arena = arena;
+}
+
+size_t VSAArenaCount(const vsa_arena_t *vsa_arena)
+{
+    assert(NULL != vsa_arena);
+
+    return (vsa_arena->num_arenas);
+}
+
+static void *AllocLarge(vsa_arena_t *vsa_arena, size_t bytes)
+{
+    arena_t *arena = NULL;
+    void *block = NULL;
+    size_t map_size = 0;
+
+    /* a request so large that its mapping size would overflow */
+    if (bytes >= ~(size_t) 0 / 2)
+    {
+        return (NULL);
+    }
+
+    map_size = ALIGN_UP(ARENA_STRUCT_SIZE + VSASuggestSize(bytes),
+                                                    vsa_arena->page_size);
+
+    arena = MapArena(vsa_arena, &vsa_arena->large, map_size);
+    if (NULL == arena)
+    {
+        return (NULL);
+    }
+
+    arena->is_large = TRUE;
+    ++arena->num_blocks;
+
+    block = VSAAlloc(arena->vsa, bytes);
+    assert(NULL != block);
+
+    return (block);
+}
+
+static arena_t *MapArena(vsa_arena_t *vsa_arena, arena_t **list,
+                                                            size_t map_size)
+{
+    arena_t *arena = NULL;
+    char *map = NULL;
+    char *start = NULL;
+    size_t over_size = map_size + vsa_arena->arena_size;
+
+    /* mapped with extra room, then trimmed to start at a multiple */
+    map = (char *) mmap(NULL, over_size, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *) map)
+    {
+        return (NULL);
+    }
+
+    start = (char *) ALIGN_UP((size_t) map, vsa_arena->arena_size);
+
+    if (start != map)
+    {
+        munmap(map, start - map);
+    }
+
+    if (map + over_size != start + map_size)
+    {
+        munmap(start + map_size, (map + over_size) - (start + map_size));
+    }
+
+    arena = (arena_t *) start;
+    arena->vsa = VSAInitTagged(map_size - ARENA_STRUCT_SIZE, POOL(arena));
+    arena->map_size = map_size;
+    arena->num_blocks = 0;
+    arena->is_large = FALSE;
+    arena->is_full = FALSE;
+
+    LinkArena(list, arena);
+    ++vsa_arena->num_arenas;
+
+    return (arena);
+}
+
+static void UnmapArena(vsa_arena_t *vsa_arena, arena_t **list,
+                                                            arena_t *arena)
+{
+    UnlinkArena(list, arena);
+
+    if (arena == vsa_arena->empty_arena)
+    {
+        vsa_arena->empty_arena = NULL;
+    }
+
+    --vsa_arena->num_arenas;
+
+    munmap((void *) arena, arena->map_size);
+}
+
+static void UnmapArenas(vsa_arena_t *vsa_arena, arena_t **list)
+{
+    while (NULL != *list)
+    {
+        UnmapArena(vsa_arena, list, *list);
+    }
+}
+
+static void LinkArena(arena_t **list, arena_t *arena)
+{
+    arena->prev = NULL;
+    arena->next = *list;
+    if (NULL != arena->next)
+    {
+        arena->next->prev = arena;
+    }
+
+    *list = arena;
+}
+
+static void UnlinkArena(arena_t **list, arena_t *arena)
+{
+    if (NULL != arena->next)
+    {
+        arena->next->prev = arena->prev;
+    }
+
+    if (NULL != arena->prev)
+    {
+        arena->prev->next = arena->next;
+    }
+    else
+    {
+        *list = arena->next;
+    }
+}
+
+static size_t RoundUpPowerOfTwo(size_t number)
+{
+    size_t power = 1;
+
+    while (power < number)
+    {
+        power <<= 1;
+    }
+
+    return (power);
+}
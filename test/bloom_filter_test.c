@@ -0,0 +1,163 @@
+/*******************************************************************************
+*
+* FILENAME : bloom_filter_test.c
+*
+* DESCRIPTION : Bloom filter unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include "bloom_filter.h"
+#include "testing.h"
+
+
+#define NUM_KEYS (100000)
+
+static void TestBloomFilterCreate(void);
+static void TestBloomFilterAdd(void);
+static void TestBloomFilterFalsePositives(void);
+static void TestBloomFilterClear(void);
+
+static size_t CountFalsePositives(const bloom_filter_t *filter);
+static size_t Mix(size_t key);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Create", TestBloomFilterCreate},
+		{"Add", TestBloomFilterAdd},
+		{"FalsePositives", TestBloomFilterFalsePositives},
+		{"Clear", TestBloomFilterClear},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestBloomFilterCreate(void)
+{
+	bloom_filter_t *filter = BloomFilterCreate(1000, 10);
+
+	TH_ASSERT(NULL != filter);
+	TH_ASSERT(1000 == BloomFilterCapacity(filter));
+	TH_ASSERT(0 == BloomFilterMayContain(filter, Mix(1)));
+
+	BloomFilterDestroy(filter);
+
+	/* an empty filter is still a valid one */
+	filter = BloomFilterCreate(0, 1);
+	TH_ASSERT(NULL != filter);
+	BloomFilterAdd(filter, Mix(1));
+	TH_ASSERT(1 == BloomFilterMayContain(filter, Mix(1)));
+
+	BloomFilterDestroy(filter);
+}
+
+static void TestBloomFilterAdd(void)
+{
+	bloom_filter_t *filter = BloomFilterCreate(NUM_KEYS, 10);
+	size_t i = 0;
+	int is_found = 1;
+
+	for (; i < NUM_KEYS; ++i)
+	{
+		BloomFilterAdd(filter, Mix(i));
+	}
+
+	/* no false negatives, whatever the load */
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		is_found &= BloomFilterMayContain(filter, Mix(i));
+	}
+
+	TH_ASSERT(1 == is_found);
+
+	for (i = NUM_KEYS; i < NUM_KEYS * 4; ++i)
+	{
+		BloomFilterAdd(filter, Mix(i));
+	}
+
+	for (i = 0; i < NUM_KEYS * 4; ++i)
+	{
+		is_found &= BloomFilterMayContain(filter, Mix(i));
+	}
+
+	TH_ASSERT(1 == is_found);
+
+	BloomFilterDestroy(filter);
+}
+
+static void TestBloomFilterFalsePositives(void)
+{
+	bloom_filter_t *filter = BloomFilterCreate(NUM_KEYS, 10);
+	size_t i = 0;
+
+	for (; i < NUM_KEYS; ++i)
+	{
+		BloomFilterAdd(filter, Mix(i));
+	}
+
+	/* about 1% with 10 bits per element, allow some slack */
+	TH_ASSERT(CountFalsePositives(filter) < NUM_KEYS / 50);
+	BloomFilterDestroy(filter);
+
+	filter = BloomFilterCreate(NUM_KEYS, 16);
+
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		BloomFilterAdd(filter, Mix(i));
+	}
+
+	TH_ASSERT(CountFalsePositives(filter) < NUM_KEYS / 500);
+	BloomFilterDestroy(filter);
+}
+
+static void TestBloomFilterClear(void)
+{
+	bloom_filter_t *filter = BloomFilterCreate(NUM_KEYS, 10);
+	size_t i = 0;
+	int is_found = 0;
+
+	for (; i < NUM_KEYS; ++i)
+	{
+		BloomFilterAdd(filter, Mix(i));
+	}
+
+	BloomFilterClear(filter);
+
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		is_found |= BloomFilterMayContain(filter, Mix(i));
+	}
+
+	TH_ASSERT(0 == is_found);
+	TH_ASSERT(NUM_KEYS == BloomFilterCapacity(filter));
+
+	BloomFilterDestroy(filter);
+}
+
+static size_t CountFalsePositives(const bloom_filter_t *filter)
+{
+	size_t counter = 0;
+	size_t i = NUM_KEYS;
+
+	for (; i < NUM_KEYS * 2; ++i)
+	{
+		counter += BloomFilterMayContain(filter, Mix(i));
+	}
+
+	return (counter);
+}
+
+static size_t Mix(size_t key)
+{
+	key = (key ^ (key >> 16)) * 0x45d9f3b;
+	key = (key ^ (key >> 16)) * 0x45d9f3b;
+
+	return (key ^ (key >> 16));
+}
@@ -0,0 +1,211 @@
+/*******************************************************************************
+*
+* FILENAME : buddy_test.c
+*
+* DESCRIPTION : Buddy allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <stdlib.h> /* malloc, free, rand, srand */
+#include <string.h> /* memset */
+
+#include "buddy.h"
+#include "testing.h"
+
+
+#define POOL_SIZE (1 << 20)
+#define NUM_BLOCKS (4096)
+#define MIN_BLOCK (2 * sizeof(void *))
+
+static void TestBuddyInit(void);
+static void TestBuddyAlloc(void);
+static void TestBuddyAlignment(void);
+static void TestBuddyMerge(void);
+static void TestBuddyRandom(void);
+
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Init", TestBuddyInit},
+		{"Alloc", TestBuddyAlloc},
+		{"Alignment", TestBuddyAlignment},
+		{"Merge", TestBuddyMerge},
+		{"Random", TestBuddyRandom},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestBuddyInit(void)
+{
+	void *pool = malloc(POOL_SIZE);
+	buddy_t *buddy = BuddyInit(POOL_SIZE, pool);
+	size_t largest_chunk = BuddyLargestChunkAvailable(buddy);
+
+	/* the bitmaps take a little of the pool, the rest is in large blocks */
+	TH_ASSERT(0 == (largest_chunk & (largest_chunk - 1)));
+	TH_ASSERT(POOL_SIZE / 4 <= largest_chunk);
+	TH_ASSERT(POOL_SIZE >= largest_chunk);
+
+	free(pool);
+}
+
+static void TestBuddyAlloc(void)
+{
+	void *pool = malloc(POOL_SIZE);
+	buddy_t *buddy = BuddyInit(POOL_SIZE, pool);
+	char *block1 = BuddyAlloc(buddy, 1);
+	char *block2 = BuddyAlloc(buddy, 100);
+	char *block3 = BuddyAlloc(buddy, 128);
+
+	TH_ASSERT(NULL != block1 && NULL != block2 && NULL != block3);
+	TH_ASSERT(MIN_BLOCK == BuddyBlockSize(buddy, block1));
+	TH_ASSERT(128 == BuddyBlockSize(buddy, block2));
+	TH_ASSERT(128 == BuddyBlockSize(buddy, block3));
+
+	TH_ASSERT(NULL == BuddyAlloc(buddy, POOL_SIZE + 1));
+	TH_ASSERT(NULL == BuddyAlloc(buddy, ~(size_t) 0));
+
+	BuddyFree(buddy, block1);
+	BuddyFree(buddy, block2);
+	BuddyFree(buddy, block3);
+
+	free(pool);
+}
+
+static void TestBuddyAlignment(void)
+{
+	void *pool = malloc(POOL_SIZE);
+	buddy_t *buddy = BuddyInit(POOL_SIZE, pool);
+	size_t size = MIN_BLOCK;
+	int is_aligned = 1;
+	char *block = NULL;
+
+	/* any block is aligned to its size, pages included */
+	for (; size <= 4096 * 4; size *= 2)
+	{
+		block = BuddyAlloc(buddy, size);
+		is_aligned &= (NULL != block && 0 == (size_t) block % size);
+
+		block = BuddyAlloc(buddy, size - 1);
+		is_aligned &= (NULL != block && 0 == (size_t) block % size);
+	}
+
+	TH_ASSERT(1 == is_aligned);
+
+	free(pool);
+}
+
+static void TestBuddyMerge(void)
+{
+	static char *blocks[POOL_SIZE / 16];
+	void *pool = malloc(POOL_SIZE);
+	buddy_t *buddy = BuddyInit(POOL_SIZE, pool);
+	size_t largest_chunk = BuddyLargestChunkAvailable(buddy);
+	size_t num_blocks = 0;
+	size_t i = 0;
+
+	/* the whole pool in the smallest blocks */
+	while (NULL != (blocks[num_blocks] = BuddyAlloc(buddy, 1)))
+	{
+		++num_blocks;
+	}
+
+	TH_ASSERT(0 == BuddyLargestChunkAvailable(buddy));
+	TH_ASSERT(POOL_SIZE / MIN_BLOCK / 2 < num_blocks);
+
+	/* the odd ones first, nothing can merge until the even ones are back */
+	for (i = 1; i < num_blocks; i += 2)
+	{
+		BuddyFree(buddy, blocks[i]);
+	}
+
+	TH_ASSERT(MIN_BLOCK == BuddyLargestChunkAvailable(buddy));
+
+	for (i = 0; i < num_blocks; i += 2)
+	{
+		BuddyFree(buddy, blocks[i]);
+	}
+
+	TH_ASSERT(largest_chunk == BuddyLargestChunkAvailable(buddy));
+	TH_ASSERT(NULL != BuddyAlloc(buddy, largest_chunk));
+
+	free(pool);
+}
+
+static void TestBuddyRandom(void)
+{
+	static unsigned char *blocks[NUM_BLOCKS];
+	static size_t sizes[NUM_BLOCKS];
+	void *pool = malloc(POOL_SIZE * 4);
+	buddy_t *buddy = BuddyInit(POOL_SIZE * 4, pool);
+	size_t largest_chunk = BuddyLargestChunkAvailable(buddy);
+	int is_intact = 1;
+	size_t round = 0;
+	size_t i = 0;
+
+	srand(17);
+
+	/* at most half of the pool is asked for, rounded up it still fits */
+	for (; round < 20; ++round)
+	{
+		for (i = 0; i < NUM_BLOCKS; ++i)
+		{
+			if (NULL != blocks[i] && 0 == rand() % 2)
+			{
+				is_intact &= IsBlockIntact(blocks[i], sizes[i],
+														(unsigned char) i);
+				BuddyFree(buddy, blocks[i]);
+				blocks[i] = NULL;
+			}
+			else if (NULL == blocks[i])
+			{
+				sizes[i] = 1 + rand() % 256;
+				blocks[i] = BuddyAlloc(buddy, sizes[i]);
+				is_intact &= (NULL != blocks[i]);
+				memset(blocks[i], (unsigned char) i, sizes[i]);
+			}
+		}
+	}
+
+	for (i = 0; i < NUM_BLOCKS; ++i)
+	{
+		if (NULL != blocks[i])
+		{
+			is_intact &= IsBlockIntact(blocks[i], sizes[i],
+														(unsigned char) i);
+			BuddyFree(buddy, blocks[i]);
+		}
+	}
+
+	TH_ASSERT(1 == is_intact);
+	TH_ASSERT(largest_chunk == BuddyLargestChunkAvailable(buddy));
+
+	free(pool);
+}
+
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill)
+{
+	size_t i = 0;
+
+	for (; i < size; ++i)
+	{
+		if (fill != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
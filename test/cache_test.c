@@ -0,0 +1,313 @@
+/*******************************************************************************
+*
+* FILENAME : cache_test.c
+*
+* DESCRIPTION : Bounded cache unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <stdlib.h> /* malloc, free */
+
+#include "cache.h"
+#include "testing.h"
+
+
+#define NUM_ITEMS (100)
+#define STRESS_KEYS (5000)
+#define STRESS_CAPACITY (512)
+
+typedef struct
+{
+	int key;
+	int value;
+} item_t;
+
+typedef struct
+{
+	size_t counter;
+	int last_key;
+} evictions_t;
+
+static void TestCacheCreate(void);
+static void TestCacheLRU(void);
+static void TestCacheClock(void);
+static void TestCacheBytes(void);
+static void TestCacheReplace(void);
+static void TestCacheRemove(void);
+static void TestCacheStress(void);
+
+static size_t HashItem(const void *data);
+static int IsMatchItem(const void *data1, const void *data2);
+static void CountEviction(void *data, void *param);
+static void FreeEviction(void *data, void *param);
+static void InitItems(item_t *items, size_t n);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Create", TestCacheCreate},
+		{"LRU", TestCacheLRU},
+		{"Clock", TestCacheClock},
+		{"Bytes", TestCacheBytes},
+		{"Replace", TestCacheReplace},
+		{"Remove", TestCacheRemove},
+		{"Stress", TestCacheStress},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestCacheCreate(void)
+{
+	cache_t *cache = CacheCreate(10, 0, CACHE_LRU, HashItem, IsMatchItem,
+																NULL, NULL);
+
+	TH_ASSERT(NULL != cache);
+	TH_ASSERT(0 == CacheSize(cache));
+	TH_ASSERT(0 == CacheBytes(cache));
+
+	CacheDestroy(cache);
+}
+
+static void TestCacheLRU(void)
+{
+	item_t items[NUM_ITEMS];
+	evictions_t evictions = {0, -1};
+	cache_t *cache = CacheCreate(3, 0, CACHE_LRU, HashItem, IsMatchItem,
+													CountEviction, &evictions);
+	InitItems(items, NUM_ITEMS);
+
+	TH_ASSERT(0 == CachePut(cache, &items[0], 1));
+	TH_ASSERT(0 == CachePut(cache, &items[1], 1));
+	TH_ASSERT(0 == CachePut(cache, &items[2], 1));
+	TH_ASSERT(3 == CacheSize(cache));
+
+	/* the hit makes 1 the least recently used instead of 0 */
+	TH_ASSERT(&items[0] == CacheGet(cache, &items[0]));
+	TH_ASSERT(0 == CachePut(cache, &items[3], 1));
+	TH_ASSERT(1 == evictions.counter);
+	TH_ASSERT(1 == evictions.last_key);
+	TH_ASSERT(NULL == CacheGet(cache, &items[1]));
+	TH_ASSERT(3 == CacheSize(cache));
+
+	TH_ASSERT(0 == CachePut(cache, &items[4], 1));
+	TH_ASSERT(2 == evictions.last_key);
+	TH_ASSERT(0 == CachePut(cache, &items[5], 1));
+	TH_ASSERT(0 == evictions.last_key);
+
+	TH_ASSERT(&items[3] == CacheGet(cache, &items[3]));
+	TH_ASSERT(&items[4] == CacheGet(cache, &items[4]));
+	TH_ASSERT(&items[5] == CacheGet(cache, &items[5]));
+	TH_ASSERT(3 == evictions.counter);
+
+	CacheDestroy(cache);
+	TH_ASSERT(6 == evictions.counter);
+}
+
+static void TestCacheClock(void)
+{
+	item_t items[NUM_ITEMS];
+	evictions_t evictions = {0, -1};
+	cache_t *cache = CacheCreate(3, 0, CACHE_CLOCK, HashItem, IsMatchItem,
+													CountEviction, &evictions);
+	InitItems(items, NUM_ITEMS);
+
+	CachePut(cache, &items[0], 1);
+	CachePut(cache, &items[1], 1);
+	CachePut(cache, &items[2], 1);
+
+	/* the first sweep clears every bit and takes the entry it started with */
+	TH_ASSERT(0 == CachePut(cache, &items[3], 1));
+	TH_ASSERT(0 == evictions.last_key);
+
+	/* 1 is given a second chance, 2 is not */
+	TH_ASSERT(&items[1] == CacheGet(cache, &items[1]));
+	TH_ASSERT(0 == CachePut(cache, &items[4], 1));
+	TH_ASSERT(2 == evictions.last_key);
+	TH_ASSERT(&items[1] == CacheGet(cache, &items[1]));
+	TH_ASSERT(NULL == CacheGet(cache, &items[2]));
+	TH_ASSERT(2 == evictions.counter);
+	TH_ASSERT(3 == CacheSize(cache));
+
+	CacheDestroy(cache);
+	TH_ASSERT(5 == evictions.counter);
+}
+
+static void TestCacheBytes(void)
+{
+	item_t items[NUM_ITEMS];
+	evictions_t evictions = {0, -1};
+	cache_t *cache = CacheCreate(NUM_ITEMS, 100, CACHE_LRU, HashItem,
+										IsMatchItem, CountEviction, &evictions);
+	InitItems(items, NUM_ITEMS);
+
+	TH_ASSERT(0 == CachePut(cache, &items[0], 40));
+	TH_ASSERT(0 == CachePut(cache, &items[1], 40));
+	TH_ASSERT(80 == CacheBytes(cache));
+
+	/* too large to ever fit, the cache is left as it was */
+	TH_ASSERT(0 != CachePut(cache, &items[2], 101));
+	TH_ASSERT(2 == CacheSize(cache));
+	TH_ASSERT(0 == evictions.counter);
+
+	TH_ASSERT(0 == CachePut(cache, &items[2], 30));
+	TH_ASSERT(1 == evictions.counter);
+	TH_ASSERT(0 == evictions.last_key);
+	TH_ASSERT(70 == CacheBytes(cache));
+
+	/* one entry may push out several smaller ones */
+	TH_ASSERT(0 == CachePut(cache, &items[3], 100));
+	TH_ASSERT(3 == evictions.counter);
+	TH_ASSERT(1 == CacheSize(cache));
+	TH_ASSERT(100 == CacheBytes(cache));
+
+	CacheDestroy(cache);
+}
+
+static void TestCacheReplace(void)
+{
+	item_t items[NUM_ITEMS];
+	item_t newer = {1, 1000};
+	evictions_t evictions = {0, -1};
+	cache_t *cache = CacheCreate(3, 100, CACHE_LRU, HashItem, IsMatchItem,
+													CountEviction, &evictions);
+	InitItems(items, NUM_ITEMS);
+
+	CachePut(cache, &items[0], 30);
+	CachePut(cache, &items[1], 30);
+	CachePut(cache, &items[2], 30);
+
+	/* putting the same element again only refreshes it */
+	TH_ASSERT(0 == CachePut(cache, &items[0], 30));
+	TH_ASSERT(0 == evictions.counter);
+
+	/* a larger element for a cached key pushes out others, never itself */
+	TH_ASSERT(0 == CachePut(cache, &newer, 60));
+	TH_ASSERT(2 == evictions.counter);
+	TH_ASSERT(1 == evictions.last_key);
+	TH_ASSERT(&newer == CacheGet(cache, &items[1]));
+	TH_ASSERT(NULL == CacheGet(cache, &items[2]));
+	TH_ASSERT(&items[0] == CacheGet(cache, &items[0]));
+	TH_ASSERT(90 == CacheBytes(cache));
+	TH_ASSERT(2 == CacheSize(cache));
+
+	CacheDestroy(cache);
+	TH_ASSERT(4 == evictions.counter);
+}
+
+static void TestCacheRemove(void)
+{
+	item_t items[NUM_ITEMS];
+	evictions_t evictions = {0, -1};
+	cache_t *cache = CacheCreate(2, 0, CACHE_LRU, HashItem, IsMatchItem,
+													CountEviction, &evictions);
+	InitItems(items, NUM_ITEMS);
+
+	CachePut(cache, &items[0], 10);
+	CachePut(cache, &items[1], 10);
+
+	TH_ASSERT(&items[0] == CacheRemove(cache, &items[0]));
+	TH_ASSERT(NULL == CacheRemove(cache, &items[0]));
+	TH_ASSERT(1 == CacheSize(cache));
+	TH_ASSERT(10 == CacheBytes(cache));
+
+	/* the removed entry is reused without evicting anything */
+	TH_ASSERT(0 == CachePut(cache, &items[2], 10));
+	TH_ASSERT(0 == evictions.counter);
+	TH_ASSERT(0 == CachePut(cache, &items[3], 10));
+	TH_ASSERT(1 == evictions.counter);
+	TH_ASSERT(1 == evictions.last_key);
+
+	CacheDestroy(cache);
+	TH_ASSERT(3 == evictions.counter);
+}
+
+static void TestCacheStress(void)
+{
+	cache_policy_t policies[] = {CACHE_LRU, CACHE_CLOCK};
+	evictions_t evictions = {0, -1};
+	item_t probe = {0, 0};
+	item_t *item = NULL;
+	cache_t *cache = NULL;
+	size_t policy = 0;
+	size_t misses = 0;
+	int is_valid = 1;
+	int i = 0;
+
+	for (; policy < sizeof(policies) / sizeof(policies[0]); ++policy)
+	{
+		cache = CacheCreate(STRESS_CAPACITY, 0, policies[policy], HashItem,
+													IsMatchItem, FreeEviction,
+																&evictions);
+		evictions.counter = 0;
+		misses = 0;
+
+		/* a hot set that fits the cache, mixed with a stream of cold keys */
+		for (i = 0; i < STRESS_KEYS * 4; ++i)
+		{
+			probe.key = (0 == i % 2) ? i % (STRESS_CAPACITY / 2) :
+													STRESS_CAPACITY + i;
+			item = CacheGet(cache, &probe);
+			if (NULL == item)
+			{
+				++misses;
+				item = (item_t *) malloc(sizeof(item_t));
+				item->key = probe.key;
+				item->value = probe.key;
+				is_valid &= (0 == CachePut(cache, item, sizeof(item_t)));
+			}
+
+			is_valid &= (item->key == item->value);
+			is_valid &= (STRESS_CAPACITY >= CacheSize(cache));
+		}
+
+		/* once warm, the hot keys keep hitting */
+		TH_ASSERT(1 == is_valid);
+		TH_ASSERT(misses < STRESS_KEYS * 2 + STRESS_CAPACITY);
+		TH_ASSERT(misses - evictions.counter == CacheSize(cache));
+
+		CacheDestroy(cache);
+	}
+}
+
+static size_t HashItem(const void *data)
+{
+	return ((size_t) ((const item_t *) data)->key);
+}
+
+static int IsMatchItem(const void *data1, const void *data2)
+{
+	return (((const item_t *) data1)->key == ((const item_t *) data2)->key);
+}
+
+static void CountEviction(void *data, void *param)
+{
+	evictions_t *evictions = param;
+
+	++evictions->counter;
+	evictions->last_key = ((item_t *) data)->key;
+}
+
+static void FreeEviction(void *data, void *param)
+{
+	CountEviction(data, param);
+	free(data);
+}
+
+static void InitItems(item_t *items, size_t n)
+{
+	size_t i = 0;
+
+	for (; i < n; ++i)
+	{
+		items[i].key = (int) i;
+		items[i].value = (int) i;
+	}
+}
@@ -0,0 +1,237 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_magazine_test.c
+*
+* DESCRIPTION : Fixed-size allocator with per-thread magazines unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <pthread.h> /* pthread_create, pthread_join */
+#include <stdlib.h> /* malloc, free */
+
+#include "fsa.h"
+#include "fsa_magazine.h"
+#include "testing.h"
+
+
+#define NUM_OF_THREADS (8)
+#define BLOCKS_PER_THREAD (64)
+#define NUM_OF_ROUNDS (20000)
+#define NUM_OF_BLOCKS (NUM_OF_THREADS * BLOCKS_PER_THREAD / 2)
+#define BLOCK_WORDS (4)
+/* the amount of blocks of a magazine, as in fsa_magazine.c */
+#define MAGAZINE_SIZE (32)
+
+typedef struct
+{
+	fsa_magazine_t *fsa_magazine;
+	size_t id;
+	int is_failed;
+} thread_args_t;
+
+static void *AllocFreeThread(void *args);
+static int IsBlockOf(const size_t *block, size_t id);
+
+static void TestFSAMagazineAllocFree(void);
+static void TestFSAMagazineExhaust(void);
+static void TestFSAMagazineConcurrent(void);
+
+/* blocks are handed from one thread to the next through the mailboxes */
+static size_t *g_mailboxes[NUM_OF_THREADS][BLOCKS_PER_THREAD];
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"AllocFree", TestFSAMagazineAllocFree},
+		{"Exhaust", TestFSAMagazineExhaust},
+		{"Concurrent", TestFSAMagazineConcurrent},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestFSAMagazineAllocFree(void)
+{
+	void *pool = malloc(FSASuggestSize(100, 16));
+	fsa_magazine_t *fsa_magazine = FSAMagazineCreate(16, 100, pool);
+	size_t *block1 = NULL;
+	size_t *block2 = NULL;
+
+	TH_ASSERT(NULL != fsa_magazine);
+	TH_ASSERT(100 == FSAMagazineCountFree(fsa_magazine));
+
+	/* a magazine worth of blocks is taken from the fsa at once */
+	block1 = FSAMagazineAlloc(fsa_magazine);
+	block2 = FSAMagazineAlloc(fsa_magazine);
+	TH_ASSERT(NULL != block1 && NULL != block2 && block1 != block2);
+	TH_ASSERT(100 - MAGAZINE_SIZE == FSAMagazineCountFree(fsa_magazine));
+
+	block1[0] = 1;
+	block1[1] = 1;
+	block2[0] = 2;
+	block2[1] = 2;
+
+	/* the last freed block is the first to be allocated */
+	FSAMagazineFree(fsa_magazine, block1);
+	TH_ASSERT(block1 == FSAMagazineAlloc(fsa_magazine));
+	TH_ASSERT(2 == block2[0] && 2 == block2[1]);
+
+	FSAMagazineFree(fsa_magazine, block2);
+	FSAMagazineFree(fsa_magazine, block1);
+
+	FSAMagazineFlushCache(fsa_magazine);
+	TH_ASSERT(100 == FSAMagazineCountFree(fsa_magazine));
+
+	FSAMagazineDestroy(fsa_magazine);
+	free(pool);
+}
+
+static void TestFSAMagazineExhaust(void)
+{
+	/* the last slot takes the NULL that ends the allocations */
+	static void *blocks[NUM_OF_BLOCKS + 1];
+	void *pool = malloc(FSASuggestSize(NUM_OF_BLOCKS, 8));
+	fsa_magazine_t *fsa_magazine = FSAMagazineCreate(8, NUM_OF_BLOCKS, pool);
+	size_t num_blocks = 0;
+	size_t i = 0;
+
+	while (NULL != (blocks[num_blocks] = FSAMagazineAlloc(fsa_magazine)))
+	{
+		++num_blocks;
+	}
+
+	TH_ASSERT(NUM_OF_BLOCKS == num_blocks);
+	TH_ASSERT(0 == FSAMagazineCountFree(fsa_magazine));
+
+	/* the full magazines go to the depot, where they count as free */
+	for (; i < num_blocks; ++i)
+	{
+		FSAMagazineFree(fsa_magazine, blocks[i]);
+	}
+
+	TH_ASSERT(NUM_OF_BLOCKS - 2 * MAGAZINE_SIZE ==
+									FSAMagazineCountFree(fsa_magazine));
+
+	FSAMagazineFlushCache(fsa_magazine);
+	TH_ASSERT(NUM_OF_BLOCKS == FSAMagazineCountFree(fsa_magazine));
+
+	FSAMagazineDestroy(fsa_magazine);
+	free(pool);
+}
+
+static void TestFSAMagazineConcurrent(void)
+{
+	void *pool = malloc(FSASuggestSize(NUM_OF_BLOCKS,
+											BLOCK_WORDS * sizeof(size_t)));
+	fsa_magazine_t *fsa_magazine = FSAMagazineCreate(
+					BLOCK_WORDS * sizeof(size_t), NUM_OF_BLOCKS, pool);
+	pthread_t threads[NUM_OF_THREADS];
+	thread_args_t args[NUM_OF_THREADS];
+	size_t i = 0;
+
+	for (; i < NUM_OF_THREADS; ++i)
+	{
+		args[i].fsa_magazine = fsa_magazine;
+		args[i].id = i;
+		args[i].is_failed = 0;
+		pthread_create(&threads[i], NULL, AllocFreeThread, &args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_THREADS; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		TH_ASSERT(0 == args[i].is_failed);
+	}
+
+	/* the magazines of the threads were emptied when they exited */
+	TH_ASSERT(NUM_OF_BLOCKS == FSAMagazineCountFree(fsa_magazine));
+
+	FSAMagazineDestroy(fsa_magazine);
+	free(pool);
+}
+
+/*
+* takes blocks, writes its id all over them and checks that nobody else did,
+* then frees the blocks that the previous thread left in its mailbox and
+* leaves its own for the next one
+*/
+static void *AllocFreeThread(void *args)
+{
+	thread_args_t *thread_args = (thread_args_t *) args;
+	size_t *block = NULL;
+	size_t **mailbox = g_mailboxes[thread_args->id];
+	size_t **next_mailbox = NULL;
+	size_t round = 0;
+	size_t slot = 0;
+	size_t i = 0;
+
+	next_mailbox = g_mailboxes[(thread_args->id + 1) % NUM_OF_THREADS];
+
+	for (; round < NUM_OF_ROUNDS; ++round)
+	{
+		block = FSAMagazineAlloc(thread_args->fsa_magazine);
+		if (NULL == block)
+		{
+			continue;
+		}
+
+		for (i = 0; i < BLOCK_WORDS; ++i)
+		{
+			block[i] = thread_args->id;
+		}
+
+		thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+
+		slot = round % BLOCKS_PER_THREAD;
+		block = __atomic_exchange_n(&next_mailbox[slot], block,
+															__ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+			FSAMagazineFree(thread_args->fsa_magazine, block);
+		}
+
+		block = __atomic_exchange_n(&mailbox[slot], NULL, __ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block,
+					(thread_args->id + NUM_OF_THREADS - 1) % NUM_OF_THREADS);
+			FSAMagazineFree(thread_args->fsa_magazine, block);
+		}
+	}
+
+	for (slot = 0; slot < BLOCKS_PER_THREAD; ++slot)
+	{
+		block = __atomic_exchange_n(&next_mailbox[slot], NULL,
+															__ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+			FSAMagazineFree(thread_args->fsa_magazine, block);
+		}
+	}
+
+	return (NULL);
+}
+
+static int IsBlockOf(const size_t *block, size_t id)
+{
+	size_t i = 0;
+
+	for (; i < BLOCK_WORDS; ++i)
+	{
+		if (id != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
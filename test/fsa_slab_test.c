@@ -0,0 +1,195 @@
+/*******************************************************************************
+*
+* FILENAME : fsa_slab_test.c
+*
+* DESCRIPTION : Growable fixed-size allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <string.h> /* memset */
+
+#include "fsa_slab.h"
+#include "testing.h"
+
+
+#define SLAB_SIZE (1 << 14)
+#define BLOCK_SIZE (40)
+#define NUM_BLOCKS (3000)
+
+static void TestFSASlabCreate(void);
+static void TestFSASlabGrow(void);
+static void TestFSASlabPartialFirst(void);
+static void TestFSASlabThreshold(void);
+
+static size_t AllocBlocks(fsa_slab_t *fsa_slab, char **blocks);
+static int FreeBlocks(fsa_slab_t *fsa_slab, char **blocks);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Create", TestFSASlabCreate},
+		{"Grow", TestFSASlabGrow},
+		{"PartialFirst", TestFSASlabPartialFirst},
+		{"Threshold", TestFSASlabThreshold},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestFSASlabCreate(void)
+{
+	fsa_slab_t *fsa_slab = FSASlabCreate(3, 1, 1);
+	char *block = NULL;
+
+	TH_ASSERT(NULL != fsa_slab);
+	TH_ASSERT(0 == FSASlabCount(fsa_slab));
+	TH_ASSERT(0 < FSASlabBlocksPerSlab(fsa_slab));
+
+	/* a slab is mapped on the first allocation */
+	block = FSASlabAlloc(fsa_slab);
+	TH_ASSERT(NULL != block);
+	TH_ASSERT(0 == (size_t) block % sizeof(size_t));
+	TH_ASSERT(1 == FSASlabCount(fsa_slab));
+	memset(block, 0, 3);
+
+	/* the empty slab is kept and reused */
+	FSASlabFree(fsa_slab, block);
+	TH_ASSERT(1 == FSASlabCount(fsa_slab));
+	TH_ASSERT(1 == FSASlabCountEmpty(fsa_slab));
+
+	TH_ASSERT(block == FSASlabAlloc(fsa_slab));
+	TH_ASSERT(0 == FSASlabCountEmpty(fsa_slab));
+
+	FSASlabDestroy(fsa_slab);
+
+	/* a slab too small for a single block */
+	TH_ASSERT(NULL == FSASlabCreate(SLAB_SIZE * 2, SLAB_SIZE, 1));
+}
+
+static void TestFSASlabGrow(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	fsa_slab_t *fsa_slab = FSASlabCreate(BLOCK_SIZE, SLAB_SIZE, 2);
+	size_t per_slab = FSASlabBlocksPerSlab(fsa_slab);
+	size_t num_slabs = (NUM_BLOCKS + per_slab - 1) / per_slab;
+
+	/* slabs are mapped only when all of the others are full */
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(fsa_slab, blocks));
+	TH_ASSERT(num_slabs == FSASlabCount(fsa_slab));
+	TH_ASSERT(0 == FSASlabCountEmpty(fsa_slab));
+
+	TH_ASSERT(0 == FreeBlocks(fsa_slab, blocks));
+	TH_ASSERT(2 == FSASlabCount(fsa_slab));
+	TH_ASSERT(2 == FSASlabCountEmpty(fsa_slab));
+
+	/* the kept slabs are used again, their pages were given back */
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(fsa_slab, blocks));
+	TH_ASSERT(num_slabs == FSASlabCount(fsa_slab));
+	TH_ASSERT(0 == FreeBlocks(fsa_slab, blocks));
+
+	FSASlabDestroy(fsa_slab);
+}
+
+static void TestFSASlabPartialFirst(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	fsa_slab_t *fsa_slab = FSASlabCreate(BLOCK_SIZE, SLAB_SIZE, 1);
+	size_t per_slab = FSASlabBlocksPerSlab(fsa_slab);
+	size_t num_slabs = 0;
+	char *block = NULL;
+
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(fsa_slab, blocks));
+	num_slabs = FSASlabCount(fsa_slab);
+
+	/* a hole in a full slab is filled before any new slab is mapped */
+	block = blocks[per_slab / 2];
+	FSASlabFree(fsa_slab, block);
+	TH_ASSERT(block == FSASlabAlloc(fsa_slab));
+
+	FSASlabFree(fsa_slab, blocks[0]);
+	FSASlabFree(fsa_slab, blocks[per_slab]);
+	TH_ASSERT(blocks[per_slab] == FSASlabAlloc(fsa_slab));
+	TH_ASSERT(blocks[0] == FSASlabAlloc(fsa_slab));
+	TH_ASSERT(num_slabs == FSASlabCount(fsa_slab));
+
+	FSASlabDestroy(fsa_slab);
+}
+
+static void TestFSASlabThreshold(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	fsa_slab_t *fsa_slab = FSASlabCreate(BLOCK_SIZE, SLAB_SIZE, 0);
+	size_t per_slab = FSASlabBlocksPerSlab(fsa_slab);
+	size_t i = 0;
+
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(fsa_slab, blocks));
+
+	/* with no empty slab kept, a slab is unmapped with its last block */
+	for (; i < per_slab; ++i)
+	{
+		FSASlabFree(fsa_slab, blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	TH_ASSERT((NUM_BLOCKS - 1) / per_slab == FSASlabCount(fsa_slab));
+	TH_ASSERT(0 == FSASlabCountEmpty(fsa_slab));
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		FSASlabFree(fsa_slab, blocks[i]);
+	}
+
+	TH_ASSERT(0 == FSASlabCount(fsa_slab));
+
+	FSASlabDestroy(fsa_slab);
+}
+
+static size_t AllocBlocks(fsa_slab_t *fsa_slab, char **blocks)
+{
+	size_t i = 0;
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		blocks[i] = FSASlabAlloc(fsa_slab);
+		if (NULL == blocks[i])
+		{
+			break;
+		}
+
+		memset(blocks[i], (char) i, BLOCK_SIZE);
+	}
+
+	return (i);
+}
+
+/* returns the amount of blocks found corrupted */
+static int FreeBlocks(fsa_slab_t *fsa_slab, char **blocks)
+{
+	int num_corrupted = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		for (j = 0; j < BLOCK_SIZE; ++j)
+		{
+			if ((char) i != blocks[i][j])
+			{
+				++num_corrupted;
+				break;
+			}
+		}
+
+		FSASlabFree(fsa_slab, blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	return (num_corrupted);
+}
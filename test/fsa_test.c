@@ -11,6 +11,7 @@
 *******************************************************************************/
 
 #include <stdlib.h> /* malloc, free*/
+#include <string.h> /* memset */
 
 #include "fsa.h"
 #include "testing.h"
@@ -19,6 +20,8 @@
 #define WORD_SIZE (sizeof(unsigned long))
 #define IS_MEMORY_ALIGN(POINTER) \
 (0 == ((unsigned long) POINTER & (WORD_SIZE - 1)))
+/* the allocator keeps its struct at the beginning of the pool */
+#define FSA_SIZE (FSASuggestSize(0, 8))
 
 
 static void TestFSASuggestSize(void);
@@ -26,6 +29,8 @@ static void TestFSAAlloc(void);
 static void TestFSAFree(void);
 static void TestFSACountFree(void);
 static void TestFSAInit(void);
+static void TestFSAStats(void);
+static void TestFSALazyInit(void);
 
 
 int main()
@@ -36,6 +41,8 @@ int main()
 		{"FSAAlloc", TestFSAAlloc},
 		{"FSAFree", TestFSAFree},
 		{"FSAInit", TestFSAInit},
+		{"FSAStats", TestFSAStats},
+		{"FSALazyInit", TestFSALazyInit},
 		TH_TESTS_ARRAY_END
 	};
 
@@ -46,11 +53,11 @@ int main()
 
 static void TestFSASuggestSize(void)
 {
-	TH_ASSERT(24 == FSASuggestSize(2, 8));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 8));
 
-	TH_ASSERT(24 == FSASuggestSize(2, 3));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 3));
 
-	TH_ASSERT(40 == FSASuggestSize(2, 15));
+	TH_ASSERT(FSA_SIZE + 32 == FSASuggestSize(2, 15));
 }
 
 static void TestFSACountFree(void)
@@ -60,7 +67,7 @@ static void TestFSACountFree(void)
 
 	size_t size = FSASuggestSize(2, 8);
 
-	TH_ASSERT(24 == FSASuggestSize(2, 8));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 8));
 
 	pool = (int *) malloc(size);
 	
@@ -85,7 +92,7 @@ static void TestFSAAlloc(void)
 
 	size_t size = FSASuggestSize(2, 8);
 
-	TH_ASSERT(24 == FSASuggestSize(2, 8));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 8));
 
 	pool = (int *) malloc(size);
 	
@@ -115,7 +122,7 @@ static void TestFSAFree(void)
 
 	size_t size = FSASuggestSize(2, 8);
 
-	TH_ASSERT(24 == FSASuggestSize(2, 8));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 8));
 
 	pool = (int *) malloc(size);
 	
@@ -161,7 +168,7 @@ static void TestFSAInit(void)
 
 	size_t size = FSASuggestSize(2, 3);
 
-	TH_ASSERT(24 == FSASuggestSize(2, 3));
+	TH_ASSERT(FSA_SIZE + 16 == FSASuggestSize(2, 3));
 
 	pool = (int *) malloc(size);
 	
@@ -199,4 +206,77 @@ static void TestFSAInit(void)
 	TH_ASSERT(2 == FSACountFree(fsa));
 
 	free(pool);
-}
\ No newline at end of file
+}
+
+static void TestFSAStats(void)
+{
+	void *pool = malloc(FSASuggestSize(10, 12));
+	fsa_t *fsa = FSAInit(12, 10, pool);
+	fsa_stats_t stats;
+	void *block1 = FSAAlloc(fsa);
+	void *block2 = FSAAlloc(fsa);
+	void *block3 = FSAAlloc(fsa);
+
+	FSAFree(fsa, block2);
+	FSAGetStats(fsa, &stats);
+
+	TH_ASSERT(2 == stats.live_blocks && 8 == stats.free_blocks);
+	TH_ASSERT(32 == stats.bytes_in_use && 48 == stats.high_water_mark);
+	TH_ASSERT(3 == stats.num_allocs && 1 == stats.num_frees);
+
+	FSAFree(fsa, block1);
+	FSAFree(fsa, block3);
+	FSAGetStats(fsa, &stats);
+
+	TH_ASSERT(0 == stats.live_blocks && 10 == stats.free_blocks);
+	TH_ASSERT(0 == stats.bytes_in_use && 48 == stats.high_water_mark);
+	TH_ASSERT(10 == FSACountFree(fsa));
+
+	free(pool);
+}
+
+static void TestFSALazyInit(void)
+{
+	size_t size = FSASuggestSize(4, 8);
+	char *pool = (char *) malloc(size);
+	fsa_t *fsa = NULL;
+	char *block1 = NULL;
+	char *block2 = NULL;
+	char *block3 = NULL;
+	size_t i = FSA_SIZE;
+
+	memset(pool, 0x5A, size);
+
+	fsa = FSAInit(8, 4, pool);
+
+	/* init writes only the struct, the blocks stay untouched */
+	while (i < size && 0x5A == pool[i])
+	{
+		++i;
+	}
+	TH_ASSERT(size == i);
+	TH_ASSERT(4 == FSACountFree(fsa));
+
+	/* never used blocks are handed out in the order of the pool */
+	block1 = FSAAlloc(fsa);
+	block2 = FSAAlloc(fsa);
+	TH_ASSERT(pool + FSA_SIZE == block1);
+	TH_ASSERT(block1 + 8 == block2);
+	TH_ASSERT(0x5A == block2[8]);
+
+	/* a freed block is reused before the untouched ones */
+	FSAFree(fsa, block1);
+	TH_ASSERT(block1 == FSAAlloc(fsa));
+
+	block3 = FSAAlloc(fsa);
+	TH_ASSERT(block2 + 8 == block3);
+	TH_ASSERT(block3 + 8 == FSAAlloc(fsa));
+	TH_ASSERT(NULL == FSAAlloc(fsa));
+	TH_ASSERT(0 == FSACountFree(fsa));
+
+	FSAFree(fsa, block2);
+	TH_ASSERT(block2 == FSAAlloc(fsa));
+	TH_ASSERT(NULL == FSAAlloc(fsa));
+
+	free(pool);
+}
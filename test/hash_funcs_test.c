@@ -0,0 +1,203 @@
+/*******************************************************************************
+*
+* FILENAME : hash_funcs_test.c
+*
+* DESCRIPTION : Hash functions unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <limits.h> /* CHAR_BIT */
+#include <stdio.h> /* sprintf */
+#include <string.h> /* memcpy, memset, strlen */
+
+#include "hash_funcs.h"
+#include "testing.h"
+
+
+#define NUM_KEYS (1 << 16)
+#define NUM_BUCKETS (1 << 10)
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+#define CHI_SQUARE_LIMIT (NUM_BUCKETS + 6 * 45)
+
+static void TestHashWord(void);
+static void TestHashWordSeeded(void);
+static void TestHashBytes(void);
+static void TestHashString(void);
+static void TestAvalanche(void);
+
+static int IsSpreadEvenly(const size_t *hashes, size_t n);
+static size_t CountBits(size_t word);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"HashWord", TestHashWord},
+		{"HashWordSeeded", TestHashWordSeeded},
+		{"HashBytes", TestHashBytes},
+		{"HashString", TestHashString},
+		{"Avalanche", TestAvalanche},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestHashWord(void)
+{
+	static size_t hashes[NUM_KEYS];
+	size_t i = 0;
+
+	TH_ASSERT(HashWord(12345) == HashWord(12345));
+	TH_ASSERT(HashWord(12345) != HashWord(12346));
+
+	/* sequential and strided keys must both fill masked buckets evenly */
+	for (; i < NUM_KEYS; ++i)
+	{
+		hashes[i] = HashWord(i);
+	}
+
+	TH_ASSERT(1 == IsSpreadEvenly(hashes, NUM_KEYS));
+
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		hashes[i] = HashWord(i * NUM_BUCKETS);
+	}
+
+	TH_ASSERT(1 == IsSpreadEvenly(hashes, NUM_KEYS));
+}
+
+static void TestHashWordSeeded(void)
+{
+	static size_t hashes[NUM_KEYS];
+	size_t i = 0;
+
+	TH_ASSERT(HashWordSeeded(777, 1) == HashWordSeeded(777, 1));
+	TH_ASSERT(HashWordSeeded(777, 1) != HashWordSeeded(777, 2));
+	TH_ASSERT(HashWordSeeded(777, 0) != HashWord(777));
+
+	for (; i < NUM_KEYS; ++i)
+	{
+		hashes[i] = HashWordSeeded(i, 0xC0FFEE);
+	}
+
+	TH_ASSERT(1 == IsSpreadEvenly(hashes, NUM_KEYS));
+}
+
+static void TestHashBytes(void)
+{
+	const char *text = "The quick brown fox jumps over the lazy dog";
+	char buffer[64] = {0};
+	size_t len = strlen(text);
+	size_t offset = 0;
+	size_t i = 0;
+	int is_equal = 1;
+	int is_distinct = 1;
+
+	/* the same bytes hash the same wherever they are placed */
+	for (; offset < sizeof(size_t); ++offset)
+	{
+		memcpy(buffer + offset, text, len);
+		is_equal &= (HashBytes(text, len) == HashBytes(buffer + offset, len));
+	}
+
+	TH_ASSERT(1 == is_equal);
+
+	/* every prefix, including the ones ending inside a word, is distinct */
+	for (i = 1; i <= len; ++i)
+	{
+		is_distinct &= (HashBytes(text, i) != HashBytes(text, i - 1));
+	}
+
+	TH_ASSERT(1 == is_distinct);
+
+	memset(buffer, 0, sizeof(buffer));
+	TH_ASSERT(HashBytes(buffer, 3) != HashBytes(buffer, 4));
+	TH_ASSERT(HashBytes(NULL, 0) == HashBytes(text, 0));
+	TH_ASSERT(HashBytesSeeded(text, len, 1) != HashBytesSeeded(text, len, 2));
+	TH_ASSERT(HashBytesSeeded(text, len, 0) == HashBytes(text, len));
+}
+
+static void TestHashString(void)
+{
+	static size_t hashes[NUM_KEYS];
+	char key[32] = {0};
+	size_t i = 0;
+
+	TH_ASSERT(HashString("hello") == HashBytes("hello", 5));
+	TH_ASSERT(HashString("") == HashBytes("", 0));
+	TH_ASSERT(HashStringSeeded("hello", 42) == HashBytesSeeded("hello", 5, 42));
+	TH_ASSERT(HashStringSeeded("hello", 42) != HashString("hello"));
+
+	for (; i < NUM_KEYS; ++i)
+	{
+		sprintf(key, "key_%lu", (unsigned long) i);
+		hashes[i] = HashString(key);
+	}
+
+	TH_ASSERT(1 == IsSpreadEvenly(hashes, NUM_KEYS));
+}
+
+static void TestAvalanche(void)
+{
+	size_t flipped_bits = 0;
+	size_t flips = 0;
+	size_t word = 0;
+	size_t bit = 0;
+
+	/* flipping any input bit should flip about half of the output bits */
+	for (; word < 1000; ++word)
+	{
+		for (bit = 0; bit < WORD_BITS; ++bit, ++flips)
+		{
+			flipped_bits += CountBits(HashWord(word * 2654435761UL) ^
+							HashWord((word * 2654435761UL) ^ ((size_t) 1 << bit)));
+		}
+	}
+
+	TH_ASSERT(flipped_bits * 100 > flips * WORD_BITS * 45);
+	TH_ASSERT(flipped_bits * 100 < flips * WORD_BITS * 55);
+}
+
+static int IsSpreadEvenly(const size_t *hashes, size_t n)
+{
+	static size_t counters[NUM_BUCKETS];
+	size_t expected = n / NUM_BUCKETS;
+	size_t deviation = 0;
+	size_t sum = 0;
+	size_t i = 0;
+
+	memset(counters, 0, sizeof(counters));
+
+	for (; i < n; ++i)
+	{
+		++counters[hashes[i] & (NUM_BUCKETS - 1)];
+	}
+
+	for (i = 0; i < NUM_BUCKETS; ++i)
+	{
+		deviation = (counters[i] > expected) ? counters[i] - expected :
+														expected - counters[i];
+		sum += deviation * deviation;
+	}
+
+	/* chi-square of a uniform hash stays within 6 deviations of the mean */
+	return (sum < expected * CHI_SQUARE_LIMIT);
+}
+
+static size_t CountBits(size_t word)
+{
+	size_t counter = 0;
+
+	for (; 0 != word; word &= word - 1)
+	{
+		++counter;
+	}
+
+	return (counter);
+}
@@ -0,0 +1,241 @@
+/*******************************************************************************
+*
+* FILENAME : hash_snapshot_test.c
+*
+* DESCRIPTION : Hash snapshot unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <stdio.h> /* fopen, fread, fwrite, fclose, remove, sprintf */
+#include <string.h> /* memcpy, strlen, strcmp */
+
+#include "hash_snapshot.h"
+#include "testing.h"
+
+
+#define NUM_WORDS (20000)
+#define SNAPSHOT_PATH "hash_snapshot_test.snap"
+
+typedef struct
+{
+	char key[32];
+	char value[64];
+} dictionary_entity_t;
+
+static void TestSnapshotSaveOpen(void);
+static void TestSnapshotEmpty(void);
+static void TestSnapshotInvalid(void);
+static void TestSnapshotReplace(void);
+
+static size_t HashKey(const void *data);
+static int IsMatchKey(const void *data1, const void *data2);
+static size_t EncodeKey(const void *data, void *buffer, size_t size,
+																void *param);
+static size_t EncodeValue(const void *data, void *buffer, size_t size,
+																void *param);
+static size_t EncodeString(const char *str, void *buffer, size_t size);
+static h_table_t *CreateDictionary(dictionary_entity_t *words, size_t n,
+																int version);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"SaveOpen", TestSnapshotSaveOpen},
+		{"Empty", TestSnapshotEmpty},
+		{"Invalid", TestSnapshotInvalid},
+		{"Replace", TestSnapshotReplace},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	remove(SNAPSHOT_PATH);
+
+	return (0);
+}
+
+static void TestSnapshotSaveOpen(void)
+{
+	static dictionary_entity_t words[NUM_WORDS];
+	h_table_t *ht = CreateDictionary(words, NUM_WORDS, 0);
+	hash_snapshot_t *snapshot = NULL;
+	const char *value = NULL;
+	size_t value_size = 0;
+	size_t i = 0;
+	int is_found = 1;
+
+	TH_ASSERT(0 == HashSnapshotSave(ht, SNAPSHOT_PATH, EncodeKey, EncodeValue,
+																		NULL));
+	HashTableDestroy(ht);
+
+	/* the table is gone, the snapshot answers on its own */
+	snapshot = HashSnapshotOpen(SNAPSHOT_PATH);
+	TH_ASSERT(NULL != snapshot);
+	TH_ASSERT(NUM_WORDS == HashSnapshotSize(snapshot));
+
+	for (; i < NUM_WORDS; ++i)
+	{
+		value = HashSnapshotFind(snapshot, words[i].key, strlen(words[i].key),
+																&value_size);
+		is_found &= (NULL != value && strlen(words[i].value) + 1 == value_size
+										&& 0 == strcmp(value, words[i].value));
+		is_found &= (0 == (size_t) value % sizeof(size_t));
+	}
+
+	TH_ASSERT(1 == is_found);
+	TH_ASSERT(NULL == HashSnapshotFind(snapshot, "missing", 7, NULL));
+	TH_ASSERT(NULL == HashSnapshotFind(snapshot, words[0].key,
+											strlen(words[0].key) - 1, NULL));
+	TH_ASSERT(NULL == HashSnapshotFind(snapshot, NULL, 0, NULL));
+
+	HashSnapshotClose(snapshot);
+}
+
+static void TestSnapshotEmpty(void)
+{
+	h_table_t *ht = HashTableCreate(8, HashKey, IsMatchKey);
+	hash_snapshot_t *snapshot = NULL;
+
+	TH_ASSERT(0 == HashSnapshotSave(ht, SNAPSHOT_PATH, EncodeKey, EncodeValue,
+																		NULL));
+	HashTableDestroy(ht);
+
+	snapshot = HashSnapshotOpen(SNAPSHOT_PATH);
+	TH_ASSERT(NULL != snapshot);
+	TH_ASSERT(0 == HashSnapshotSize(snapshot));
+	TH_ASSERT(NULL == HashSnapshotFind(snapshot, "key", 3, NULL));
+
+	HashSnapshotClose(snapshot);
+}
+
+static void TestSnapshotInvalid(void)
+{
+	static dictionary_entity_t words[20];
+	h_table_t *ht = CreateDictionary(words, 20, 0);
+	char buffer[4096] = {0};
+	FILE *file = NULL;
+	size_t size = 0;
+
+	TH_ASSERT(NULL == HashSnapshotOpen("no_such_directory/file.snap"));
+
+	TH_ASSERT(0 == HashSnapshotSave(ht, SNAPSHOT_PATH, EncodeKey, EncodeValue,
+																		NULL));
+	HashTableDestroy(ht);
+
+	file = fopen(SNAPSHOT_PATH, "rb");
+	size = fread(buffer, 1, sizeof(buffer), file);
+	fclose(file);
+
+	/* a truncated file is rejected before any lookup */
+	file = fopen(SNAPSHOT_PATH, "wb");
+	fwrite(buffer, 1, size / 2, file);
+	fclose(file);
+	TH_ASSERT(NULL == HashSnapshotOpen(SNAPSHOT_PATH));
+
+	buffer[0] = 'X';
+	file = fopen(SNAPSHOT_PATH, "wb");
+	fwrite(buffer, 1, size, file);
+	fclose(file);
+	TH_ASSERT(NULL == HashSnapshotOpen(SNAPSHOT_PATH));
+
+	file = fopen(SNAPSHOT_PATH, "wb");
+	fclose(file);
+	TH_ASSERT(NULL == HashSnapshotOpen(SNAPSHOT_PATH));
+}
+
+static void TestSnapshotReplace(void)
+{
+	static dictionary_entity_t words[1000];
+	static dictionary_entity_t newer_words[1000];
+	h_table_t *ht = CreateDictionary(words, 1000, 0);
+	hash_snapshot_t *snapshot = NULL;
+	hash_snapshot_t *newer = NULL;
+
+	TH_ASSERT(0 == HashSnapshotSave(ht, SNAPSHOT_PATH, EncodeKey, EncodeValue,
+																		NULL));
+	HashTableDestroy(ht);
+	snapshot = HashSnapshotOpen(SNAPSHOT_PATH);
+
+	/* saving over a mapped snapshot leaves the mapped one intact */
+	ht = CreateDictionary(newer_words, 1000, 1);
+	TH_ASSERT(0 == HashSnapshotSave(ht, SNAPSHOT_PATH, EncodeKey, EncodeValue,
+																		NULL));
+	HashTableDestroy(ht);
+	newer = HashSnapshotOpen(SNAPSHOT_PATH);
+
+	TH_ASSERT(0 == strcmp(words[5].value,
+							HashSnapshotFind(snapshot, "word_5", 6, NULL)));
+	TH_ASSERT(0 == strcmp(newer_words[5].value,
+							HashSnapshotFind(newer, "word_5", 6, NULL)));
+
+	HashSnapshotClose(snapshot);
+	HashSnapshotClose(newer);
+}
+
+static h_table_t *CreateDictionary(dictionary_entity_t *words, size_t n,
+																int version)
+{
+	h_table_t *ht = HashTableCreate(n, HashKey, IsMatchKey);
+	size_t i = 0;
+
+	for (; i < n; ++i)
+	{
+		sprintf(words[i].key, "word_%lu", (unsigned long) i);
+		sprintf(words[i].value, "meaning %d of %lu", version,
+															(unsigned long) i);
+		HashTableInsert(ht, &words[i]);
+	}
+
+	return (ht);
+}
+
+static size_t HashKey(const void *data)
+{
+	return (HashString(((const dictionary_entity_t *) data)->key));
+}
+
+static int IsMatchKey(const void *data1, const void *data2)
+{
+	return (0 == strcmp(((const dictionary_entity_t *) data1)->key,
+									((const dictionary_entity_t *) data2)->key));
+}
+
+static size_t EncodeKey(const void *data, void *buffer, size_t size,
+																void *param)
+{
+	const dictionary_entity_t *word = data;
+	size_t len = strlen(word->key);
+
+	/* the terminator is left out, lookups pass the length instead */
+	if (len <= size)
+	{
+		memcpy(buffer, word->key, len);
+	}
+
+	(void) param;
+	return (len);
+}
+
+static size_t EncodeValue(const void *data, void *buffer, size_t size,
+																void *param)
+{
+	(void) param;
+	return (EncodeString(((const dictionary_entity_t *) data)->value, buffer,
+																		size));
+}
+
+static size_t EncodeString(const char *str, void *buffer, size_t size)
+{
+	size_t len = strlen(str) + 1;
+
+	if (len <= size)
+	{
+		memcpy(buffer, str, len);
+	}
+
+	return (len);
+}
@@ -30,6 +30,9 @@ typedef struct
 	int value;
 } keyval_entity_caching_t;
 
+static size_t g_match_calls = 0;
+static size_t g_hash_calls = 0;
+
 typedef struct dictionary_entity
 {
 	char key[100];
@@ -42,6 +45,8 @@ static int IsMatchCashing(const void *data1, const void *data2);
 static size_t HashDjb2(const void *data);
 static size_t HashDjb2Cashing(const void *data);
 static size_t HashDjb2Dictionary(const void *data);
+static size_t HashInt(const void *data);
+static size_t HashIntMix(const void *data);
 static int AdditionAction(void *data, void *param);
 static void HTInsertKeyValEnts(h_table_t *ht, keyval_entity_t *arr, size_t size);
 
@@ -55,6 +60,30 @@ static void TestHTFind(void);
 static void TestHTForEach(void);
 static void TestHTCaching(void);
 static void TestHTSpellChecker(void);
+static void TestHTFlat(void);
+static void TestHTFlatStress(void);
+static void TestHTResize(void);
+static void TestHTFlatResize(void);
+static void TestHTLoadFactor(void);
+static void TestHTCachedHash(void);
+static void TestHTFindBatch(void);
+static void TestHTSwiss(void);
+static void TestHTSwissTombstones(void);
+static void TestHTCuckoo(void);
+static void TestHTCuckooHighLoad(void);
+static void TestHTScan(void);
+static void TestHTFilter(void);
+static void TestHTCreateFrom(void);
+static void HTCheckResize(h_table_t *ht);
+static void HTCheckFindBatch(h_table_t *ht);
+static void HTCheckScan(h_table_t *ht);
+static void HTCheckFilter(h_table_t *ht);
+static void HTCheckCreateFrom(int flags);
+static size_t HTScanAll(h_table_t *ht, h_table_action_t action);
+static int CountVisitAction(void *data, void *param);
+static int CountVisitFailAction(void *data, void *param);
+static int IsMatchCounting(const void *data1, const void *data2);
+static size_t HashIntCounting(const void *data);
 
 int main()
 {
@@ -68,6 +97,20 @@ int main()
 		{"ForEach", TestHTForEach},
 		{"Caching", TestHTCaching},
 		{"SpellChecker", TestHTSpellChecker},
+		{"Flat", TestHTFlat},
+		{"FlatStress", TestHTFlatStress},
+		{"Resize", TestHTResize},
+		{"FlatResize", TestHTFlatResize},
+		{"LoadFactor", TestHTLoadFactor},
+		{"CachedHash", TestHTCachedHash},
+		{"FindBatch", TestHTFindBatch},
+		{"Swiss", TestHTSwiss},
+		{"SwissTombstones", TestHTSwissTombstones},
+		{"Cuckoo", TestHTCuckoo},
+		{"CuckooHighLoad", TestHTCuckooHighLoad},
+		{"Scan", TestHTScan},
+		{"Filter", TestHTFilter},
+		{"CreateFrom", TestHTCreateFrom},
 		TH_TESTS_ARRAY_END
 	};
 
@@ -368,6 +411,767 @@ static void TestHTSpellChecker(void)
 	HashTableDestroy(ht);
 }
 
+static void TestHTFlat(void)
+{
+	h_table_t *ht = HashTableCreateFlat(6, HashDjb2, IsMatch);
+	keyval_entity_t *founded = NULL;
+	int action_test_val = 5;
+	int test_nums[6] = {1001, 1002, 1003, 1004, 1005, 9999};
+	keyval_entity_t test_ents[6] = {
+		{"HELLO_1", NULL},
+		{"HELLO_2", NULL},
+		{"HELLO_3", NULL},
+		{"HELLO_4", NULL},
+		{"HELLO_5", NULL},
+		{"HELLO_6", NULL},
+	};
+	keyval_entity_t replacement = {"HELLO_2", NULL};
+
+	test_ents[0].value = &test_nums[0];
+	test_ents[1].value = &test_nums[1];
+	test_ents[2].value = &test_nums[2];
+	test_ents[3].value = &test_nums[3];
+	test_ents[4].value = &test_nums[4];
+	test_ents[5].value = &test_nums[5];
+	replacement.value = &test_nums[5];
+
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+
+	HTInsertKeyValEnts(ht, test_ents, 6);
+
+	TH_ASSERT(0 == HashTableIsEmpty(ht));
+	TH_ASSERT(6 == HashTableSize(ht));
+
+	founded = HashTableFind(ht, &test_ents[4]);
+	TH_ASSERT(founded == &test_ents[4]);
+
+	TH_ASSERT(0 == HashTableInsert(ht, &replacement));
+	TH_ASSERT(6 == HashTableSize(ht));
+	founded = HashTableFind(ht, &test_ents[1]);
+	TH_ASSERT(founded == &replacement);
+
+	HashTableRemove(ht, &test_ents[4]);
+	TH_ASSERT(NULL == HashTableFind(ht, &test_ents[4]));
+	TH_ASSERT(5 == HashTableSize(ht));
+
+	HashTableForEach(ht, AdditionAction, &action_test_val);
+	TH_ASSERT(1009 == test_nums[3]);
+	TH_ASSERT(1005 == test_nums[4]);
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTFlatStress(void)
+{
+	keyval_entity_caching_t test_arr[5000] = {0};
+	h_table_t *ht = HashTableCreateFlat(5000, HashInt, IsMatchCashing);
+	int i = 0;
+	int is_found = 1;
+
+	for (; i < 5000; ++i)
+	{
+		test_arr[i].key = i * 7;
+		test_arr[i].value = i;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(5000 == HashTableSize(ht));
+
+	for (i = 0; i < 5000; i += 2)
+	{
+		HashTableRemove(ht, &test_arr[i]);
+	}
+
+	TH_ASSERT(2500 == HashTableSize(ht));
+
+	for (i = 0; i < 5000; ++i)
+	{
+		is_found = (NULL != HashTableFind(ht, &test_arr[i]));
+		TH_ASSERT(is_found == (i & 1));
+	}
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTResize(void)
+{
+	h_table_t *ht = HashTableCreate(4, HashIntMix, IsMatchCashing);
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 1.0, 0.25));
+
+	HTCheckResize(ht);
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTFlatResize(void)
+{
+	h_table_t *ht = HashTableCreateFlat(4, HashIntMix, IsMatchCashing);
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.75, 0.25));
+
+	HTCheckResize(ht);
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTLoadFactor(void)
+{
+	h_table_t *ht = HashTableCreate(4, HashIntMix, IsMatchCashing);
+	h_table_t *flat = HashTableCreateFlat(4, HashIntMix, IsMatchCashing);
+
+	TH_ASSERT(0 != HashTableSetLoadFactor(ht, 0, 0));
+	TH_ASSERT(0 != HashTableSetLoadFactor(ht, 1.0, 0.6));
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 4.0, 0));
+	TH_ASSERT(0 != HashTableSetLoadFactor(flat, 0.95, 0));
+	TH_ASSERT(0 == HashTableSetLoadFactor(flat, 0.5, 0.2));
+
+	HashTableDestroy(ht);
+	HashTableDestroy(flat);
+}
+
+static void TestHTCachedHash(void)
+{
+	static keyval_entity_caching_t test_arr[300];
+	h_table_t *ht = HashTableCreate(1, HashIntCounting, IsMatchCounting);
+	int i = 0;
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 1000.0, 0));
+
+	for (; i < 300; ++i)
+	{
+		test_arr[i].key = i;
+		HashTableInsert(ht, &test_arr[i]);
+	}
+
+	g_match_calls = 0;
+
+	for (i = 0; i < 300; ++i)
+	{
+		TH_ASSERT(&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(300 == g_match_calls);
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 1.0, 0));
+	g_hash_calls = 0;
+
+	for (i = 0; i < 300; ++i)
+	{
+		HashTableInsert(ht, &test_arr[i]);
+		TH_ASSERT(&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(600 == g_hash_calls);
+	TH_ASSERT(300 == HashTableSize(ht));
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTFindBatch(void)
+{
+	h_table_t *ht = HashTableCreate(8, HashIntMix, IsMatchCashing);
+	h_table_t *flat = HashTableCreateFlat(8, HashIntMix, IsMatchCashing);
+
+	HTCheckFindBatch(ht);
+	HTCheckFindBatch(flat);
+
+	HashTableDestroy(ht);
+	HashTableDestroy(flat);
+}
+
+static void TestHTSwiss(void)
+{
+	h_table_t *ht = HashTableCreateSwiss(6, HashDjb2, IsMatch);
+	keyval_entity_t replacement = {"HELLO_2", NULL};
+	int test_nums[6] = {1001, 1002, 1003, 1004, 1005, 9999};
+	int action_test_val = 5;
+	keyval_entity_t test_ents[6] = {
+		{"HELLO_1", NULL},
+		{"HELLO_2", NULL},
+		{"HELLO_3", NULL},
+		{"HELLO_4", NULL},
+		{"HELLO_5", NULL},
+		{"HELLO_6", NULL},
+	};
+
+	test_ents[0].value = &test_nums[0];
+	test_ents[1].value = &test_nums[1];
+	test_ents[2].value = &test_nums[2];
+	test_ents[3].value = &test_nums[3];
+	test_ents[4].value = &test_nums[4];
+	test_ents[5].value = &test_nums[5];
+	replacement.value = &test_nums[5];
+
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+
+	HTInsertKeyValEnts(ht, test_ents, 6);
+	TH_ASSERT(6 == HashTableSize(ht));
+	TH_ASSERT(&test_ents[4] == HashTableFind(ht, &test_ents[4]));
+
+	TH_ASSERT(0 == HashTableInsert(ht, &replacement));
+	TH_ASSERT(6 == HashTableSize(ht));
+	TH_ASSERT(&replacement == HashTableFind(ht, &test_ents[1]));
+
+	HashTableRemove(ht, &test_ents[4]);
+	TH_ASSERT(NULL == HashTableFind(ht, &test_ents[4]));
+	TH_ASSERT(5 == HashTableSize(ht));
+
+	HashTableForEach(ht, AdditionAction, &action_test_val);
+	TH_ASSERT(1009 == test_nums[3]);
+	TH_ASSERT(1005 == test_nums[4]);
+
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateSwiss(4, HashIntMix, IsMatchCashing);
+	TH_ASSERT(0 != HashTableSetLoadFactor(ht, 0.95, 0));
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.75, 0.25));
+	HTCheckResize(ht);
+	HTCheckFindBatch(ht);
+	HashTableDestroy(ht);
+}
+
+static void TestHTSwissTombstones(void)
+{
+	static keyval_entity_caching_t test_arr[20000];
+	h_table_t *ht = HashTableCreateSwiss(64, HashInt, IsMatchCashing);
+	int i = 0;
+	int is_found = 0;
+
+	/* a sliding window of live keys keeps leaving tombstones behind */
+	for (; i < 20000; ++i)
+	{
+		test_arr[i].key = i;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+
+		if (50 <= i)
+		{
+			HashTableRemove(ht, &test_arr[i - 50]);
+		}
+	}
+
+	TH_ASSERT(50 == HashTableSize(ht));
+
+	for (i = 0; i < 20000; ++i)
+	{
+		is_found = (NULL != HashTableFind(ht, &test_arr[i]));
+		TH_ASSERT(is_found == (20000 - 50 <= i));
+	}
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTCuckoo(void)
+{
+	h_table_t *ht = HashTableCreateCuckoo(6, HashDjb2, IsMatch);
+	keyval_entity_t replacement = {"HELLO_2", NULL};
+	int test_nums[6] = {1001, 1002, 1003, 1004, 1005, 9999};
+	int action_test_val = 5;
+	keyval_entity_t test_ents[6] = {
+		{"HELLO_1", NULL},
+		{"HELLO_2", NULL},
+		{"HELLO_3", NULL},
+		{"HELLO_4", NULL},
+		{"HELLO_5", NULL},
+		{"HELLO_6", NULL},
+	};
+
+	test_ents[0].value = &test_nums[0];
+	test_ents[1].value = &test_nums[1];
+	test_ents[2].value = &test_nums[2];
+	test_ents[3].value = &test_nums[3];
+	test_ents[4].value = &test_nums[4];
+	test_ents[5].value = &test_nums[5];
+	replacement.value = &test_nums[5];
+
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+
+	HTInsertKeyValEnts(ht, test_ents, 6);
+	TH_ASSERT(6 == HashTableSize(ht));
+	TH_ASSERT(&test_ents[4] == HashTableFind(ht, &test_ents[4]));
+
+	TH_ASSERT(0 == HashTableInsert(ht, &replacement));
+	TH_ASSERT(6 == HashTableSize(ht));
+	TH_ASSERT(&replacement == HashTableFind(ht, &test_ents[1]));
+
+	HashTableRemove(ht, &test_ents[4]);
+	TH_ASSERT(NULL == HashTableFind(ht, &test_ents[4]));
+	TH_ASSERT(5 == HashTableSize(ht));
+
+	HashTableForEach(ht, AdditionAction, &action_test_val);
+	TH_ASSERT(1009 == test_nums[3]);
+	TH_ASSERT(1005 == test_nums[4]);
+
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateCuckoo(4, HashIntMix, IsMatchCashing);
+	TH_ASSERT(0 != HashTableSetLoadFactor(ht, 0.96, 0));
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.75, 0.25));
+	HTCheckResize(ht);
+	HTCheckFindBatch(ht);
+	HashTableDestroy(ht);
+}
+
+static void TestHTCuckooHighLoad(void)
+{
+	static keyval_entity_caching_t test_arr[31000];
+	keyval_entity_caching_t same_hash[17];
+	h_table_t *ht = HashTableCreateCuckoo(28000, HashIntMix, IsMatchCashing);
+	int i = 0;
+	int is_found = 1;
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.95, 0));
+
+	/* 28000 elements call for 32768 slots, 31000 fill them past 94% */
+	for (; i < 31000; ++i)
+	{
+		test_arr[i].key = i * 97;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(31000 == HashTableSize(ht));
+
+	for (i = 0; i < 31000; ++i)
+	{
+		is_found &= (&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(1 == is_found);
+
+	HashTableDestroy(ht);
+
+	/* two buckets and the stash hold 16 elements of one hash, not more */
+	ht = HashTableCreateCuckoo(64, HashInt, IsMatchCashing);
+
+	for (i = 0; i < 16; ++i)
+	{
+		same_hash[i].key = i * 97;
+		TH_ASSERT(0 == HashTableInsert(ht, &same_hash[i]));
+	}
+
+	same_hash[16].key = 16 * 97;
+	TH_ASSERT(0 != HashTableInsert(ht, &same_hash[16]));
+	TH_ASSERT(16 == HashTableSize(ht));
+
+	for (i = 0, is_found = 1; i < 16; ++i)
+	{
+		is_found &= (&same_hash[i] == HashTableFind(ht, &same_hash[i]));
+	}
+
+	TH_ASSERT(1 == is_found);
+	TH_ASSERT(NULL == HashTableFind(ht, &same_hash[16]));
+
+	HashTableDestroy(ht);
+}
+
+static void TestHTScan(void)
+{
+	static keyval_entity_caching_t test_arr[1000];
+	h_table_t *ht = HashTableCreate(4, HashIntMix, IsMatchCashing);
+	int i = 0;
+	int is_once = 1;
+
+	TH_ASSERT(0 == HashTableScan(ht, 0, 10, CountVisitAction, NULL));
+
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 1.0, 0.25));
+	HTCheckScan(ht);
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateFlat(4, HashIntMix, IsMatchCashing);
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.75, 0.25));
+	HTCheckScan(ht);
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateSwiss(4, HashIntMix, IsMatchCashing);
+	TH_ASSERT(0 == HashTableSetLoadFactor(ht, 0.75, 0.25));
+	HTCheckScan(ht);
+	HashTableDestroy(ht);
+
+	/* a cuckoo table left alone is still visited exactly once */
+	ht = HashTableCreateCuckoo(4, HashIntMix, IsMatchCashing);
+
+	for (; i < 1000; ++i)
+	{
+		test_arr[i].key = i;
+		test_arr[i].value = 0;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+	}
+
+	HTScanAll(ht, CountVisitAction);
+
+	for (i = 0; i < 1000; ++i)
+	{
+		is_once &= (1 == test_arr[i].value);
+	}
+
+	TH_ASSERT(1 == is_once);
+
+	HashTableDestroy(ht);
+}
+
+static void HTCheckFindBatch(h_table_t *ht)
+{
+	static keyval_entity_caching_t test_arr[3000];
+	static void *keys[3000];
+	static void *founded[3000];
+	int i = 0;
+
+	for (; i < 3000; ++i)
+	{
+		test_arr[i].key = i;
+		test_arr[i].value = i;
+		keys[i] = &test_arr[i];
+
+		if (0 != i % 3)
+		{
+			HashTableInsert(ht, &test_arr[i]);
+		}
+	}
+
+	TH_ASSERT(2000 == HashTableFindBatch(ht, keys, 3000, founded));
+
+	for (i = 0; i < 3000; ++i)
+	{
+		TH_ASSERT((0 == i % 3 ? NULL : &test_arr[i]) == founded[i]);
+	}
+
+	TH_ASSERT(0 == HashTableFindBatch(ht, keys, 0, founded));
+	TH_ASSERT(1 == HashTableFindBatch(ht, keys + 1, 1, founded));
+	TH_ASSERT(&test_arr[1] == founded[0]);
+}
+
+static void TestHTFilter(void)
+{
+	h_table_t *ht = HashTableCreate(4, HashIntMix, IsMatchCashing);
+
+	HTCheckFilter(ht);
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateFlat(4, HashIntMix, IsMatchCashing);
+	HTCheckFilter(ht);
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateSwiss(4, HashIntMix, IsMatchCashing);
+	HTCheckFilter(ht);
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateCuckoo(4, HashIntMix, IsMatchCashing);
+	HTCheckFilter(ht);
+	HashTableDestroy(ht);
+}
+
+static void TestHTCreateFrom(void)
+{
+	int flags = HT_FROM_CHAINED;
+
+	for (; flags <= HT_FROM_CUCKOO; ++flags)
+	{
+		HTCheckCreateFrom(flags);
+		HTCheckCreateFrom(flags | HT_FROM_UNIQUE);
+	}
+}
+
+static void HTCheckResize(h_table_t *ht)
+{
+	static keyval_entity_caching_t test_arr[20000];
+	keyval_entity_caching_t replacement = {0};
+	int i = 0;
+	int is_found = 1;
+
+	for (; i < 20000; ++i)
+	{
+		test_arr[i].key = i * 31;
+		test_arr[i].value = i;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+
+		if (0 == i % 1000)
+		{
+			TH_ASSERT(&test_arr[i / 2] == HashTableFind(ht, &test_arr[i / 2]));
+		}
+	}
+
+	TH_ASSERT(20000 == HashTableSize(ht));
+
+	replacement.key = test_arr[7].key;
+	TH_ASSERT(0 == HashTableInsert(ht, &replacement));
+	TH_ASSERT(20000 == HashTableSize(ht));
+	TH_ASSERT(&replacement == HashTableFind(ht, &test_arr[7]));
+
+	for (i = 0; i < 20000; ++i)
+	{
+		if (0 != i % 100)
+		{
+			HashTableRemove(ht, &test_arr[i]);
+		}
+	}
+
+	TH_ASSERT(200 == HashTableSize(ht));
+
+	for (i = 0; i < 20000; ++i)
+	{
+		is_found = (NULL != HashTableFind(ht, &test_arr[i]));
+		TH_ASSERT(is_found == (0 == i % 100));
+	}
+
+	for (i = 0; i < 20000; i += 100)
+	{
+		HashTableRemove(ht, &test_arr[i]);
+	}
+
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+}
+
+static void HTCheckScan(h_table_t *ht)
+{
+	static keyval_entity_caching_t test_arr[3000];
+	static keyval_entity_caching_t churn_arr[6000];
+	size_t cursor = 0;
+	size_t calls = 0;
+	size_t churned = 0;
+	int i = 0;
+	int is_once = 1;
+	int is_visited = 1;
+
+	for (; i < 3000; ++i)
+	{
+		test_arr[i].key = i;
+		test_arr[i].value = 0;
+		TH_ASSERT(0 == HashTableInsert(ht, &test_arr[i]));
+	}
+
+	/* an unchanged table is visited exactly once, even one bucket a call */
+	calls = HTScanAll(ht, CountVisitFailAction);
+	TH_ASSERT(1 < calls);
+
+	for (i = 0; i < 3000; ++i)
+	{
+		is_once &= (1 == test_arr[i].value);
+		test_arr[i].value = 0;
+	}
+
+	TH_ASSERT(1 == is_once);
+
+	/* the table grows under the scan */
+	do
+	{
+		cursor = HashTableScan(ht, cursor, 4, CountVisitAction, NULL);
+
+		for (i = 0; i < 20 && churned < 6000; ++i, ++churned)
+		{
+			churn_arr[churned].key = 3000 + churned;
+			TH_ASSERT(0 == HashTableInsert(ht, &churn_arr[churned]));
+		}
+	}
+	while (0 != cursor);
+
+	for (i = 0; i < 3000; ++i)
+	{
+		is_visited &= (1 <= test_arr[i].value);
+		test_arr[i].value = 0;
+	}
+
+	TH_ASSERT(1 == is_visited);
+
+	/* and shrinks back under the next one */
+	do
+	{
+		cursor = HashTableScan(ht, cursor, 4, CountVisitAction, NULL);
+
+		for (i = 0; i < 40 && 0 < churned; ++i)
+		{
+			--churned;
+			HashTableRemove(ht, &churn_arr[churned]);
+		}
+	}
+	while (0 != cursor);
+
+	for (i = 0; i < 3000; ++i)
+	{
+		is_visited &= (1 <= test_arr[i].value);
+		HashTableRemove(ht, &test_arr[i]);
+	}
+
+	TH_ASSERT(1 == is_visited);
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+}
+
+static void HTCheckFilter(h_table_t *ht)
+{
+	static keyval_entity_caching_t test_arr[4000];
+	keyval_entity_caching_t *keys[100] = {NULL};
+	keyval_entity_caching_t *found[100] = {NULL};
+	int i = 0;
+	int is_found = 1;
+	int is_missing = 1;
+
+	for (; i < 4000; ++i)
+	{
+		test_arr[i].key = i;
+	}
+
+	for (i = 0; i < 1000; ++i)
+	{
+		HashTableInsert(ht, &test_arr[i]);
+	}
+
+	/* the filter starts out with the elements already in the table */
+	TH_ASSERT(0 == HashTableAttachFilter(ht, 100, 10));
+
+	/* keeps up with inserts, even far beyond its capacity */
+	for (i = 1000; i < 2000; ++i)
+	{
+		HashTableInsert(ht, &test_arr[i]);
+	}
+
+	for (i = 0; i < 4000; ++i)
+	{
+		is_found &= (2000 <= i ||
+							&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+		is_missing &= (2000 > i || NULL == HashTableFind(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(1 == is_found);
+	TH_ASSERT(1 == is_missing);
+
+	/* removed elements are forgotten once the filter is rebuilt */
+	for (i = 0; i < 2000; i += 2)
+	{
+		HashTableRemove(ht, &test_arr[i]);
+	}
+
+	TH_ASSERT(0 == HashTableRebuildFilter(ht));
+
+	for (i = 0; i < 4000; ++i)
+	{
+		is_found &= (2000 <= i || 0 == i % 2 ||
+							&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+		is_missing &= ((2000 > i && 1 == i % 2) ||
+									NULL == HashTableFind(ht, &test_arr[i]));
+	}
+
+	TH_ASSERT(1 == is_found);
+	TH_ASSERT(1 == is_missing);
+
+	for (i = 0; i < 100; ++i)
+	{
+		keys[i] = &test_arr[i * 40];
+	}
+
+	/* keys 1, 3 ... below 2000 are left, every 40th key is even */
+	TH_ASSERT(0 == HashTableFindBatch(ht, (void **) keys, 100,
+															(void **) found));
+
+	for (i = 0; i < 100; ++i)
+	{
+		keys[i] = &test_arr[i * 20 + 1];
+	}
+
+	TH_ASSERT(100 == HashTableFindBatch(ht, (void **) keys, 100,
+															(void **) found));
+
+	for (i = 0; i < 100; ++i)
+	{
+		is_found &= (keys[i] == found[i]);
+	}
+
+	TH_ASSERT(1 == is_found);
+
+	HashTableDetachFilter(ht);
+	TH_ASSERT(&test_arr[1] == HashTableFind(ht, &test_arr[1]));
+	TH_ASSERT(NULL == HashTableFind(ht, &test_arr[0]));
+}
+
+static void HTCheckCreateFrom(int flags)
+{
+	static keyval_entity_caching_t test_arr[100000];
+	static keyval_entity_caching_t dups[1000];
+	static void *items[101000];
+	keyval_entity_caching_t missing = {100000, 0};
+	h_table_t *ht = NULL;
+	int i = 0;
+	int is_found = 1;
+
+	for (; i < 100000; ++i)
+	{
+		test_arr[i].key = i;
+		test_arr[i].value = 0;
+		items[i] = &test_arr[i];
+	}
+
+	/* large enough to hash on several threads */
+	ht = HashTableCreateFrom(items, 100000, HashIntMix, IsMatchCashing, flags);
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(100000 == HashTableSize(ht));
+
+	HashTableForEach(ht, CountVisitAction, NULL);
+
+	for (i = 0; i < 100000; ++i)
+	{
+		is_found &= (&test_arr[i] == HashTableFind(ht, &test_arr[i]));
+		is_found &= (1 == test_arr[i].value);
+	}
+
+	TH_ASSERT(1 == is_found);
+	TH_ASSERT(NULL == HashTableFind(ht, &missing));
+
+	/* built tables keep working as usual */
+	TH_ASSERT(0 == HashTableInsert(ht, &missing));
+	HashTableRemove(ht, &test_arr[0]);
+	TH_ASSERT(100000 == HashTableSize(ht));
+	TH_ASSERT(NULL == HashTableFind(ht, &test_arr[0]));
+	HashTableDestroy(ht);
+
+	ht = HashTableCreateFrom(NULL, 0, HashIntMix, IsMatchCashing, flags);
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(1 == HashTableIsEmpty(ht));
+	TH_ASSERT(0 == HashTableInsert(ht, &missing));
+	TH_ASSERT(&missing == HashTableFind(ht, &missing));
+	HashTableDestroy(ht);
+
+	if (0 != (flags & HT_FROM_UNIQUE))
+	{
+		return;
+	}
+
+	/* a later element replaces an earlier one with an equal key */
+	for (i = 0; i < 1000; ++i)
+	{
+		dups[i].key = i * 7;
+		dups[i].value = 2;
+		items[100000 + i] = &dups[i];
+	}
+
+	ht = HashTableCreateFrom(items, 101000, HashIntMix, IsMatchCashing, flags);
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(100000 == HashTableSize(ht));
+
+	for (i = 0; i < 1000; ++i)
+	{
+		is_found &= (&dups[i] == HashTableFind(ht, &dups[i]));
+	}
+
+	TH_ASSERT(1 == is_found);
+	HashTableDestroy(ht);
+}
+
+static size_t HTScanAll(h_table_t *ht, h_table_action_t action)
+{
+	size_t cursor = 0;
+	size_t calls = 0;
+
+	do
+	{
+		cursor = HashTableScan(ht, cursor, 16, action, NULL);
+		++calls;
+	}
+	while (0 != cursor);
+
+	return (calls);
+}
+
 static int IsMatch(const void *data1, const void *data2)
 {
 	keyval_entity_t *ent1 = (void *) data1;
@@ -413,6 +1217,38 @@ static size_t HashDjb2Cashing(const void *data)
 	(void) data;
 }
 
+static size_t HashInt(const void *data)
+{
+	keyval_entity_caching_t *ent = (void *) data;
+
+	return ((size_t) ent->key % 97);
+}
+
+static int IsMatchCounting(const void *data1, const void *data2)
+{
+	++g_match_calls;
+
+	return (IsMatchCashing(data1, data2));
+}
+
+static size_t HashIntCounting(const void *data)
+{
+	++g_hash_calls;
+
+	return (HashIntMix(data));
+}
+
+static size_t HashIntMix(const void *data)
+{
+	keyval_entity_caching_t *ent = (void *) data;
+	size_t hash = (size_t) ent->key;
+
+	hash = (hash ^ (hash >> 16)) * 0x45d9f3b;
+	hash = (hash ^ (hash >> 16)) * 0x45d9f3b;
+
+	return (hash ^ (hash >> 16));
+}
+
 static size_t HashDjb2Dictionary(const void *data)
 {
 	size_t hash = 5381;
@@ -428,6 +1264,23 @@ static size_t HashDjb2Dictionary(const void *data)
 	return (hash);
 }
 
+static int CountVisitAction(void *data, void *param)
+{
+	keyval_entity_caching_t *ent = (void *) data;
+
+	++ent->value;
+
+	(void) param;
+	return (0);
+}
+
+static int CountVisitFailAction(void *data, void *param)
+{
+	CountVisitAction(data, param);
+
+	return (1);
+}
+
 static int AdditionAction(void *data, void *param)
 {
 	keyval_entity_t *ent = (void *) data;
@@ -0,0 +1,212 @@
+/*******************************************************************************
+*
+* FILENAME : mt_fsa_test.c
+*
+* DESCRIPTION : Lock-free fixed-size allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <pthread.h> /* pthread_create, pthread_join */
+#include <stdlib.h> /* malloc, free */
+
+#include "mt_fsa.h"
+#include "testing.h"
+
+
+#define NUM_OF_THREADS (8)
+#define BLOCKS_PER_THREAD (64)
+#define NUM_OF_ROUNDS (20000)
+#define NUM_OF_BLOCKS (NUM_OF_THREADS * BLOCKS_PER_THREAD / 2)
+#define BLOCK_WORDS (4)
+
+typedef struct
+{
+	mt_fsa_t *mt_fsa;
+	size_t id;
+	int is_failed;
+} thread_args_t;
+
+static void *AllocFreeThread(void *args);
+static int IsBlockOf(const size_t *block, size_t id);
+
+static void TestMTFSAInit(void);
+static void TestMTFSAAllocFree(void);
+static void TestMTFSAConcurrent(void);
+
+/* blocks are handed from one thread to the next through the mailboxes */
+static size_t *g_mailboxes[NUM_OF_THREADS][BLOCKS_PER_THREAD];
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Init", TestMTFSAInit},
+		{"AllocFree", TestMTFSAAllocFree},
+		{"Concurrent", TestMTFSAConcurrent},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestMTFSAInit(void)
+{
+	void *pool = malloc(MTFSASuggestSize(10, 3));
+	mt_fsa_t *mt_fsa = MTFSAInit(3, 10, pool);
+
+	TH_ASSERT(MTFSASuggestSize(0, 3) + 10 * sizeof(size_t) ==
+												MTFSASuggestSize(10, 3));
+	TH_ASSERT(10 == MTFSACountFree(mt_fsa));
+
+	/* the head sits on a cache line of its own even in a misaligned pool */
+	mt_fsa = MTFSAInit(3, 9, (size_t *) pool + 1);
+	TH_ASSERT(0 == (size_t) mt_fsa % 64);
+	TH_ASSERT((char *) mt_fsa + 64 <= (char *) MTFSAAlloc(mt_fsa));
+	TH_ASSERT(8 == MTFSACountFree(mt_fsa));
+
+	free(pool);
+}
+
+static void TestMTFSAAllocFree(void)
+{
+	void *pool = malloc(MTFSASuggestSize(2, 16));
+	mt_fsa_t *mt_fsa = MTFSAInit(16, 2, pool);
+	size_t *block1 = MTFSAAlloc(mt_fsa);
+	size_t *block2 = MTFSAAlloc(mt_fsa);
+
+	TH_ASSERT(NULL != block1 && NULL != block2 && block1 != block2);
+	TH_ASSERT(0 == (size_t) block1 % sizeof(size_t));
+	TH_ASSERT(NULL == MTFSAAlloc(mt_fsa));
+	TH_ASSERT(0 == MTFSACountFree(mt_fsa));
+
+	block1[0] = 1;
+	block1[1] = 1;
+	block2[0] = 2;
+	block2[1] = 2;
+
+	MTFSAFree(mt_fsa, block1);
+	TH_ASSERT(1 == MTFSACountFree(mt_fsa));
+	TH_ASSERT(2 == block2[0] && 2 == block2[1]);
+
+	/* the last freed block is the first to be allocated */
+	TH_ASSERT(block1 == MTFSAAlloc(mt_fsa));
+
+	MTFSAFree(mt_fsa, block2);
+	MTFSAFree(mt_fsa, block1);
+	TH_ASSERT(2 == MTFSACountFree(mt_fsa));
+
+	free(pool);
+}
+
+static void TestMTFSAConcurrent(void)
+{
+	void *pool = malloc(MTFSASuggestSize(NUM_OF_BLOCKS,
+											BLOCK_WORDS * sizeof(size_t)));
+	mt_fsa_t *mt_fsa = MTFSAInit(BLOCK_WORDS * sizeof(size_t), NUM_OF_BLOCKS,
+																		pool);
+	pthread_t threads[NUM_OF_THREADS];
+	thread_args_t args[NUM_OF_THREADS];
+	size_t i = 0;
+
+	for (; i < NUM_OF_THREADS; ++i)
+	{
+		args[i].mt_fsa = mt_fsa;
+		args[i].id = i;
+		args[i].is_failed = 0;
+		pthread_create(&threads[i], NULL, AllocFreeThread, &args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_THREADS; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		TH_ASSERT(0 == args[i].is_failed);
+	}
+
+	TH_ASSERT(NUM_OF_BLOCKS == MTFSACountFree(mt_fsa));
+
+	free(pool);
+}
+
+/*
+* takes blocks, writes its id all over them and checks that nobody else did,
+* then frees the blocks that the previous thread left in its mailbox and
+* leaves its own for the next one
+*/
+static void *AllocFreeThread(void *args)
+{
+	thread_args_t *thread_args = (thread_args_t *) args;
+	size_t *block = NULL;
+	size_t **mailbox = g_mailboxes[thread_args->id];
+	size_t **next_mailbox = NULL;
+	size_t round = 0;
+	size_t slot = 0;
+	size_t i = 0;
+
+	next_mailbox = g_mailboxes[(thread_args->id + 1) % NUM_OF_THREADS];
+
+	for (; round < NUM_OF_ROUNDS; ++round)
+	{
+		block = MTFSAAlloc(thread_args->mt_fsa);
+		if (NULL == block)
+		{
+			continue;
+		}
+
+		for (i = 0; i < BLOCK_WORDS; ++i)
+		{
+			block[i] = thread_args->id;
+		}
+
+		thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+
+		slot = round % BLOCKS_PER_THREAD;
+		block = __atomic_exchange_n(&next_mailbox[slot], block,
+															__ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+			MTFSAFree(thread_args->mt_fsa, block);
+		}
+
+		block = __atomic_exchange_n(&mailbox[slot], NULL, __ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block,
+					(thread_args->id + NUM_OF_THREADS - 1) % NUM_OF_THREADS);
+			MTFSAFree(thread_args->mt_fsa, block);
+		}
+	}
+
+	for (slot = 0; slot < BLOCKS_PER_THREAD; ++slot)
+	{
+		block = __atomic_exchange_n(&next_mailbox[slot], NULL,
+															__ATOMIC_ACQ_REL);
+		if (NULL != block)
+		{
+			thread_args->is_failed |= !IsBlockOf(block, thread_args->id);
+			MTFSAFree(thread_args->mt_fsa, block);
+		}
+	}
+
+	return (NULL);
+}
+
+static int IsBlockOf(const size_t *block, size_t id)
+{
+	size_t i = 0;
+
+	for (; i < BLOCK_WORDS; ++i)
+	{
+		if (id != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
@@ -0,0 +1,279 @@
+/*******************************************************************************
+*
+* FILENAME : mt_hash_table_test.c
+*
+* DESCRIPTION : Thread-safe hash table unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <pthread.h> /* pthread_create, pthread_join */
+
+#include "mt_hash_table.h"
+#include "testing.h"
+
+
+#define NUM_OF_WRITERS (4)
+#define NUM_OF_READERS (4)
+#define KEYS_PER_WRITER (20000)
+#define STABLE_KEYS (1000)
+
+typedef struct
+{
+	int key;
+	int value;
+} keyval_entity_t;
+
+typedef struct
+{
+	mt_h_table_t *table;
+	keyval_entity_t *ents;
+	size_t size;
+	int is_failed;
+} thread_args_t;
+
+static int IsMatch(const void *data1, const void *data2);
+static size_t HashInt(const void *data);
+static int AdditionAction(void *data, void *param);
+static void *WriterThread(void *args);
+static void *ReaderThread(void *args);
+
+static void TestMTHTCreate(void);
+static void TestMTHTInsertFindRemove(void);
+static void TestMTHTForEach(void);
+static void TestMTHTConcurrent(void);
+
+static keyval_entity_t g_writer_ents[NUM_OF_WRITERS][KEYS_PER_WRITER];
+static keyval_entity_t g_stable_ents[STABLE_KEYS];
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Create", TestMTHTCreate},
+		{"InsertFindRemove", TestMTHTInsertFindRemove},
+		{"ForEach", TestMTHTForEach},
+		{"Concurrent", TestMTHTConcurrent},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestMTHTCreate(void)
+{
+	mt_h_table_t *ht = MTHashTableCreate(100, 16, HashInt, IsMatch);
+
+	TH_ASSERT(NULL != ht);
+	TH_ASSERT(1 == MTHashTableIsEmpty(ht));
+	TH_ASSERT(0 == MTHashTableSize(ht));
+
+	MTHashTableDestroy(ht);
+
+	ht = MTHashTableCreate(3, 64, HashInt, IsMatch);
+	TH_ASSERT(NULL != ht);
+
+	MTHashTableDestroy(ht);
+}
+
+static void TestMTHTInsertFindRemove(void)
+{
+	mt_h_table_t *ht = MTHashTableCreate(16, 4, HashInt, IsMatch);
+	keyval_entity_t ents[100] = {{0}};
+	keyval_entity_t replacement = {5, 0};
+	int i = 0;
+
+	for (; i < 100; ++i)
+	{
+		ents[i].key = i;
+		ents[i].value = i;
+		TH_ASSERT(0 == MTHashTableInsert(ht, &ents[i]));
+	}
+
+	TH_ASSERT(100 == MTHashTableSize(ht));
+	TH_ASSERT(&ents[42] == MTHashTableFind(ht, &ents[42]));
+
+	TH_ASSERT(0 == MTHashTableInsert(ht, &replacement));
+	TH_ASSERT(100 == MTHashTableSize(ht));
+	TH_ASSERT(&replacement == MTHashTableFind(ht, &ents[5]));
+
+	TH_ASSERT(&ents[42] == MTHashTableRemove(ht, &ents[42]));
+	TH_ASSERT(NULL == MTHashTableRemove(ht, &ents[42]));
+	TH_ASSERT(NULL == MTHashTableFind(ht, &ents[42]));
+	TH_ASSERT(99 == MTHashTableSize(ht));
+
+	TH_ASSERT(0 == MTHashTableInsert(ht, &ents[42]));
+	TH_ASSERT(&ents[42] == MTHashTableFind(ht, &ents[42]));
+	TH_ASSERT(100 == MTHashTableSize(ht));
+
+	MTHashTableDestroy(ht);
+}
+
+static void TestMTHTForEach(void)
+{
+	mt_h_table_t *ht = MTHashTableCreate(16, 4, HashInt, IsMatch);
+	keyval_entity_t ents[10] = {{0}};
+	int add = 5;
+	int i = 0;
+
+	for (; i < 10; ++i)
+	{
+		ents[i].key = i;
+		ents[i].value = i;
+		MTHashTableInsert(ht, &ents[i]);
+	}
+
+	TH_ASSERT(0 == MTHashTableForEach(ht, AdditionAction, &add));
+
+	for (i = 0; i < 10; ++i)
+	{
+		TH_ASSERT(i + 5 == ents[i].value);
+	}
+
+	MTHashTableDestroy(ht);
+}
+
+static void TestMTHTConcurrent(void)
+{
+	mt_h_table_t *ht = MTHashTableCreate(4096, 64, HashInt, IsMatch);
+	pthread_t writers[NUM_OF_WRITERS];
+	pthread_t readers[NUM_OF_READERS];
+	thread_args_t writer_args[NUM_OF_WRITERS];
+	thread_args_t reader_args[NUM_OF_READERS];
+	int i = 0;
+	int j = 0;
+
+	for (; i < STABLE_KEYS; ++i)
+	{
+		g_stable_ents[i].key = -1 - i;
+		g_stable_ents[i].value = i;
+		MTHashTableInsert(ht, &g_stable_ents[i]);
+	}
+
+	for (i = 0; i < NUM_OF_WRITERS; ++i)
+	{
+		for (j = 0; j < KEYS_PER_WRITER; ++j)
+		{
+			g_writer_ents[i][j].key = i * KEYS_PER_WRITER + j;
+			g_writer_ents[i][j].value = j;
+		}
+
+		writer_args[i].table = ht;
+		writer_args[i].ents = g_writer_ents[i];
+		writer_args[i].size = KEYS_PER_WRITER;
+		writer_args[i].is_failed = 0;
+	}
+
+	for (i = 0; i < NUM_OF_READERS; ++i)
+	{
+		reader_args[i].table = ht;
+		reader_args[i].ents = g_stable_ents;
+		reader_args[i].size = STABLE_KEYS;
+		reader_args[i].is_failed = 0;
+		pthread_create(&readers[i], NULL, ReaderThread, &reader_args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_WRITERS; ++i)
+	{
+		pthread_create(&writers[i], NULL, WriterThread, &writer_args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_WRITERS; ++i)
+	{
+		pthread_join(writers[i], NULL);
+		TH_ASSERT(0 == writer_args[i].is_failed);
+	}
+
+	for (i = 0; i < NUM_OF_READERS; ++i)
+	{
+		pthread_join(readers[i], NULL);
+		TH_ASSERT(0 == reader_args[i].is_failed);
+	}
+
+	TH_ASSERT(STABLE_KEYS + NUM_OF_WRITERS * KEYS_PER_WRITER / 2 ==
+													MTHashTableSize(ht));
+
+	for (i = 0; i < NUM_OF_WRITERS; ++i)
+	{
+		for (j = 0; j < KEYS_PER_WRITER; ++j)
+		{
+			TH_ASSERT((NULL != MTHashTableFind(ht, &g_writer_ents[i][j])) ==
+																	(j & 1));
+		}
+	}
+
+	MTHashTableDestroy(ht);
+}
+
+static void *WriterThread(void *args)
+{
+	thread_args_t *params = args;
+	size_t i = 0;
+
+	for (; i < params->size; ++i)
+	{
+		if (0 != MTHashTableInsert(params->table, &params->ents[i]) ||
+				&params->ents[i] != MTHashTableFind(params->table, &params->ents[i]))
+		{
+			params->is_failed = 1;
+		}
+	}
+
+	for (i = 0; i < params->size; i += 2)
+	{
+		if (&params->ents[i] != MTHashTableRemove(params->table, &params->ents[i]))
+		{
+			params->is_failed = 1;
+		}
+	}
+
+	return (NULL);
+}
+
+static void *ReaderThread(void *args)
+{
+	thread_args_t *params = args;
+	size_t round = 0;
+	size_t i = 0;
+
+	for (; round < 50; ++round)
+	{
+		for (i = 0; i < params->size; ++i)
+		{
+			if (&params->ents[i] != MTHashTableFind(params->table, &params->ents[i]))
+			{
+				params->is_failed = 1;
+			}
+		}
+	}
+
+	return (NULL);
+}
+
+static int IsMatch(const void *data1, const void *data2)
+{
+	const keyval_entity_t *ent1 = data1;
+	const keyval_entity_t *ent2 = data2;
+
+	return (ent1->key == ent2->key);
+}
+
+static size_t HashInt(const void *data)
+{
+	const keyval_entity_t *ent = data;
+
+	return ((size_t) ent->key * 2654435761UL);
+}
+
+static int AdditionAction(void *data, void *param)
+{
+	keyval_entity_t *ent = data;
+
+	ent->value += *(int *) param;
+
+	return (0);
+}
@@ -0,0 +1,302 @@
+/*******************************************************************************
+*
+* FILENAME : mt_vsa_test.c
+*
+* DESCRIPTION : Thread-safe variable-size allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <pthread.h> /* pthread_create, pthread_join */
+#include <stdlib.h> /* malloc, free */
+#include <string.h> /* memset */
+
+#include "mt_vsa.h"
+#include "vsa.h"
+#include "testing.h"
+
+
+#define POOL_SIZE (1 << 16)
+#define MT_POOL_SIZE (1 << 25)
+#define NUM_OF_THREADS (8)
+#define BLOCKS_PER_THREAD (2000)
+#define NUM_OF_ROUNDS (10)
+#define LARGE_BLOCK (5000)
+
+typedef struct
+{
+	mt_vsa_t *mt_vsa;
+	unsigned char **blocks;
+	size_t *sizes;
+	unsigned char **foreign_blocks;
+	size_t *foreign_sizes;
+	unsigned char fill;
+	unsigned char foreign_fill;
+	unsigned long seed;
+	int is_failed;
+} thread_args_t;
+
+static void *AllocThread(void *args);
+static void *FreeThread(void *args);
+static size_t RandomSize(unsigned long *seed);
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill);
+
+static void TestMTVSAAllocFree(void);
+static void TestMTVSAExhaust(void);
+static void TestMTVSALargeClasses(void);
+static void TestMTVSAConcurrent(void);
+
+static unsigned char *g_blocks[NUM_OF_THREADS][BLOCKS_PER_THREAD];
+static size_t g_sizes[NUM_OF_THREADS][BLOCKS_PER_THREAD];
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"AllocFree", TestMTVSAAllocFree},
+		{"Exhaust", TestMTVSAExhaust},
+		{"LargeClasses", TestMTVSALargeClasses},
+		{"Concurrent", TestMTVSAConcurrent},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestMTVSAAllocFree(void)
+{
+	void *pool = malloc(POOL_SIZE);
+	mt_vsa_t *mt_vsa = MTVSACreate(POOL_SIZE, pool);
+	size_t largest_chunk = MTVSALargestChunkAvailable(mt_vsa);
+	char *block1 = NULL;
+	char *block2 = NULL;
+	char *large = NULL;
+
+	TH_ASSERT(NULL != mt_vsa);
+
+	/* a freed block is the first to be handed out again */
+	block1 = MTVSAAlloc(mt_vsa, 100);
+	TH_ASSERT(NULL != block1);
+	memset(block1, 0, 128);
+	MTVSAFree(mt_vsa, block1);
+
+	block2 = MTVSAAlloc(mt_vsa, 128);
+	TH_ASSERT(block1 == block2);
+
+	/* large blocks bypass the cache */
+	large = MTVSAAlloc(mt_vsa, LARGE_BLOCK);
+	TH_ASSERT(NULL != large);
+	memset(large, 0, LARGE_BLOCK);
+
+	MTVSAFree(mt_vsa, large);
+	MTVSAFree(mt_vsa, block2);
+
+	/* the cached blocks are still taken from the pool until flushed */
+	TH_ASSERT(largest_chunk > MTVSALargestChunkAvailable(mt_vsa));
+	MTVSAFlushCache(mt_vsa);
+	TH_ASSERT(largest_chunk == MTVSALargestChunkAvailable(mt_vsa));
+
+	MTVSADestroy(mt_vsa);
+	free(pool);
+}
+
+static void TestMTVSAExhaust(void)
+{
+	static void *blocks[POOL_SIZE / 16];
+	void *pool = malloc(POOL_SIZE);
+	mt_vsa_t *mt_vsa = MTVSACreate(POOL_SIZE, pool);
+	size_t largest_chunk = MTVSALargestChunkAvailable(mt_vsa);
+	size_t num_blocks = 0;
+	size_t i = 0;
+
+	while (NULL != (blocks[num_blocks] = MTVSAAlloc(mt_vsa, 40)))
+	{
+		++num_blocks;
+	}
+
+	TH_ASSERT(POOL_SIZE / 128 < num_blocks);
+
+	for (i = 0; i < num_blocks; ++i)
+	{
+		MTVSAFree(mt_vsa, blocks[i]);
+	}
+
+	MTVSAFlushCache(mt_vsa);
+	TH_ASSERT(largest_chunk == MTVSALargestChunkAvailable(mt_vsa));
+
+	MTVSADestroy(mt_vsa);
+	free(pool);
+}
+
+static void TestMTVSALargeClasses(void)
+{
+	void *pool = malloc(VSASuggestSize(3000));
+	mt_vsa_t *mt_vsa = MTVSACreate(VSASuggestSize(3000), pool);
+	size_t largest_chunk = 0;
+	char *block = NULL;
+
+	/* no block of the 4096 class fits, the exact size still does */
+	block = MTVSAAlloc(mt_vsa, 2049);
+	TH_ASSERT(NULL != block);
+	memset(block, 0, 2049);
+	MTVSAFree(mt_vsa, block);
+
+	MTVSADestroy(mt_vsa);
+	free(pool);
+
+	/* a refill of a large class takes a single block, not a batch */
+	pool = malloc(POOL_SIZE);
+	mt_vsa = MTVSACreate(POOL_SIZE, pool);
+	largest_chunk = MTVSALargestChunkAvailable(mt_vsa);
+
+	block = MTVSAAlloc(mt_vsa, 3000);
+	TH_ASSERT(NULL != block);
+	TH_ASSERT(largest_chunk - 4096 - 2 * sizeof(size_t) ==
+										MTVSALargestChunkAvailable(mt_vsa));
+	MTVSAFree(mt_vsa, block);
+
+	MTVSADestroy(mt_vsa);
+	free(pool);
+}
+
+static void TestMTVSAConcurrent(void)
+{
+	void *pool = malloc(MT_POOL_SIZE);
+	mt_vsa_t *mt_vsa = MTVSACreate(MT_POOL_SIZE, pool);
+	size_t largest_chunk = MTVSALargestChunkAvailable(mt_vsa);
+	pthread_t threads[NUM_OF_THREADS];
+	thread_args_t args[NUM_OF_THREADS];
+	int i = 0;
+
+	for (; i < NUM_OF_THREADS; ++i)
+	{
+		args[i].mt_vsa = mt_vsa;
+		args[i].blocks = g_blocks[i];
+		args[i].sizes = g_sizes[i];
+		args[i].foreign_blocks = g_blocks[(i + 1) % NUM_OF_THREADS];
+		args[i].foreign_sizes = g_sizes[(i + 1) % NUM_OF_THREADS];
+		args[i].fill = (unsigned char) (i + 1);
+		args[i].foreign_fill = (unsigned char) ((i + 1) % NUM_OF_THREADS + 1);
+		args[i].seed = i + 1;
+		args[i].is_failed = 0;
+		pthread_create(&threads[i], NULL, AllocThread, &args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_THREADS; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		TH_ASSERT(0 == args[i].is_failed);
+	}
+
+	/* every thread frees the blocks left by its neighbour */
+	for (i = 0; i < NUM_OF_THREADS; ++i)
+	{
+		pthread_create(&threads[i], NULL, FreeThread, &args[i]);
+	}
+
+	for (i = 0; i < NUM_OF_THREADS; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		TH_ASSERT(0 == args[i].is_failed);
+	}
+
+	/* the caches of the threads were flushed when they exited */
+	TH_ASSERT(largest_chunk == MTVSALargestChunkAvailable(mt_vsa));
+
+	MTVSADestroy(mt_vsa);
+	free(pool);
+}
+
+static void *AllocThread(void *args)
+{
+	thread_args_t *thread_args = (thread_args_t *) args;
+	unsigned char fill = thread_args->fill;
+	size_t round = 0;
+	size_t i = 0;
+
+	for (; round < NUM_OF_ROUNDS; ++round)
+	{
+		for (i = 0; i < BLOCKS_PER_THREAD; ++i)
+		{
+			if (NULL != thread_args->blocks[i] &&
+										0 == RandomSize(&thread_args->seed) % 2)
+			{
+				thread_args->is_failed |= !IsBlockIntact(
+									thread_args->blocks[i],
+									thread_args->sizes[i], fill);
+				MTVSAFree(thread_args->mt_vsa, thread_args->blocks[i]);
+				thread_args->blocks[i] = NULL;
+			}
+			else if (NULL == thread_args->blocks[i])
+			{
+				thread_args->sizes[i] = RandomSize(&thread_args->seed);
+				thread_args->blocks[i] = MTVSAAlloc(thread_args->mt_vsa,
+														thread_args->sizes[i]);
+				if (NULL == thread_args->blocks[i])
+				{
+					thread_args->is_failed = 1;
+					return (NULL);
+				}
+
+				memset(thread_args->blocks[i], fill, thread_args->sizes[i]);
+			}
+		}
+	}
+
+	return (NULL);
+}
+
+static void *FreeThread(void *args)
+{
+	thread_args_t *thread_args = (thread_args_t *) args;
+	size_t i = 0;
+
+	for (; i < BLOCKS_PER_THREAD; ++i)
+	{
+		if (NULL != thread_args->foreign_blocks[i])
+		{
+			thread_args->is_failed |= !IsBlockIntact(
+									thread_args->foreign_blocks[i],
+									thread_args->foreign_sizes[i],
+									thread_args->foreign_fill);
+			MTVSAFree(thread_args->mt_vsa, thread_args->foreign_blocks[i]);
+			thread_args->foreign_blocks[i] = NULL;
+		}
+	}
+
+	return (NULL);
+}
+
+/* mostly small blocks from the caches, every sixteenth one is large */
+static size_t RandomSize(unsigned long *seed)
+{
+	*seed = (*seed * 1103515245 + 12345) & 0x7FFFFFFF;
+
+	if (0 == (*seed >> 8) % 16)
+	{
+		return (LARGE_BLOCK);
+	}
+
+	return (1 + (*seed >> 8) % 600);
+}
+
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill)
+{
+	size_t i = 0;
+
+	for (; i < size; ++i)
+	{
+		if (fill != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
@@ -0,0 +1,208 @@
+/*******************************************************************************
+*
+* FILENAME : tlsf_test.c
+*
+* DESCRIPTION : Two-level segregated fit allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <stdlib.h> /* malloc, free, rand, srand */
+#include <string.h> /* memset */
+
+#include "tlsf.h"
+#include "testing.h"
+
+
+#define NUM_BLOCKS (10000)
+#define MAX_BLOCK (1000)
+#define WORD_SIZE (sizeof(size_t))
+
+static void TestTLSFInit(void);
+static void TestTLSFAlloc(void);
+static void TestTLSFFree(void);
+static void TestTLSFExhaust(void);
+static void TestTLSFRandom(void);
+
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Init", TestTLSFInit},
+		{"Alloc", TestTLSFAlloc},
+		{"Free", TestTLSFFree},
+		{"Exhaust", TestTLSFExhaust},
+		{"Random", TestTLSFRandom},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestTLSFInit(void)
+{
+	void *pool = malloc(TLSFSuggestSize(4096) + 3);
+	tlsf_t *tlsf = TLSFInit(TLSFSuggestSize(4096) + 3, pool);
+
+	TH_ASSERT(4096 == TLSFLargestChunkAvailable(tlsf));
+
+	/* no room for a single block */
+	tlsf = TLSFInit(TLSFSuggestSize(0), pool);
+
+	TH_ASSERT(0 == TLSFLargestChunkAvailable(tlsf));
+	TH_ASSERT(NULL == TLSFAlloc(tlsf, 1));
+
+	/* no room for the lists, and too many blocks for them */
+	TH_ASSERT(NULL == TLSFInit(TLSFSuggestSize(0) - WORD_SIZE, pool));
+	TH_ASSERT(NULL == TLSFInit(~(size_t) 0, pool));
+
+	free(pool);
+}
+
+static void TestTLSFAlloc(void)
+{
+	void *pool = malloc(TLSFSuggestSize(4096));
+	tlsf_t *tlsf = TLSFInit(TLSFSuggestSize(4096), pool);
+	char *block1 = NULL;
+	char *block2 = NULL;
+
+	block1 = TLSFAlloc(tlsf, 1);
+	block2 = TLSFAlloc(tlsf, 100);
+
+	TH_ASSERT(NULL != block1 && NULL != block2);
+	TH_ASSERT(0 == (size_t) block1 % WORD_SIZE);
+	TH_ASSERT(0 == (size_t) block2 % WORD_SIZE);
+
+	/* the smallest block still holds the links and the footer */
+	TH_ASSERT(block1 + 3 * WORD_SIZE + 2 * WORD_SIZE == block2);
+	TH_ASSERT(4096 - (3 * WORD_SIZE + 104 + 4 * WORD_SIZE) ==
+											TLSFLargestChunkAvailable(tlsf));
+
+	TH_ASSERT(NULL == TLSFAlloc(tlsf, 4096));
+	TH_ASSERT(NULL == TLSFAlloc(tlsf, ~(size_t) 0));
+
+	free(pool);
+}
+
+static void TestTLSFFree(void)
+{
+	void *pool = malloc(TLSFSuggestSize(4096));
+	tlsf_t *tlsf = TLSFInit(TLSFSuggestSize(4096), pool);
+	char *block1 = TLSFAlloc(tlsf, 200);
+	char *block2 = TLSFAlloc(tlsf, 200);
+	char *block3 = TLSFAlloc(tlsf, 200);
+	char *guard = TLSFAlloc(tlsf, 8);
+
+	/* a freed block is found again on its list */
+	TLSFFree(block2);
+	TH_ASSERT(block2 == TLSFAlloc(tlsf, 200));
+
+	/* and merged with both of its free neighbours, into a list of its own */
+	TLSFFree(block1);
+	TLSFFree(block3);
+	TLSFFree(block2);
+	TH_ASSERT(block1 == TLSFAlloc(tlsf, 600));
+
+	TLSFFree(block1);
+	TLSFFree(guard);
+
+	TH_ASSERT(4096 == TLSFLargestChunkAvailable(tlsf));
+
+	free(pool);
+}
+
+static void TestTLSFExhaust(void)
+{
+	void *pool = malloc(TLSFSuggestSize(1000));
+	tlsf_t *tlsf = TLSFInit(TLSFSuggestSize(1000), pool);
+	char *block = NULL;
+
+	/* the only block is below the rounded up request, its list is not read */
+	TH_ASSERT(NULL == TLSFAlloc(tlsf, 1000));
+
+	/* a request of the list below takes all of it */
+	block = TLSFAlloc(tlsf, 992);
+	TH_ASSERT(NULL != block);
+	TH_ASSERT(0 == TLSFLargestChunkAvailable(tlsf));
+	TH_ASSERT(NULL == TLSFAlloc(tlsf, 1));
+
+	TLSFFree(block);
+	TH_ASSERT(1000 == TLSFLargestChunkAvailable(tlsf));
+
+	free(pool);
+}
+
+static void TestTLSFRandom(void)
+{
+	static unsigned char *blocks[NUM_BLOCKS];
+	static size_t sizes[NUM_BLOCKS];
+	size_t pool_size = TLSFSuggestSize(NUM_BLOCKS * MAX_BLOCK);
+	void *pool = malloc(pool_size);
+	tlsf_t *tlsf = TLSFInit(pool_size, pool);
+	size_t largest_chunk = TLSFLargestChunkAvailable(tlsf);
+	int is_intact = 1;
+	size_t round = 0;
+	size_t i = 0;
+
+	srand(17);
+
+	/* the pool is never more than half full, so no request may fail */
+	for (; round < 20; ++round)
+	{
+		for (i = 0; i < NUM_BLOCKS; ++i)
+		{
+			if (NULL != blocks[i] && 0 == rand() % 2)
+			{
+				is_intact &= IsBlockIntact(blocks[i], sizes[i],
+														(unsigned char) i);
+				TLSFFree(blocks[i]);
+				blocks[i] = NULL;
+			}
+			else if (NULL == blocks[i])
+			{
+				sizes[i] = 1 + rand() % (MAX_BLOCK / 2);
+				blocks[i] = TLSFAlloc(tlsf, sizes[i]);
+				is_intact &= (NULL != blocks[i]);
+				memset(blocks[i], (unsigned char) i, sizes[i]);
+			}
+		}
+	}
+
+	for (i = 0; i < NUM_BLOCKS; ++i)
+	{
+		if (NULL != blocks[i])
+		{
+			is_intact &= IsBlockIntact(blocks[i], sizes[i],
+														(unsigned char) i);
+			TLSFFree(blocks[i]);
+		}
+	}
+
+	TH_ASSERT(1 == is_intact);
+	TH_ASSERT(largest_chunk == TLSFLargestChunkAvailable(tlsf));
+
+	free(pool);
+}
+
+static int IsBlockIntact(const unsigned char *block, size_t size,
+														unsigned char fill)
+{
+	size_t i = 0;
+
+	for (; i < size; ++i)
+	{
+		if (fill != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
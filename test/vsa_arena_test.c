@@ -0,0 +1,237 @@
+/*******************************************************************************
+*
+* FILENAME : vsa_arena_test.c
+*
+* DESCRIPTION : Growable variable-size allocator unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 17.10.2026
+*
+*******************************************************************************/
+
+#include <string.h> /* memset */
+
+#include "vsa_arena.h"
+#include "testing.h"
+
+
+#define ARENA_SIZE (1 << 16)
+#define NUM_BLOCKS (2000)
+#define BLOCK_SIZE(I) ((I) % 200 + 1)
+#define LARGE_BLOCK (1 << 20)
+
+static void TestVSAArenaCreate(void);
+static void TestVSAArenaGrow(void);
+static void TestVSAArenaLarge(void);
+static void TestVSAArenaBursts(void);
+static void TestVSAArenaFullArenas(void);
+static void TestVSAArenaRoomKept(void);
+
+static size_t AllocBlocks(vsa_arena_t *vsa_arena, char **blocks);
+static int FreeBlocks(vsa_arena_t *vsa_arena, char **blocks);
+
+int main()
+{
+	TH_TEST_T tests[] = {
+		{"Create", TestVSAArenaCreate},
+		{"Grow", TestVSAArenaGrow},
+		{"Large", TestVSAArenaLarge},
+		{"Bursts", TestVSAArenaBursts},
+		{"FullArenas", TestVSAArenaFullArenas},
+		{"RoomKept", TestVSAArenaRoomKept},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(tests);
+
+	return (0);
+}
+
+static void TestVSAArenaCreate(void)
+{
+	vsa_arena_t *vsa_arena = VSAArenaCreate(1);
+	char *block = NULL;
+
+	TH_ASSERT(NULL != vsa_arena);
+	TH_ASSERT(0 == VSAArenaCount(vsa_arena));
+
+	/* an arena is mapped on the first allocation */
+	block = VSAArenaAlloc(vsa_arena, 100);
+	TH_ASSERT(NULL != block);
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+	memset(block, 0, 100);
+
+	/* the only empty arena is kept */
+	VSAArenaFree(vsa_arena, block);
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	TH_ASSERT(block == VSAArenaAlloc(vsa_arena, 100));
+	TH_ASSERT(NULL == VSAArenaAlloc(vsa_arena, ~(size_t) 0));
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static void TestVSAArenaGrow(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	vsa_arena_t *vsa_arena = VSAArenaCreate(ARENA_SIZE);
+
+	/* the blocks take a few arenas, all but one are unmapped once freed */
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(vsa_arena, blocks));
+	TH_ASSERT(1 < VSAArenaCount(vsa_arena));
+
+	TH_ASSERT(0 == FreeBlocks(vsa_arena, blocks));
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static void TestVSAArenaLarge(void)
+{
+	vsa_arena_t *vsa_arena = VSAArenaCreate(ARENA_SIZE);
+	char *small = VSAArenaAlloc(vsa_arena, 10);
+	char *large = VSAArenaAlloc(vsa_arena, LARGE_BLOCK);
+
+	TH_ASSERT(NULL != small && NULL != large);
+	TH_ASSERT(2 == VSAArenaCount(vsa_arena));
+	memset(large, 0, LARGE_BLOCK);
+
+	/* a large block has a mapping of its own that is not kept */
+	VSAArenaFree(vsa_arena, large);
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	VSAArenaFree(vsa_arena, small);
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static void TestVSAArenaBursts(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	vsa_arena_t *vsa_arena = VSAArenaCreate(ARENA_SIZE);
+	size_t max_arenas = 0;
+	int is_intact = 1;
+	int round = 0;
+
+	TH_ASSERT(NUM_BLOCKS == AllocBlocks(vsa_arena, blocks));
+	max_arenas = VSAArenaCount(vsa_arena);
+	is_intact &= (0 == FreeBlocks(vsa_arena, blocks));
+
+	/* the same bursts never take more arenas than the first one */
+	for (; round < 10; ++round)
+	{
+		is_intact &= (NUM_BLOCKS == AllocBlocks(vsa_arena, blocks));
+		is_intact &= (max_arenas == VSAArenaCount(vsa_arena));
+		is_intact &= (0 == FreeBlocks(vsa_arena, blocks));
+		is_intact &= (1 == VSAArenaCount(vsa_arena));
+	}
+
+	TH_ASSERT(1 == is_intact);
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static void TestVSAArenaFullArenas(void)
+{
+	static char *blocks[NUM_BLOCKS];
+	vsa_arena_t *vsa_arena = VSAArenaCreate(ARENA_SIZE);
+	char *large = VSAArenaAlloc(vsa_arena, LARGE_BLOCK);
+	size_t i = 0;
+
+	/* the first arena is set aside as full once a request misses it */
+	for (; 3 > VSAArenaCount(vsa_arena); ++i)
+	{
+		blocks[i] = VSAArenaAlloc(vsa_arena, 100);
+		TH_ASSERT(NULL != blocks[i]);
+	}
+
+	TH_ASSERT(3 == VSAArenaCount(vsa_arena));
+
+	/* a hole freed in it is filled before the newer arena is used */
+	VSAArenaFree(vsa_arena, blocks[1]);
+	TH_ASSERT(blocks[1] == VSAArenaAlloc(vsa_arena, 100));
+	TH_ASSERT(3 == VSAArenaCount(vsa_arena));
+
+	VSAArenaFree(vsa_arena, large);
+	TH_ASSERT(2 == VSAArenaCount(vsa_arena));
+
+	while (0 < i)
+	{
+		--i;
+		VSAArenaFree(vsa_arena, blocks[i]);
+	}
+
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static void TestVSAArenaRoomKept(void)
+{
+	vsa_arena_t *vsa_arena = VSAArenaCreate(ARENA_SIZE);
+	char *blocks[3] = {NULL};
+	size_t i = 0;
+
+	/* a miss of a big request leaves the room of the first arena listed */
+	blocks[0] = VSAArenaAlloc(vsa_arena, ARENA_SIZE / 2);
+	blocks[1] = VSAArenaAlloc(vsa_arena, ARENA_SIZE / 4 * 3);
+	TH_ASSERT(2 == VSAArenaCount(vsa_arena));
+
+	blocks[2] = VSAArenaAlloc(vsa_arena, ARENA_SIZE / 3);
+	TH_ASSERT(2 == VSAArenaCount(vsa_arena));
+
+	for (; i < 3; ++i)
+	{
+		TH_ASSERT(NULL != blocks[i]);
+		VSAArenaFree(vsa_arena, blocks[i]);
+	}
+
+	TH_ASSERT(1 == VSAArenaCount(vsa_arena));
+
+	VSAArenaDestroy(vsa_arena);
+}
+
+static size_t AllocBlocks(vsa_arena_t *vsa_arena, char **blocks)
+{
+	size_t i = 0;
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		blocks[i] = VSAArenaAlloc(vsa_arena, BLOCK_SIZE(i));
+		if (NULL == blocks[i])
+		{
+			break;
+		}
+
+		memset(blocks[i], (char) i, BLOCK_SIZE(i));
+	}
+
+	return (i);
+}
+
+/* returns the amount of blocks found corrupted */
+static int FreeBlocks(vsa_arena_t *vsa_arena, char **blocks)
+{
+	int num_corrupted = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		for (j = 0; j < BLOCK_SIZE(i); ++j)
+		{
+			if ((char) i != blocks[i][j])
+			{
+				++num_corrupted;
+				break;
+			}
+		}
+
+		VSAArenaFree(vsa_arena, blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	return (num_corrupted);
+}
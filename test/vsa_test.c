@@ -11,6 +11,7 @@
 *******************************************************************************/
 
 #include <stdlib.h> /* malloc, free */
+#include <string.h> /* memset */
 
 #include "vsa.h"
 #include "testing.h"
@@ -19,6 +20,9 @@
 #define FREE_AND_SET_TO_NULL(ptr) \
 {free(ptr); (ptr) = NULL;}
 
+#define NUM_BLOCKS (10000)
+#define BLOCK_SIZE(I) (((I) * 7 % 32 + 1) * sizeof(size_t))
+
 
 static void TestVSAInit(void);
 static void TestVSAAlloc(void);
@@ -26,6 +30,22 @@ static void TestVSAAllocEdge1(void);
 static void TestVSAAllocEdge2(void);
 static void TestVSAFree(void);
 static void TestVSALargestChunkAvailable(void);
+static void TestVSASizeClasses(void);
+static void TestVSAManyBlocks(void);
+static void TestVSATagged(void);
+static void TestVSATaggedManyBlocks(void);
+static void TestVSAAllocAligned(void);
+static void TestVSARealloc(void);
+static void TestVSAStats(void);
+
+static void CheckManyBlocks(vsa_t *(*init)(size_t, void *));
+static void CheckAllocAligned(vsa_t *(*init)(size_t, void *));
+static void CheckRealloc(vsa_t *(*init)(size_t, void *));
+static void CheckStats(vsa_t *(*init)(size_t, void *));
+static int CountBlocks(const void *block, size_t size, int is_free,
+																void *param);
+static int IsBlockIntact(const char *block, size_t i);
+static int IsSequence(const char *block, size_t size);
 
 int main()
 {
@@ -36,6 +56,13 @@ int main()
 		{"VSAFree", TestVSAFree},
 		{"VSAAlloc edge1", TestVSAAllocEdge1},
 		{"VSAAlloc edge2", TestVSAAllocEdge2},
+		{"VSA size classes", TestVSASizeClasses},
+		{"VSA many blocks", TestVSAManyBlocks},
+		{"VSA tagged", TestVSATagged},
+		{"VSA tagged many blocks", TestVSATaggedManyBlocks},
+		{"VSAAllocAligned", TestVSAAllocAligned},
+		{"VSARealloc", TestVSARealloc},
+		{"VSA stats", TestVSAStats},
 		TH_TESTS_ARRAY_END
 	};
 
@@ -46,36 +73,40 @@ int main()
 
 static void TestVSALargestChunkAvailable(void)
 {
-	int *pool = (int *) malloc(46);
+	int *pool = (int *) malloc(VSASuggestSize(14));
 
-	vsa_t *vsa = VSAInit(46, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(14), pool);
 
-	TH_ASSERT(14 == VSALargestChunkAvailable(vsa));
+	TH_ASSERT(16 == VSALargestChunkAvailable(vsa));
 
 	free(pool);
 }
 
 static void TestVSAInit(void)
 {
-	int *pool = (int *) malloc(33);
+	int *pool = (int *) malloc(VSASuggestSize(0) + 1);
 
-	vsa_t *vsa = VSAInit(33, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(0) + 1, pool);
 
 	TH_ASSERT(0 == VSALargestChunkAvailable(vsa));
 
+	/* a pool without room for the lists is refused, not overrun */
+	TH_ASSERT(NULL == VSAInit(100, pool));
+	TH_ASSERT(NULL == VSAInitTagged(VSASuggestSize(0) - 8, pool));
+
 	free(pool);
 }
 
 static void TestVSAFree(void)
 {
-	int *pool = (int *) malloc(100);
+	int *pool = (int *) malloc(VSASuggestSize(72));
 	int *block1 = NULL;
 	
-	vsa_t *vsa = VSAInit(100, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(72), pool);
 	
 	block1 = VSAAlloc(vsa, 8);
 
-	TH_ASSERT(44 == VSALargestChunkAvailable(vsa));
+	TH_ASSERT(48 == VSALargestChunkAvailable(vsa));
 
 	free(pool);
 
@@ -84,18 +115,18 @@ static void TestVSAFree(void)
 
 static void TestVSAAlloc(void)
 {
-	int *pool = (int *) malloc(100);
+	int *pool = (int *) malloc(VSASuggestSize(72));
 	int *block1 = NULL;
 	
-	vsa_t *vsa = VSAInit(100, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(72), pool);
 	
 	block1 = VSAAlloc(vsa, 8);
 
-	TH_ASSERT(44 == VSALargestChunkAvailable(vsa));
+	TH_ASSERT(48 == VSALargestChunkAvailable(vsa));
 
 	VSAFree(block1);
 
-	TH_ASSERT(68 == VSALargestChunkAvailable(vsa));
+	TH_ASSERT(72 == VSALargestChunkAvailable(vsa));
 
 	free(pool);
 
@@ -104,12 +135,12 @@ static void TestVSAAlloc(void)
 
 static void TestVSAAllocEdge1(void)
 {
-	int *pool = (int *) malloc(129);
+	int *pool = (int *) malloc(VSASuggestSize(96) + 1);
 	int *block1 = NULL;
 	size_t *block2 = NULL;
 	size_t *block3 = NULL;
 
-	vsa_t *vsa = VSAInit(129, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(96) + 1, pool);
 
 	block1 = VSAAlloc(vsa, 8);
 	block2 = VSAAlloc(vsa, 24);
@@ -139,12 +170,12 @@ static void TestVSAAllocEdge1(void)
 
 static void TestVSAAllocEdge2(void)
 {
-	int *pool = (int *) malloc(129);
+	int *pool = (int *) malloc(VSASuggestSize(96) + 1);
 	int *block1 = NULL;
 	size_t *block2 = NULL;
 	size_t *block3 = NULL;
 
-	vsa_t *vsa = VSAInit(129, pool);
+	vsa_t *vsa = VSAInit(VSASuggestSize(96) + 1, pool);
 
 	block1 = VSAAlloc(vsa, 8);
 	block2 = VSAAlloc(vsa, 16);
@@ -163,3 +194,349 @@ static void TestVSAAllocEdge2(void)
 	(void) block2;
 	(void) block3;
 }
+
+static void TestVSASizeClasses(void)
+{
+	void *pool = malloc(VSASuggestSize(4096));
+	char *block1 = NULL;
+	char *block2 = NULL;
+	char *guard1 = NULL;
+	char *guard2 = NULL;
+
+	vsa_t *vsa = VSAInit(VSASuggestSize(4096), pool);
+
+	block1 = VSAAlloc(vsa, 100);
+	guard1 = VSAAlloc(vsa, 8);
+	block2 = VSAAlloc(vsa, 300);
+	guard2 = VSAAlloc(vsa, 8);
+
+	/* a freed block is found again on the list of its class */
+	VSAFree(block1);
+	TH_ASSERT(block1 == VSAAlloc(vsa, 100));
+
+	/* the smallest class that fits is preferred to the rest of the pool */
+	VSAFree(block2);
+	TH_ASSERT(block2 == VSAAlloc(vsa, 200));
+	TH_ASSERT(block2 + 200 + 2 * sizeof(size_t) == VSAAlloc(vsa, 80));
+
+	TH_ASSERT(NULL == VSAAlloc(vsa, 4096));
+
+	free(pool);
+
+	(void) guard1;
+	(void) guard2;
+}
+
+static void TestVSAManyBlocks(void)
+{
+	CheckManyBlocks(VSAInit);
+}
+
+static void TestVSATagged(void)
+{
+	void *pool = malloc(VSASuggestSize(4096));
+	char *block1 = NULL;
+	char *block2 = NULL;
+	char *block3 = NULL;
+	char *guard = NULL;
+	size_t whole_size = 3 * 104 + 2 * 2 * sizeof(size_t);
+
+	vsa_t *vsa = VSAInitTagged(VSASuggestSize(4096), pool);
+
+	TH_ASSERT(4096 == VSALargestChunkAvailable(vsa));
+
+	block1 = VSAAlloc(vsa, 100);
+	block2 = VSAAlloc(vsa, 100);
+	block3 = VSAAlloc(vsa, 100);
+	guard = VSAAlloc(vsa, 1);
+
+	TH_ASSERT(104 == VSABlockSize(block1));
+	TH_ASSERT(3 * sizeof(size_t) == VSABlockSize(guard));
+
+	/* a free block is merged with both of its free neighbours at once */
+	VSAFree(block1);
+	VSAFree(block3);
+	VSAFree(block2);
+
+	TH_ASSERT(block1 == VSAAlloc(vsa, whole_size));
+	TH_ASSERT(NULL == VSAAlloc(vsa, 4096));
+
+	VSAFree(block1);
+	VSAFree(guard);
+
+	TH_ASSERT(4096 == VSALargestChunkAvailable(vsa));
+
+	/* too small for a tagged block */
+	vsa = VSAInitTagged(VSASuggestSize(2 * sizeof(size_t)), pool);
+	TH_ASSERT(0 == VSALargestChunkAvailable(vsa));
+	TH_ASSERT(NULL == VSAAlloc(vsa, 1));
+
+	free(pool);
+}
+
+static void TestVSATaggedManyBlocks(void)
+{
+	CheckManyBlocks(VSAInitTagged);
+}
+
+static void TestVSAAllocAligned(void)
+{
+	CheckAllocAligned(VSAInit);
+	CheckAllocAligned(VSAInitTagged);
+}
+
+static void TestVSARealloc(void)
+{
+	CheckRealloc(VSAInit);
+	CheckRealloc(VSAInitTagged);
+}
+
+static void TestVSAStats(void)
+{
+	CheckStats(VSAInit);
+	CheckStats(VSAInitTagged);
+}
+
+static void CheckManyBlocks(vsa_t *(*init)(size_t, void *))
+{
+	static char *blocks[NUM_BLOCKS];
+	size_t pool_size = VSASuggestSize(NUM_BLOCKS * (BLOCK_SIZE(9) +
+														2 * sizeof(size_t)));
+	void *pool = malloc(pool_size);
+	vsa_t *vsa = init(pool_size, pool);
+	size_t largest_chunk = VSALargestChunkAvailable(vsa);
+	int is_intact = 1;
+	size_t i = 0;
+
+	for (; i < NUM_BLOCKS; ++i)
+	{
+		blocks[i] = VSAAlloc(vsa, BLOCK_SIZE(i));
+		TH_ASSERT(NULL != blocks[i]);
+		memset(blocks[i], (int) i, BLOCK_SIZE(i));
+	}
+
+	for (i = 0; i < NUM_BLOCKS; i += 2)
+	{
+		VSAFree(blocks[i]);
+	}
+
+	/* the holes are reused in reverse order of the sizes */
+	for (i = NUM_BLOCKS; 0 < i; i -= 2)
+	{
+		blocks[i - 2] = VSAAlloc(vsa, BLOCK_SIZE(i - 2));
+		is_intact &= (NULL != blocks[i - 2]);
+		memset(blocks[i - 2], (int) (i - 2), BLOCK_SIZE(i - 2));
+	}
+
+	for (i = 0; i < NUM_BLOCKS; ++i)
+	{
+		is_intact &= IsBlockIntact(blocks[i], i);
+	}
+
+	TH_ASSERT(1 == is_intact);
+
+	/* every third block first, so the merges go both ways */
+	for (i = 0; i < NUM_BLOCKS; i += 3)
+	{
+		VSAFree(blocks[i]);
+	}
+
+	for (i = 0; i < NUM_BLOCKS; ++i)
+	{
+		if (0 != i % 3)
+		{
+			VSAFree(blocks[i]);
+		}
+	}
+
+	TH_ASSERT(largest_chunk == VSALargestChunkAvailable(vsa));
+
+	free(pool);
+}
+
+static int IsBlockIntact(const char *block, size_t i)
+{
+	size_t j = 0;
+
+	for (; j < BLOCK_SIZE(i); ++j)
+	{
+		if ((char) i != block[j])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
+
+static void CheckAllocAligned(vsa_t *(*init)(size_t, void *))
+{
+	char *blocks[16] = {NULL};
+	void *pool = malloc(VSASuggestSize(16384));
+	vsa_t *vsa = init(VSASuggestSize(16384), pool);
+	size_t largest_chunk = VSALargestChunkAvailable(vsa);
+	char *small = VSAAlloc(vsa, 8);
+	size_t align = 8;
+	size_t num_blocks = 0;
+	int is_aligned = 1;
+
+	for (; align <= 4096; align *= 2, ++num_blocks)
+	{
+		blocks[num_blocks] = VSAAllocAligned(vsa, 100, align);
+		is_aligned &= (NULL != blocks[num_blocks] &&
+								0 == (size_t) blocks[num_blocks] % align);
+		memset(blocks[num_blocks], 0, 100);
+	}
+
+	TH_ASSERT(1 == is_aligned);
+	TH_ASSERT(NULL == VSAAllocAligned(vsa, 16384, 64));
+
+	while (0 < num_blocks)
+	{
+		--num_blocks;
+		VSAFree(blocks[num_blocks]);
+	}
+
+	VSAFree(small);
+
+	TH_ASSERT(largest_chunk == VSALargestChunkAvailable(vsa));
+
+	free(pool);
+}
+
+static void CheckRealloc(vsa_t *(*init)(size_t, void *))
+{
+	void *pool = malloc(VSASuggestSize(4096));
+	vsa_t *vsa = init(VSASuggestSize(4096), pool);
+	char *block = VSAAlloc(vsa, 100);
+	char *next = VSAAlloc(vsa, 100);
+	char *moved = NULL;
+	size_t i = 0;
+
+	for (; i < 100; ++i)
+	{
+		block[i] = (char) i;
+	}
+
+	/* grown in place over the freed neighbour */
+	VSAFree(next);
+	TH_ASSERT(block == VSARealloc(vsa, block, 1000));
+	TH_ASSERT(1000 == VSABlockSize(block));
+	TH_ASSERT(1 == IsSequence(block, 100));
+
+	/* shrunk in place, the tail goes back to the pool */
+	TH_ASSERT(block == VSARealloc(vsa, block, 24));
+	TH_ASSERT(24 == VSABlockSize(block));
+	next = VSAAlloc(vsa, 200);
+	TH_ASSERT(block + 24 + 2 * sizeof(size_t) == next);
+
+	/* moved once the following block is taken */
+	moved = VSARealloc(vsa, block, 100);
+	TH_ASSERT(NULL != moved && block != moved);
+	TH_ASSERT(1 == IsSequence(moved, 24));
+
+	TH_ASSERT(NULL == VSARealloc(vsa, moved, 4096));
+	TH_ASSERT(1 == IsSequence(moved, 24));
+
+	VSAFree(moved);
+	VSAFree(next);
+
+	TH_ASSERT(4096 == VSALargestChunkAvailable(vsa));
+
+	block = VSARealloc(vsa, NULL, 10);
+	TH_ASSERT(NULL != block);
+	VSAFree(block);
+
+	free(pool);
+}
+
+static int IsSequence(const char *block, size_t size)
+{
+	size_t i = 0;
+
+	for (; i < size; ++i)
+	{
+		if ((char) i != block[i])
+		{
+			return (0);
+		}
+	}
+
+	return (1);
+}
+
+static void CheckStats(vsa_t *(*init)(size_t, void *))
+{
+	void *pool = malloc(VSASuggestSize(4096));
+	vsa_t *vsa = init(VSASuggestSize(4096), pool);
+	vsa_stats_t stats;
+	size_t histogram[VSA_NUM_CLASSES];
+	size_t counts[2] = {0};
+	char *blocks[8] = {NULL};
+	char *block1 = NULL;
+	char *block2 = NULL;
+	char *block3 = NULL;
+	size_t i = 0;
+
+	VSAGetStats(vsa, &stats);
+	TH_ASSERT(0 == stats.live_blocks && 1 == stats.free_blocks);
+	TH_ASSERT(4096 == stats.free_bytes && 0 == stats.fragmentation);
+	VSAGetFreeHistogram(vsa, histogram);
+	TH_ASSERT(1 == histogram[12]);
+
+	block1 = VSAAlloc(vsa, 100);
+	block2 = VSAAlloc(vsa, 200);
+	block3 = VSAAlloc(vsa, 100);
+	VSAFree(block2);
+
+	VSAGetStats(vsa, &stats);
+	TH_ASSERT(2 == stats.live_blocks && 2 == stats.free_blocks);
+	TH_ASSERT(208 == stats.bytes_in_use && 408 == stats.high_water_mark);
+	TH_ASSERT(3 == stats.num_allocs && 1 == stats.num_frees);
+	VSAGetFreeHistogram(vsa, histogram);
+	TH_ASSERT(1 == histogram[7] && 1 == histogram[11]);
+	TH_ASSERT(4096 - 208 - 3 * 2 * sizeof(size_t) == stats.free_bytes);
+	TH_ASSERT(0 < stats.fragmentation && 0.1 > stats.fragmentation);
+
+	/* the walk sees the same blocks, and changes none of them */
+	TH_ASSERT(0 == VSAWalk(vsa, CountBlocks, counts));
+	TH_ASSERT(2 == counts[0] && 2 == counts[1]);
+
+	VSAFree(block1);
+	VSAFree(block3);
+	VSALargestChunkAvailable(vsa);
+
+	VSAGetStats(vsa, &stats);
+	TH_ASSERT(0 == stats.live_blocks && 0 == stats.bytes_in_use);
+	TH_ASSERT(1 == stats.free_blocks && 4096 == stats.free_bytes);
+	TH_ASSERT(408 == stats.high_water_mark && 3 == stats.num_frees);
+
+	/* every other block freed: many blocks of one class, none of them big */
+	for (i = 0; i < 8; ++i)
+	{
+		blocks[i] = VSAAlloc(vsa, 4096 / 8 - 2 * sizeof(size_t));
+	}
+
+	for (i = 0; i < 8; i += 2)
+	{
+		VSAFree(blocks[i]);
+	}
+
+	VSAGetStats(vsa, &stats);
+	TH_ASSERT(4 == stats.free_blocks);
+	TH_ASSERT(0.75 == stats.fragmentation);
+
+	free(pool);
+}
+
+/* counts the allocated blocks in param[0] and the free ones in param[1] */
+static int CountBlocks(const void *block, size_t size, int is_free,
+																void *param)
+{
+	(void) block;
+	(void) size;
+
+	++((size_t *) param)[is_free];
+
+	return (0);
+}